@@ -11,7 +11,8 @@
 typedef enum {
     APP_STATE_MIDI_DISPLAY,
     APP_STATE_SCROLL_HISTORY,
-	APP_STATE_CONFIG
+	APP_STATE_CONFIG,
+	APP_STATE_SPLASH		/* splash screen up after power-on ... packets go to history only */
 } AppState;
 
 extern AppState app_state;
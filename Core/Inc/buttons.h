@@ -26,6 +26,8 @@ typedef enum {
 void button_init(void);
 void button_exti_trigger(ButtonID id, bool is_pressed);  // Call from EXTI ISR
 void button_poll(void);                 // Call from scheduled task
+bool button_is_held(ButtonID id);       // Button currently pressed
+bool button_claim(ButtonID id);         // Use press as modifier, suppress short/long press on release
 
 ButtonEvent button_get_event(ButtonID id);  // Poll for events
 
@@ -0,0 +1,21 @@
+/*
+ * console.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_CONSOLE_H_
+#define INC_CONSOLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* modelled I2C transfer time ... 9 bit times per byte (8 data + ack) */
+#define CONSOLE_I2C_STANDARD_HZ	(100000u)
+#define CONSOLE_I2C_FAST_HZ		(400000u)
+
+void console_init(void);
+void console_poll(void);
+
+#endif /* INC_CONSOLE_H_ */
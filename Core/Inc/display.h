@@ -15,6 +15,8 @@
 
 #define DISPLAY_DEFAULT_FONT Font_6x8
 #define STATUS_LINE_STATUS_WIDTH  13
+#define DISPLAY_FRAME_INTERVAL_MS  (33u) /* minimum time between display flushes (~30 fps) */
+#define DISPLAY_LIVE_SCROLL_WIDTH  (SSD1306_WIDTH - 3) /* scroll bar columns stay pinned */
 
 typedef enum {
     STATUS_FIELD = 0,
@@ -40,10 +42,23 @@ void display_start_screen(void);
 uint8_t display_setMode(StatusDisplayModes mode);
 uint8_t display_getMode(void);
 int16_t display_string(char *str, uint8_t line_number, uint8_t cursor_position, SSD1306_COLOR color, bool ceol_flag);
-int16_t display_status(StatusDisplayModes mode, uint32_t time_stamp, uint16_t index, ScrollDirection arrow_direction);
+int16_t display_status(StatusDisplayModes mode, uint32_t time_stamp, uint32_t index, ScrollDirection arrow_direction);
 int16_t display_string_to_status_line(char *str, uint8_t position);
 int16_t display_channel(uint8_t channel);
+void display_idle_overlay(uint16_t idle_permille);
+void display_stall_flag(bool is_on);
 void display_clear_page(SSD1306_COLOR color);
+void display_clear_line(uint8_t line_number);
+void display_shift_lines(int8_t lines);
 void display_draw_scroll_arrow(ScrollDirection arrow_direction);
+void display_live_line(char *str);
+void display_fifo_bar(uint8_t length);
+void display_present(void);
+bool display_service(void);
+bool display_get_present_time(uint32_t *at);
+uint32_t display_get_flush_count(void);
+#if defined(HOST_TEST)
+void display_present_now(void);
+#endif
 
 #endif /* INC_DISPLAY_H_ */
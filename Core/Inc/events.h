@@ -0,0 +1,36 @@
+/*
+ * events.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_EVENTS_H_
+#define INC_EVENTS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* interrupt sources that can leave work for the main loop ... one bit each */
+#define EVENT_MIDI_RX	(1u << 0)	/* byte placed in rxFIFO (USART1) */
+#define EVENT_TICK		(1u << 1)	/* SysTick or TIM4 wake-up ... scheduler may have released a task, display frame interval may have passed */
+#define EVENT_BUTTON	(1u << 2)	/* EXTI button edge */
+#define EVENT_DISPLAY	(1u << 3)	/* OLED DMA transfer finished ... main loop starts the next transfer or frame */
+
+/* CPU idle accounting window (ms) */
+#define EVENTS_IDLE_WINDOW_MS	(1000u)
+
+typedef struct {
+	uint16_t idle_permille;		/* time spent asleep in last complete window, 0..1000 */
+	uint32_t sleeps;			/* events_wait() calls that slept, since events_init() */
+	uint32_t posted[4];			/* events_post() count per event bit */
+} EventStats;
+
+void events_init(void);
+void events_post(uint32_t events);	/* any context */
+uint32_t events_take(void);			/* main loop ... events posted since last take/wait, cleared */
+uint32_t events_wait(void);			/* main loop ... sleep until an event is posted, then take */
+uint16_t events_get_idle_permille(void);
+void events_get_stats(EventStats *stats);
+
+#endif /* INC_EVENTS_H_ */
@@ -0,0 +1,65 @@
+/*
+ * history.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_HISTORY_H_
+#define INC_HISTORY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "midi.h"
+
+/* define data structure for midi data history ... packed, history storage is the largest SRAM consumer after rxFIFO */
+typedef struct __attribute__((packed)) {
+    uint8_t running_status; /* MIDI uses “running status” to omit repeated status bytes */
+	uint8_t data[2]; /* data payload (note/velocity/etc) */
+    uint32_t time_stamp; /* message arrival time ... timestamp of first byte passed from midi_build_packet() */
+    uint8_t channel; /* parsed channel number ... use for filtering display */
+} stc_midi_history;
+
+/* define number of storage pages for traffic history (limited by available SRAM) */
+#define NUMBER_PAGES    (512u)
+
+/* compressed history ... delta-encoded records in the same SRAM footprint, keyframe every HISTORY_KEYFRAME_INTERVAL records
+ * (history_compressed.c is only compiled in when set, host tests set it on the command line) */
+#ifndef HISTORY_USE_COMPRESSED
+#define HISTORY_USE_COMPRESSED		(0)
+#endif
+#define HISTORY_KEYFRAME_INTERVAL	(16u)
+
+/*
+ * Storage backend for the capture history.
+ *
+ * Records are addressed by a free-running sequence number assigned at append time (first record
+ * of a session = 0). A backend owns its storage and decides what to evict when it runs out of room,
+ * so ui.c never needs to know where (or how) records are physically stored.
+ */
+typedef struct {
+	const char *name;
+	uint32_t (*reset)(void);								/* discard all records, return capacity in records */
+	void     (*append)(const stc_midi_history *record);		/* store record under sequence number next() */
+	bool     (*read)(uint32_t sequence, stc_midi_history *record); /* false if sequence was evicted or not yet written */
+	uint32_t (*oldest)(void);								/* sequence number of oldest retained record */
+	uint32_t (*next)(void);									/* sequence number the next append will receive */
+	void     (*evict_before)(uint32_t sequence);			/* drop every record older than sequence */
+} HistoryBackend;
+
+extern const HistoryBackend history_sram_backend;
+extern const HistoryBackend history_compressed_backend;
+
+uint32_t history_init(const HistoryBackend *backend);
+uint32_t history_append(const stc_midi *ptr_packet);
+bool history_read(uint32_t sequence, stc_midi_history *record);
+uint32_t history_oldest(void);
+uint32_t history_newest(void);
+uint32_t history_count(void);
+uint32_t history_total(void);
+uint32_t history_capacity(void);
+void history_evict_before(uint32_t sequence);
+uint32_t history_find_time(uint32_t base, uint32_t offset_ms);
+
+#endif /* INC_HISTORY_H_ */
@@ -0,0 +1,57 @@
+/*
+ * loop_monitor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_LOOP_MONITOR_H_
+#define INC_LOOP_MONITOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_state_machine.h"
+
+/* a pass longer than this is a stall ... 50 ms of MIDI at full rate is ~160 bytes, under UART_FIFO_BACKLOG_THRESHOLD (192) */
+#ifndef LOOP_STALL_THRESHOLD_MS
+#define LOOP_STALL_THRESHOLD_MS	(50u)
+#endif
+#define LOOP_STALL_FLAG_MS		(3000u)	/* '!' stays on the status line this long after the last stall */
+
+/* main loop stages, in pass order ... loop_monitor_mark() when one finishes */
+typedef enum {
+	LOOP_STAGE_MIDI_FIFO = 0,	/* rxFIFO byte + midi_build_packet() */
+	LOOP_STAGE_MIDI_PACKET,		/* ui_process_midi_packet() */
+	LOOP_STAGE_TASK,			/* scheduler_dispatch() */
+	LOOP_STAGE_DISPLAY,			/* display_present() */
+	LOOP_STAGE_CONSOLE,			/* console_poll() */
+	LOOP_STAGE_COUNT
+} LoopStage;
+
+/* longest pass since reset, and where its time went */
+typedef struct {
+	uint32_t cycles;			/* whole pass */
+	uint32_t stage_cycles;		/* longest stage of that pass */
+	LoopStage stage;
+	const char *task;			/* task run in that pass, whichever stage was longest (NULL = none) */
+	uint16_t fifo_count;		/* rxFIFO fill when the pass ended */
+	AppState app_state;
+	uint32_t time_ms;			/* when it ended */
+} LoopStall;
+
+typedef struct {
+	LoopStall longest;
+	uint32_t passes;
+	uint32_t stalls;			/* passes over LOOP_STALL_THRESHOLD_MS */
+} LoopMonitorStats;
+
+void loop_monitor_init(void);
+void loop_monitor_begin(void);
+void loop_monitor_mark(LoopStage stage);
+void loop_monitor_task_ran(void);		/* after a scheduler_dispatch() that ran a task */
+void loop_monitor_end(void);
+void loop_monitor_get_stats(LoopMonitorStats *stats);
+const char* loop_monitor_stage_name(LoopStage stage);
+void loop_monitor_reset(void);
+
+#endif /* INC_LOOP_MONITOR_H_ */
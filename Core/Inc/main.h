@@ -31,6 +31,7 @@ extern "C" {
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "stdbool.h"
 
 /* USER CODE END Includes */
 
@@ -44,12 +45,15 @@ extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart2;
 
 extern volatile uint16_t fifo_count;
+extern volatile uint32_t midi_armed_ms, midi_first_byte_ms; /* startup capture timing (HAL_GetTick()) */
+extern volatile bool is_midi_first_byte;
 
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
-#define UART_FIFO_SIZE          (2048u)
+#define UART_FIFO_SIZE          (1536u) /* 4 byte records ... sized by the SRAM budget (ram_budget.h) */
+#define UART_FIFO_BACKLOG_THRESHOLD (UART_FIFO_SIZE >> 3) /* above this, FIFO draining and parsing preempt UI work */
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -0,0 +1,66 @@
+/*
+ * profile.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_PROFILE_H_
+#define INC_PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 0 = PROFILE_BEGIN()/PROFILE_END() compile to nothing (profile.c still builds, reports an empty table) */
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE	(1)
+#endif
+
+/* coarse log2 histogram ... bin n = 2^(n + PROFILE_HISTOGRAM_SHIFT) up to twice that, bin 0 everything shorter, last bin open ended */
+#define PROFILE_HISTOGRAM_BINS		(16u)
+#define PROFILE_HISTOGRAM_SHIFT		(6u)	/* bin 0 = under 128 cycles (1.8 us @ 72 MHz), bin 15 = 2M cycles (29 ms) and up */
+
+/* instrumented regions ... add a name to profile_region_names[] in profile.c with each new entry */
+typedef enum {
+	PROFILE_HEARTBEAT = 0,
+	PROFILE_READ_ENCODERS,
+	PROFILE_POLL_BUTTONS,
+	PROFILE_UART_RX_ISR,		/* HAL_UART_RxCpltCallback() (USART1) */
+	PROFILE_EXTI_ISR,			/* HAL_GPIO_EXTI_Callback() (buttons) */
+	PROFILE_TIMEBASE_ISR,		/* TIM4 counter extension and wake-up */
+	PROFILE_DISPLAY_FLUSH,		/* ssd1306_UpdateScreen() */
+	PROFILE_MAIN_LOOP,			/* main loop pass, sleep excluded (loop_monitor.c) */
+	PROFILE_REGION_COUNT
+} ProfileRegion;
+
+typedef struct {
+	const char *name;
+	uint32_t count;
+	uint32_t min_cycles;
+	uint32_t max_cycles;
+	uint64_t total_cycles;
+	uint32_t histogram[PROFILE_HISTOGRAM_BINS];
+} ProfileStats;
+
+/* cycle source ... DWT cycle counter on target, clock_gettime() scaled to SystemCoreClock on host */
+#if defined(PROFILE_HOST)
+uint32_t profile_host_cycles(void);
+#define PROFILE_CYCLES()	profile_host_cycles()
+#else
+#include "main.h"
+#define PROFILE_CYCLES()	(DWT->CYCCNT)
+#endif
+
+#if PROFILE_ENABLE
+#define PROFILE_BEGIN(region)	const uint32_t profile_start_##region = PROFILE_CYCLES()
+#define PROFILE_END(region)		profile_record((region), PROFILE_CYCLES() - profile_start_##region)
+#else
+#define PROFILE_BEGIN(region)
+#define PROFILE_END(region)
+#endif
+
+void profile_reset(void);
+void profile_record(ProfileRegion region, uint32_t cycles);	/* any context, one context per region */
+bool profile_get_stats(ProfileRegion region, ProfileStats *stats);
+
+#endif /* INC_PROFILE_H_ */
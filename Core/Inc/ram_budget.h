@@ -0,0 +1,40 @@
+/*
+ * ram_budget.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_RAM_BUDGET_H_
+#define INC_RAM_BUDGET_H_
+
+#include "main.h"
+#include "history.h"
+
+/*
+ * SRAM budget of the 20 KB part ... rxFIFO and capture history take what is left after everything else.
+ * Resizing UART_FIFO_SIZE or NUMBER_PAGES past the budget fails the build here instead of crashing at run time.
+ * RAM_BUDGET_OTHER is checked against the map file after every link by tools/ram_report.py, which also
+ * runs this header through the compiler on its own (--check), so a new size can be tried without a build.
+ *
+ * RAM_BUDGET_OTHER is an estimate, not taken from an ARM link map: .data/.bss of every Core/Src and HAL module
+ * compiled for x86 -m32 (32-bit pointers, layout close to but not the same as arm-none-eabi), Oct 19, 2026:
+ *   6215 bytes ... ssd1306.c 2194, scheduler 1173, main.c handles and rxBuffer 745, profiler 704, ui 422, rest
+ *   + about 450 bytes newlib-nano (reent, stdio streams, malloc state, guessed) = ~6.7 KB, budget 7 KB.
+ * tools/ram_report.py prints the real figure from the .map after every link ... replace this estimate with it.
+ */
+#define RAM_BUDGET_TOTAL		(20u * 1024u)	/* RAM LENGTH in STM32F103C8TX_FLASH.ld */
+#define RAM_BUDGET_STACK		(0x400u)		/* _Min_Stack_Size */
+#define RAM_BUDGET_HEAP			(0x200u)		/* _Min_Heap_Size (newlib stdout buffer, printf) */
+#define RAM_BUDGET_OTHER		(7u * 1024u)	/* all other .data/.bss ... ~6.7 KB estimated (above), rest is margin */
+#define RAM_BUDGET_BUFFERS		(RAM_BUDGET_TOTAL - RAM_BUDGET_STACK - RAM_BUDGET_HEAP - RAM_BUDGET_OTHER)
+
+#define RAM_FIFO_ENTRY_BYTES	(4u)			/* packed rxData ... byte + 24-bit timestamp */
+#define RAM_FIFO_BYTES			(UART_FIFO_SIZE * RAM_FIFO_ENTRY_BYTES)
+#define RAM_HISTORY_BYTES		(NUMBER_PAGES * sizeof(stc_midi_history))	/* either backend, same footprint */
+
+_Static_assert(RAM_FIFO_BYTES + RAM_HISTORY_BYTES <= RAM_BUDGET_BUFFERS,
+		"rxFIFO + history exceed SRAM budget ... reduce UART_FIFO_SIZE or NUMBER_PAGES (see ram_budget.h)");
+_Static_assert(UART_FIFO_SIZE >= 128u, "UART_FIFO_SIZE below 128 ... FIFO bar divides it by display width");
+
+#endif /* INC_RAM_BUDGET_H_ */
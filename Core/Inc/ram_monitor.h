@@ -0,0 +1,32 @@
+/*
+ * ram_monitor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_RAM_MONITOR_H_
+#define INC_RAM_MONITOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RAM_MONITOR_PAINT		(0xC5C5C5C5u)	/* fill pattern for free RAM between heap and stack */
+#define RAM_MONITOR_GUARD		(32u)			/* bytes below the stack pointer left unpainted */
+
+/* SRAM use since ram_monitor_paint() ... all sizes in bytes */
+typedef struct {
+	uint32_t ram_size;			/* RAM length from the linker script */
+	uint32_t data_size;			/* .data */
+	uint32_t bss_size;			/* .bss */
+	uint32_t heap_size;			/* newlib heap handed out by _sbrk() so far */
+	uint32_t stack_reserved;	/* _Min_Stack_Size */
+	uint32_t stack_high_water;	/* deepest stack seen (first overwritten paint word up to _estack) */
+	uint32_t stack_free;		/* paint still intact between heap end and deepest stack */
+	bool is_painted;
+} RamMonitorStats;
+
+void ram_monitor_paint(void);
+void ram_monitor_get_stats(RamMonitorStats *stats);
+
+#endif /* INC_RAM_MONITOR_H_ */
@@ -9,13 +9,51 @@
 #define INC_SCHEDULER_H_
 
 #include "stdint.h"
+#include "stdbool.h"
+#include "stddef.h"
 
-#define MAX_TASKS 8
+#ifndef MAX_TASKS
+#define MAX_TASKS 16
+#endif
+#define SCHEDULER_NO_TASK (-1)
+#define SCHEDULER_NO_DEADLINE (UINT32_MAX)  // scheduler_get_time_to_next() with nothing armed
 
 typedef void (*TaskCallback)(void);
+typedef int16_t TaskId;
+
+/* lower value runs first when several tasks are ready, tasks of equal priority run earliest deadline first */
+typedef enum {
+    TASK_PRIORITY_HIGH = 0,     // still runs while MIDI backlog holds off UI work
+    TASK_PRIORITY_NORMAL,
+    TASK_PRIORITY_LOW
+} TaskPriority;
+
+/* per-task counters for console report */
+typedef struct {
+    const char *name;
+    TaskPriority priority;
+    uint32_t interval_ms;       // 0 = one-shot timer
+    uint32_t runs;
+    uint32_t missed;            // deadlines that passed while task was still waiting to run
+    uint32_t budget_us;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint32_t overruns;          // runs longer than budget_us
+} TaskStats;
 
 void scheduler_init(void);
-void scheduler_add_task(TaskCallback callback, uint32_t interval_ms);
-void run_scheduled_tasks(void);  // Call this from HAL_SYSTICK_Callback()
+TaskId scheduler_add_task(const char *name, TaskCallback callback, uint32_t interval_ms, TaskPriority priority, uint32_t budget_us);
+TaskId scheduler_add_timer(const char *name, TaskCallback callback, TaskPriority priority, uint32_t budget_us);
+void scheduler_start_timer(TaskId id, uint32_t delay_ms);
+void scheduler_stop_timer(TaskId id);
+void scheduler_tick(void);                              // advance to timebase_get_ms() from the tick interrupt ... only marks due tasks ready
+void scheduler_advance(uint32_t now);                   // same, for a tick source that may skip ms (catches up in one call)
+uint32_t scheduler_get_time_to_next(void);              // ms until the next deadline could fall
+bool scheduler_get_next_deadline(uint32_t *deadline);   // when (timebase_get_ms()) the next deadline could fall
+bool scheduler_dispatch(TaskPriority lowest_priority);  // Call this from main loop ... runs one ready task
+uint32_t scheduler_get_missed(void);
+const char* scheduler_get_last_task_name(void);
+uint16_t scheduler_get_task_count(void);
+bool scheduler_get_task_stats(TaskId id, TaskStats *stats);
 
 #endif /* INC_SCHEDULER_H_ */
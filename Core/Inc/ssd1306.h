@@ -143,6 +143,14 @@ typedef struct {
     uint8_t DisplayOn;
 } SSD1306_t;
 
+// Flush statistics ... bytes on the bus, I2C address and control bytes included
+typedef struct {
+    uint32_t Frames;            // ssd1306_UpdateScreen() calls that sent something
+    uint32_t Bytes;             // total bytes sent
+    uint16_t LastFrameBytes;
+    uint16_t MaxFrameBytes;
+} SSD1306_Stats_t;
+
 typedef struct {
     uint8_t x;
     uint8_t y;
@@ -154,12 +162,26 @@ typedef struct {
 	const uint8_t height;               /**< Font height in pixels */
 	const uint16_t *const data;         /**< Pointer to font data array */
     const uint8_t *const char_width;    /**< Proportional character width in pixels (NULL for monospaced) */
+    const uint8_t *const columns;       /**< Column-major glyph bytes, bit 0 = top row (NULL = draw pixel by pixel) */
 } SSD1306_Font_t;
 
 // Procedure definitions
 void ssd1306_Init(void);
 void ssd1306_Fill(SSD1306_COLOR color);
 void ssd1306_UpdateScreen(void);
+uint8_t ssd1306_IsBusy(void);
+uint8_t ssd1306_ServiceTransfer(void);
+uint8_t ssd1306_IsDirty(void);
+void ssd1306_ScrollUp(uint8_t top_pages, uint8_t width);
+void ssd1306_ShiftRows(uint8_t y1, uint8_t y2, uint8_t width, int8_t dy);
+#if defined(HOST_TEST)
+void ssd1306_ResetScroll(void);
+#endif
+void ssd1306_GetStats(SSD1306_Stats_t* stats);
+void ssd1306_ResetStats(void);
+SSD1306_COLOR ssd1306_GetPixel(uint8_t x, uint8_t y);
+void ssd1306_TxCpltCallback(void);
+void ssd1306_TxErrorCallback(void);
 void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color);
 char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color);
 char ssd1306_WriteString(char* str, SSD1306_Font_t Font, SSD1306_COLOR color);
@@ -210,6 +232,7 @@ uint8_t ssd1306_GetDisplayOn();
 // Low-level procedures
 void ssd1306_Reset(void);
 void ssd1306_WriteCommand(uint8_t byte);
+void ssd1306_WriteCommands(const uint8_t* buffer, size_t buff_size);
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size);
 SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len);
 
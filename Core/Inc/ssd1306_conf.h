@@ -24,6 +24,11 @@
 #define SSD1306_USE_I2C
 //#define SSD1306_USE_SPI
 
+// Flush screenbuffer over I2C with DMA (non-blocking ssd1306_UpdateScreen)
+// Needs I2C TX DMA channel, I2C event/error interrupts, HAL_I2C_MasterTxCpltCallback()/HAL_I2C_ErrorCallback()
+// forwarding to ssd1306_TxCpltCallback()/ssd1306_TxErrorCallback() and ssd1306_ServiceTransfer() called from the main loop
+#define SSD1306_USE_DMA
+
 // I2C Configuration
 #define SSD1306_I2C_PORT        hi2c1
 #define SSD1306_I2C_ADDR        (0x3C << 1)
@@ -0,0 +1,33 @@
+/*
+ * timebase.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_TIMEBASE_H_
+#define INC_TIMEBASE_H_
+
+#include "stdint.h"
+#include "stdbool.h"
+
+/*
+ * 1 = tickless ... free-running TIM4 is the ms time base, SysTick is stopped and the core only wakes for the next
+ * scheduler deadline (TIM4 compare), MIDI bytes, buttons and display transfers.
+ * 0 = 1 kHz SysTick drives time and scheduler (HAL_SYSTICK_Callback() calls timebase_tick())
+ */
+#ifndef TIMEBASE_USE_TICKLESS
+#define TIMEBASE_USE_TICKLESS   (1)
+#endif
+
+#define TIMEBASE_TICK_HZ        (2000u)     // TIM4 count rate ... 72 MHz timer clock / 36000, 16-bit counter wraps every 32.768 s
+#define TIMEBASE_TICKS_PER_MS   (TIMEBASE_TICK_HZ / 1000u)
+
+void timebase_init(void);                       // after MX_TIM4_Init() ... takes over from SysTick (tickless)
+uint32_t timebase_get_ms(void);                 // ms since power-up, wraps like HAL_GetTick() (which returns the same)
+void timebase_tick(void);                       // Call this from HAL_SYSTICK_Callback() ... 1 kHz mode only, no-op when tickless
+void timebase_request_wakeup(uint32_t at_ms);   // wake the core at at_ms (or earlier if already requested) ... tickless only
+void timebase_irq_handler(void);                // Call this from TIM4_IRQHandler() ... the whole handler, no HAL_TIM_IRQHandler()
+uint32_t timebase_get_wakeups(void);            // TIM4 compare wake-ups since timebase_init()
+
+#endif /* INC_TIMEBASE_H_ */
@@ -0,0 +1,62 @@
+/*
+ * trigger.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef INC_TRIGGER_H_
+#define INC_TRIGGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "midi.h"
+
+/* maximum number of messages in a trigger sequence */
+#define TRIGGER_MAX_STEPS	(4u)
+
+/* default pre/post-trigger window (records kept before/after matching message) */
+#define TRIGGER_DEFAULT_PRE_COUNT	(64u)
+#define TRIGGER_DEFAULT_POST_COUNT	(64u)
+
+/* default trigger (preset 0) armed at startup ... "All Notes Off" (CC 123) on any channel, the usual stuck-note panic
+ * (otherwise armed from console `T`, console `g` selects another preset) */
+#define TRIGGER_DEFAULT_ENABLE		(0)
+
+/* single message match ... (status & status_mask) == status_value, channel 0 = any, inclusive data ranges */
+typedef struct {
+	uint8_t status_mask;
+	uint8_t status_value;
+	uint8_t channel;
+	uint8_t data1_min, data1_max;
+	uint8_t data2_min, data2_max;
+} TriggerCondition;
+
+typedef enum {
+	TRIGGER_DISARMED,
+	TRIGGER_ARMED,		/* evaluating incoming messages */
+	TRIGGER_POST,		/* matched, capturing post-trigger records */
+	TRIGGER_FROZEN		/* window captured, history frozen */
+} TriggerState;
+
+typedef enum {
+	TRIGGER_EVENT_NONE,
+	TRIGGER_EVENT_MATCH,
+	TRIGGER_EVENT_FROZEN
+} TriggerEvent;
+
+void trigger_init(void);
+uint8_t trigger_get_preset_count(void);
+const char* trigger_get_preset_name(uint8_t preset);
+void trigger_load_preset(uint8_t preset);
+void trigger_configure(const TriggerCondition *steps, uint8_t number_steps, uint32_t pre_count, uint32_t post_count);
+void trigger_arm(void);
+void trigger_disarm(void);
+void trigger_rearm(void);
+TriggerEvent trigger_process(const stc_midi *ptr_packet, uint32_t sequence);
+TriggerState trigger_get_state(void);
+bool trigger_is_frozen(void);
+uint32_t trigger_get_sequence(void);
+uint32_t trigger_get_first_sequence(void);
+
+#endif /* INC_TRIGGER_H_ */
@@ -21,6 +21,7 @@
 typedef struct {
     volatile bool pressed;
     volatile bool released;
+    volatile bool claimed;		/* press used as modifier (chord) ... release generates no event */
     uint32_t press_time;
     uint32_t release_time;
     uint32_t last_event_time;
@@ -29,8 +30,6 @@ typedef struct {
 
 static ButtonState button_states[BUTTON_COUNT];
 
-extern TIM_HandleTypeDef htim4;
-extern volatile bool timeoutFlag;
 
 void button_init(void) {
     for (int i = 0; i < BUTTON_COUNT; ++i) {
@@ -57,6 +56,7 @@ void button_exti_trigger(ButtonID id, bool is_pressed) {
     else if (!button_states[id].pressed && is_pressed) {
 		/* button just pressed */
         button_states[id].pressed = true;
+        button_states[id].claimed = false;
         button_states[id].press_time = now;
     } else {
     	// button just released ... always accept release if button was previously pressed
@@ -70,20 +70,25 @@ void button_exti_trigger(ButtonID id, bool is_pressed) {
 /* button actions here */
 void button_poll(void) {
     for (int i = 0; i < BUTTON_COUNT; ++i) {
-    	bool released = false;
+    	bool released = false, claimed = false;
 		uint32_t press_time = 0, release_time = 0;
 
 		__disable_irq(); // Begin critical section
 		if (button_states[i].released) {
 			released = true;
+			claimed = button_states[i].claimed;
 			button_states[i].released = false;
 			button_states[i].pressed = false;
+			button_states[i].claimed = false;
 			press_time = button_states[i].press_time;
 			release_time = button_states[i].release_time;
 		}
 		__enable_irq(); // End critical section
 
-		if (released) {
+		if (released && claimed) {
+			printf("Button %d: released (used as modifier)\r\n", i);
+		}
+		else if (released) {
 			uint32_t duration = release_time - press_time;
             if (duration >= LONG_PRESS_THRESHOLD_MS) {
                 button_states[i].pending_event = BUTTON_EVENT_LONG_PRESS;
@@ -118,10 +123,6 @@ void button_poll(void) {
                 switch(i)
 				{
 					case BUTTON_SCROLL: /* set display mode to LIVE */
-						/* kill oneshot timer if app_state back to LIVE */
-						HAL_TIM_Base_Stop_IT(&htim4);
-						__HAL_TIM_SET_COUNTER(&htim4, 0);
-						timeoutFlag = false;
 						app_set_state(APP_STATE_MIDI_DISPLAY);
 						printf("Set display mode to LIVE\r\n");
 						display_setMode(LIVE);
@@ -129,7 +130,14 @@ void button_poll(void) {
 
 						break;
 
-					case BUTTON_FILTER: /* reset channel filter to "ALL" */
+					case BUTTON_FILTER:
+						if(button_is_held(BUTTON_SCROLL)) /* scroll button held ... toggle jump-to-time step seconds/minutes */
+						{
+							button_claim(BUTTON_SCROLL);
+							ui_toggle_time_jump_step();
+							break;
+						}
+						/* reset channel filter to "ALL" */
 						printf("Reset channel filter to 'ALL'\r\n");
 						__HAL_TIM_SET_COUNTER(&htim3, 0);
 						display_channel(filter_resetChannel());
@@ -145,6 +153,17 @@ void button_poll(void) {
     }
 }
 
+bool button_is_held(ButtonID id) {
+    return button_states[id].pressed && !button_states[id].released;
+}
+
+/* use current press as modifier for another control ... returns true on first claim of this press */
+bool button_claim(ButtonID id) {
+    bool was_claimed = button_states[id].claimed;
+    button_states[id].claimed = true;
+    return !was_claimed;
+}
+
 ButtonEvent button_get_event(ButtonID id) {
     ButtonEvent event = button_states[id].pending_event;
     button_states[id].pending_event = BUTTON_EVENT_NONE;
@@ -0,0 +1,356 @@
+/*
+ * console.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "stdio.h"
+#include "main.h"
+#include "console.h"
+#include "display.h"
+#include "scheduler.h"
+#include "events.h"
+#include "timebase.h"
+#include "profile.h"
+#include "loop_monitor.h"
+#include "ram_monitor.h"
+#include "filter_channels.h"
+#include "history.h"
+#include "trigger.h"
+#include "ui.h"
+
+/*
+ * Debug console on USART2 (same port as printf) ... single key commands, polled from the main loop so a
+ * command can never interrupt MIDI capture. Output is blocking printf, use while investigating only.
+ *
+ *   d   dump screen as plain PBM (P1) ... paste into a .pbm file to view or diff against a golden image
+ *   m   display transfer metrics (frames, bytes, modelled bus time at 100/400 kHz)
+ *   f   toggle per-frame metrics (one line per flush)
+ *   r   reset display transfer metrics
+ *   s   scheduler tasks (runs, missed deadlines, execution time against budget)
+ *   i   CPU idle (time asleep in main loop WFI), wake-up events, time of MIDI capture start and first byte
+ *   o   toggle CPU idle overlay on OLED status line (replaces channel field, updated once a second)
+ *   p   profiled regions (tasks, interrupt callbacks, display flush) ... count, min/avg/max, log2 histogram
+ *   P   reset profiled regions
+ *   l   main loop passes ... longest pass with the stage, task and FIFO fill behind it, stalls over threshold (L = reset)
+ *   u   SRAM use ... static data, heap, stack high-water mark against the linker reserve
+ *   t   trigger preset and state ... match and freeze are reported here as they happen (not from the packet path)
+ *   T   arm trigger (again after a freeze, history resumes) or disarm
+ *   g   next trigger preset (armed again if it was armed)
+ *   h/? help
+ */
+
+static bool is_frame_trace_enabled = false;
+static uint32_t traced_frames = 0;
+static bool is_idle_overlay_enabled = false;
+static uint8_t trigger_preset = 0;
+static TriggerState reported_trigger_state = TRIGGER_DISARMED;
+
+/* modelled bus time for bytes at bus_hz ... 9 bit times per byte */
+static uint32_t console_bus_time_us(uint32_t bytes, uint32_t bus_hz)
+{
+	return (uint32_t)(((uint64_t)bytes * 9u * 1000000u) / bus_hz);
+}
+
+static void console_help(void)
+{
+	printf("\r\nConsole commands:\r\n");
+	printf("  d - dump screen (PBM)\r\n");
+	printf("  m - display transfer metrics\r\n");
+	printf("  f - toggle per-frame metrics\r\n");
+	printf("  r - reset display transfer metrics\r\n");
+	printf("  s - scheduler tasks\r\n");
+	printf("  i - CPU idle\r\n");
+	printf("  o - toggle CPU idle overlay\r\n");
+	printf("  p - profiled regions (P = reset)\r\n");
+	printf("  l - main loop stalls (L = reset)\r\n");
+	printf("  u - SRAM use and stack high-water\r\n");
+	printf("  t - trigger (T = arm/disarm, g = next preset)\r\n");
+}
+
+/* plain PBM, one text row per pixel row (1 = lit pixel) */
+static void console_dump_screen(void)
+{
+	char row[SSD1306_WIDTH + 1];
+
+	printf("P1\r\n%d %d\r\n", SSD1306_WIDTH, SSD1306_HEIGHT);
+	for(uint8_t y = 0; y < SSD1306_HEIGHT; y++)
+	{
+		for(uint8_t x = 0; x < SSD1306_WIDTH; x++)
+			row[x] = (White == ssd1306_GetPixel(x, y)) ? '1' : '0';
+		row[SSD1306_WIDTH] = '\0';
+		printf("%s\r\n", row);
+	}
+}
+
+static void console_metrics(void)
+{
+	SSD1306_Stats_t stats;
+	uint32_t average_bytes;
+	uint32_t fills_started, fills_completed, fills_cancelled;
+
+	ssd1306_GetStats(&stats);
+	average_bytes = stats.Frames ? stats.Bytes / stats.Frames : 0;
+	printf("\r\nDisplay frames = %lu, flushes = %lu, bytes = %lu\r\n", (unsigned long)stats.Frames, (unsigned long)display_get_flush_count(), (unsigned long)stats.Bytes);
+	printf("Bytes/frame: last %u, avg %lu, max %u\r\n", stats.LastFrameBytes, (unsigned long)average_bytes, stats.MaxFrameBytes);
+	printf("Bus time/frame @100kHz: avg %lu us, max %lu us\r\n", (unsigned long)console_bus_time_us(average_bytes, CONSOLE_I2C_STANDARD_HZ), (unsigned long)console_bus_time_us(stats.MaxFrameBytes, CONSOLE_I2C_STANDARD_HZ));
+	printf("Bus time/frame @400kHz: avg %lu us, max %lu us\r\n", (unsigned long)console_bus_time_us(average_bytes, CONSOLE_I2C_FAST_HZ), (unsigned long)console_bus_time_us(stats.MaxFrameBytes, CONSOLE_I2C_FAST_HZ));
+	printf("Scheduler missed deadlines = %lu\r\n", (unsigned long)scheduler_get_missed());
+	ui_get_fill_stats(&fills_started, &fills_completed, &fills_cancelled);
+	printf("Scroll fills: started %lu, completed %lu, cancelled %lu\r\n", (unsigned long)fills_started, (unsigned long)fills_completed, (unsigned long)fills_cancelled);
+}
+
+/* one line per task ... interval 0 = one-shot timer, times in us (DWT cycle counter) */
+static void console_tasks(void)
+{
+	TaskStats stats;
+
+	printf("\r\nTask         pri  interval      runs  missed  last us   max us  budget  overruns\r\n");
+	for(TaskId id = 0; id < scheduler_get_task_count(); id++)
+	{
+		if(false == scheduler_get_task_stats(id, &stats))
+			continue;
+		printf("%-12s %3u %9lu %9lu %7lu %8lu %8lu %7lu %9lu\r\n", stats.name, (unsigned)stats.priority, (unsigned long)stats.interval_ms,
+				(unsigned long)stats.runs, (unsigned long)stats.missed, (unsigned long)stats.last_us, (unsigned long)stats.max_us,
+				(unsigned long)stats.budget_us, (unsigned long)stats.overruns);
+	}
+	uint32_t next = scheduler_get_time_to_next();
+	if(SCHEDULER_NO_DEADLINE == next)
+		printf("Next deadline: none\r\n");
+	else
+		printf("Next deadline in %lu ms\r\n", (unsigned long)next);
+}
+
+/* one line per frame sent since last call */
+static void console_trace_frames(void)
+{
+	SSD1306_Stats_t stats;
+
+	ssd1306_GetStats(&stats);
+	if(stats.Frames == traced_frames)
+		return;
+	traced_frames = stats.Frames;
+	printf("frame %lu: %u bytes, %lu us @100kHz, %lu us @400kHz\r\n", (unsigned long)stats.Frames, stats.LastFrameBytes,
+			(unsigned long)console_bus_time_us(stats.LastFrameBytes, CONSOLE_I2C_STANDARD_HZ), (unsigned long)console_bus_time_us(stats.LastFrameBytes, CONSOLE_I2C_FAST_HZ));
+}
+
+/* idle over last EVENTS_IDLE_WINDOW_MS ... headroom left for MIDI bursts */
+static void console_idle(void)
+{
+	EventStats stats;
+
+	events_get_stats(&stats);
+	printf("CPU idle %u.%u %% (last %u ms), sleeps %lu\r\n", stats.idle_permille / 10u, stats.idle_permille % 10u,
+			EVENTS_IDLE_WINDOW_MS, (unsigned long)stats.sleeps);
+	printf("Events: midi rx %lu, tick %lu, button %lu, display %lu\r\n", (unsigned long)stats.posted[0],
+			(unsigned long)stats.posted[1], (unsigned long)stats.posted[2], (unsigned long)stats.posted[3]);
+	printf("Time base: %s, %lu wake-ups\r\n", TIMEBASE_USE_TICKLESS ? "tickless (TIM4)" : "SysTick 1 kHz",
+			(unsigned long)timebase_get_wakeups());
+	if(is_midi_first_byte)
+		printf("MIDI capture armed at %lu ms, first byte at %lu ms\r\n", (unsigned long)midi_armed_ms, (unsigned long)midi_first_byte_ms);
+	else
+		printf("MIDI capture armed at %lu ms, no bytes yet\r\n", (unsigned long)midi_armed_ms);
+}
+
+/* one line per region, times in us ... histogram as floor(log2(cycles)):count for non-empty bins */
+static void console_profile(void)
+{
+	ProfileStats stats;
+	const uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+
+	printf("\r\nRegion            count    min us    avg us    max us\r\n");
+	for(uint8_t region = 0; region < PROFILE_REGION_COUNT; region++)
+	{
+		if(false == profile_get_stats(region, &stats))
+			continue;
+		uint32_t average = (0 == stats.count) ? 0 : (uint32_t)(stats.total_cycles / stats.count);
+		printf("%-14s %8lu %9lu %9lu %9lu\r\n", stats.name, (unsigned long)stats.count, (unsigned long)(stats.min_cycles / cycles_per_us),
+				(unsigned long)(average / cycles_per_us), (unsigned long)(stats.max_cycles / cycles_per_us));
+		if(0 == stats.count)
+			continue;
+		printf("  log2 cycles:");
+		for(uint8_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+		{
+			if(0 != stats.histogram[bin])
+				printf(" %s%u:%lu", (0 == bin) ? "<" : "", (unsigned)(bin + PROFILE_HISTOGRAM_SHIFT + (0 == bin)), (unsigned long)stats.histogram[bin]);
+		}
+		printf("\r\n");
+	}
+	if(0 == PROFILE_ENABLE)
+		printf("Profiling disabled (PROFILE_ENABLE 0)\r\n");
+}
+
+/* longest main loop pass ... pass histogram is the "main loop pass" row of console_profile() */
+static void console_loop(void)
+{
+	LoopMonitorStats stats;
+	const uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+
+	loop_monitor_get_stats(&stats);
+	printf("Main loop: %lu passes, %lu stalls over %u ms\r\n", (unsigned long)stats.passes, (unsigned long)stats.stalls, LOOP_STALL_THRESHOLD_MS);
+	if(0 == stats.passes)
+		return;
+	printf("Longest pass %lu us at %lu ms: %s %lu us", (unsigned long)(stats.longest.cycles / cycles_per_us), (unsigned long)stats.longest.time_ms,
+			loop_monitor_stage_name(stats.longest.stage), (unsigned long)(stats.longest.stage_cycles / cycles_per_us));
+	if(NULL != stats.longest.task)
+		printf(" (%s)", stats.longest.task);
+	printf(", fifo %u, app state %u\r\n", stats.longest.fifo_count, (unsigned)stats.longest.app_state);
+}
+
+/* static RAM from linker symbols, stack depth from paint left intact since power-on */
+static void console_ram(void)
+{
+	RamMonitorStats stats;
+
+	ram_monitor_get_stats(&stats);
+	printf("\r\nSRAM %lu bytes: .data %lu, .bss %lu, heap %lu\r\n", (unsigned long)stats.ram_size,
+			(unsigned long)stats.data_size, (unsigned long)stats.bss_size, (unsigned long)stats.heap_size);
+	if(false == stats.is_painted)
+	{
+		printf("Stack not painted\r\n");
+		return;
+	}
+	printf("Stack high-water %lu of %lu reserved%s, %lu never touched\r\n", (unsigned long)stats.stack_high_water,
+			(unsigned long)stats.stack_reserved, stats.stack_high_water > stats.stack_reserved ? " (OVER)" : "",
+			(unsigned long)stats.stack_free);
+}
+
+static void console_trigger(void)
+{
+	static const char *state_names[] = {"disarmed", "armed", "capturing post-trigger records", "frozen"};
+	TriggerState state = trigger_get_state();
+
+	printf("Trigger: %s, %s\r\n", trigger_get_preset_name(trigger_preset), state_names[state]);
+	if(TRIGGER_POST == state || TRIGGER_FROZEN == state)
+		printf("Matched at record %lu\r\n", (unsigned long)trigger_get_sequence());
+}
+
+/* match and freeze since last poll ... both may have happened in between (post_count 0 or a burst) */
+static void console_trigger_report(void)
+{
+	TriggerState state = trigger_get_state();
+
+	if(state == reported_trigger_state)
+		return;
+	if((TRIGGER_POST == state || TRIGGER_FROZEN == state) && TRIGGER_POST != reported_trigger_state)
+		printf("Trigger matched at record %lu\r\n", (unsigned long)trigger_get_sequence());
+	if(TRIGGER_FROZEN == state)
+		printf("Trigger window captured, history frozen (records %lu..%lu)\r\n", (unsigned long)history_oldest(), (unsigned long)history_newest());
+	reported_trigger_state = state;
+}
+
+/* scheduler task ... redraws overlay once per idle window while enabled */
+static void console_idle_overlay(void)
+{
+	if(is_idle_overlay_enabled)
+		display_idle_overlay(events_get_idle_permille());
+}
+
+void console_init(void)
+{
+	is_frame_trace_enabled = false;
+	is_idle_overlay_enabled = false;
+	ssd1306_ResetStats();
+	traced_frames = 0;
+	trigger_preset = 0; /* trigger_init() loads preset 0 */
+	reported_trigger_state = trigger_get_state();
+	scheduler_add_task("idle overlay", console_idle_overlay, EVENTS_IDLE_WINDOW_MS, TASK_PRIORITY_LOW, 5000);
+}
+
+/* call from main loop ... handles at most one key per call */
+void console_poll(void)
+{
+	if(is_frame_trace_enabled)
+		console_trace_frames();
+	console_trigger_report();
+
+	if(RESET == __HAL_UART_GET_FLAG(&huart2, UART_FLAG_RXNE)) /* no key pressed */
+		return;
+
+	switch((char)(huart2.Instance->DR & 0xFF))
+	{
+		case 'd':
+			console_dump_screen();
+			break;
+		case 'm':
+			console_metrics();
+			break;
+		case 'f':
+			is_frame_trace_enabled = !is_frame_trace_enabled;
+			traced_frames = 0;
+			if(is_frame_trace_enabled)
+			{
+				SSD1306_Stats_t stats;
+				ssd1306_GetStats(&stats);
+				traced_frames = stats.Frames; /* only report frames from now on */
+			}
+			printf("Per-frame metrics %s\r\n", is_frame_trace_enabled ? "on" : "off");
+			break;
+		case 's':
+			console_tasks();
+			break;
+		case 'i':
+			console_idle();
+			break;
+		case 'p':
+			console_profile();
+			break;
+		case 'P':
+			profile_reset();
+			printf("Profiled regions reset\r\n");
+			break;
+		case 'l':
+			console_loop();
+			break;
+		case 'L':
+			loop_monitor_reset();
+			printf("Main loop stalls reset\r\n");
+			break;
+		case 'u':
+			console_ram();
+			break;
+		case 't':
+			console_trigger();
+			break;
+		case 'T':
+			if(TRIGGER_DISARMED == trigger_get_state() || TRIGGER_FROZEN == trigger_get_state())
+				trigger_arm();
+			else
+				trigger_disarm();
+			reported_trigger_state = trigger_get_state();
+			console_trigger();
+			break;
+		case 'g':
+		{
+			bool is_armed = (TRIGGER_ARMED == trigger_get_state());
+
+			trigger_preset = (trigger_preset + 1) % trigger_get_preset_count();
+			trigger_load_preset(trigger_preset);
+			if(is_armed)
+				trigger_arm();
+			reported_trigger_state = trigger_get_state();
+			console_trigger();
+			break;
+		}
+		case 'o':
+			is_idle_overlay_enabled = !is_idle_overlay_enabled;
+			if(is_idle_overlay_enabled)
+				console_idle_overlay();
+			else
+				display_channel(filter_getChannel()); /* put channel field back */
+			printf("CPU idle overlay %s\r\n", is_idle_overlay_enabled ? "on" : "off");
+			break;
+		case 'r':
+			ssd1306_ResetStats();
+			traced_frames = 0;
+			printf("Display transfer metrics reset\r\n");
+			break;
+		case 'h':
+		case '?':
+			console_help();
+			break;
+		default:
+			break;
+	}
+}
@@ -10,6 +10,8 @@
 #include "display.h"
 #include "filter_channels.h"
 #include "ui.h"
+#include "app_state_machine.h"
+#include "profile.h"
 
 
 #define STATUS_LINE_LINE_NUMBER  0
@@ -22,6 +24,10 @@ static uint8_t line_height;
 static uint8_t chars_per_line;
 static uint8_t number_lines;
 static uint8_t display_mode = LIVE;
+static uint32_t last_present_tick = 0;
+static uint32_t flush_count = 0;
+static uint8_t fifo_bar_length = 0;
+static bool is_stall_flag_on = false;
 
 void display_init(void)
 {
@@ -56,14 +62,11 @@ void display_splash_screen()
   line_number = DISPLAY_DEFAULT_FONT.height * 6 + 4;
   ssd1306_SetCursor(3, 56);
   ssd1306_WriteString(print_buffer, DISPLAY_DEFAULT_FONT, White);
-
-  ssd1306_UpdateScreen();
 }
 
 void display_clear_screen(SSD1306_COLOR color)
 {
 	ssd1306_Fill(color);
-	ssd1306_UpdateScreen();
 }
 
 void display_start_screen(void)
@@ -103,11 +106,28 @@ int16_t display_string(char *str, uint8_t line_number, uint8_t cursor_position,
 		while(cursor_end_position++ < chars_per_line - 1) /* last character column reserved for scroll bar */
 			ssd1306_WriteChar(' ', DISPLAY_DEFAULT_FONT, color);
 	}
-	ssd1306_UpdateScreen();
 	return 0;
 }
 
-int16_t display_status(StatusDisplayModes mode, uint32_t time_stamp, uint16_t index, ScrollDirection arrow_direction)
+/*
+ * '!' in the cell right of the status/channel separator (its first pixel column is the separator) ... no text
+ * field writes there. Not drawn over the splash screen, display_start_screen() draws it with the status field
+ */
+static void display_draw_stall_flag(void)
+{
+	uint8_t x = (STATUS_LINE_STATUS_WIDTH + 1) * DISPLAY_DEFAULT_FONT.width + 3;
+
+	if(APP_STATE_SPLASH == app_get_state())
+		return;
+	ssd1306_FillRectangle(x - 1, 0, x + 1, DISPLAY_DEFAULT_FONT.height - 1, Black);
+	if(is_stall_flag_on)
+	{
+		ssd1306_Line(x, 0, x, DISPLAY_DEFAULT_FONT.height - 4, White);
+		ssd1306_DrawPixel(x, DISPLAY_DEFAULT_FONT.height - 2, White);
+	}
+}
+
+int16_t display_status(StatusDisplayModes mode, uint32_t time_stamp, uint32_t index, ScrollDirection arrow_direction)
 {
 	if(time_stamp > 99999999)
 		time_stamp = 99999999;
@@ -130,17 +150,17 @@ int16_t display_status(StatusDisplayModes mode, uint32_t time_stamp, uint16_t in
 	else if(INDEX == mode)
 	{
 		display_draw_scroll_arrow(ui_get_scroll_direction_indicator());
-		sprintf(print_buffer, "%d %lu", index, (unsigned long)time_stamp);
+		sprintf(print_buffer, "%lu %lu", (unsigned long)index, (unsigned long)time_stamp);
 		display_string(print_buffer, STATUS_LINE_LINE_NUMBER, 1, White, false);
 		uint8_t cursor_end_position = strlen(print_buffer);
 		while(cursor_end_position++ < STATUS_LINE_STATUS_WIDTH)
 			ssd1306_WriteChar(' ', DISPLAY_DEFAULT_FONT, White);
 	}
-
-	ssd1306_UpdateScreen();
+	display_draw_stall_flag(); /* display_start_screen() cleared it, a field over its width runs into its cell */
 
 	return 0;
 }
+
 int16_t display_string_to_status_line(char *str, uint8_t position)
 {
 	display_string(str, STATUS_LINE_LINE_NUMBER, position, White, false);
@@ -158,10 +178,67 @@ int16_t display_channel(uint8_t channel)
 	return channel;
 }
 
+/* main loop stall marker on the status line (loop_monitor.c) */
+void display_stall_flag(bool is_on)
+{
+	is_stall_flag_on = is_on;
+	display_draw_stall_flag();
+}
+
+/* CPU idle percentage over the channel field (console 'o') ... inverted so it can't be mistaken for a channel */
+void display_idle_overlay(uint16_t idle_permille)
+{
+	sprintf(print_buffer, "I:%3u%%", (unsigned)(idle_permille / 10u));
+	display_string(print_buffer, STATUS_LINE_LINE_NUMBER, STATUS_LINE_STATUS_WIDTH + 2, Black, false);
+}
+
 void display_clear_page(SSD1306_COLOR color)
 {
 //	ssd1306_FillRectangle(0, line_height, SSD1306_WIDTH, SSD1306_HEIGHT, Black);
-	ssd1306_FillRectangle(0, line_height, SSD1306_WIDTH - 4, SSD1306_HEIGHT - 2, Black); /* "-2" to preserve FIFO level at bottom */
+	/* start below status line font (not line_height) ... hardware scrolled live lines use every page row */
+	ssd1306_FillRectangle(0, DISPLAY_DEFAULT_FONT.height, SSD1306_WIDTH - 4, SSD1306_HEIGHT - 2, Black); /* "-2" to preserve FIFO level at bottom */
+}
+
+/* blank text cell of one line (status line and fifo bar untouched) */
+void display_clear_line(uint8_t line_number)
+{
+	ssd1306_FillRectangle(0, line_number * line_height, SSD1306_WIDTH - 4, line_number * line_height + DISPLAY_DEFAULT_FONT.height - 1, Black);
+}
+
+/*
+ * move text area (below status line, left of scroll bar, above fifo bar) by whole lines, lines > 0 = down ...
+ * lines moved in come up blank, caller draws them. Same area as display_clear_page()
+ */
+void display_shift_lines(int8_t lines)
+{
+	ssd1306_ShiftRows(DISPLAY_DEFAULT_FONT.height, SSD1306_HEIGHT - 2, SSD1306_WIDTH - 3, lines * line_height);
+}
+
+/*
+ * hardware scrolled live view ... one page per line, newest at bottom. Older lines move up by shifting the
+ * display start line, status line and scroll bar stay pinned, only the new line and pinned areas are rewritten
+ */
+void display_live_line(char *str)
+{
+	/* fifo bar row is the bottom row of the newest line's page ... erase the bar so it doesn't scroll up with the
+	 * text (only its lit part, the rest of the row is already blank and stays off the bus) */
+	if(0 != fifo_bar_length)
+		ssd1306_Line(0, SSD1306_HEIGHT - 1, fifo_bar_length - 1, SSD1306_HEIGHT - 1, Black);
+	ssd1306_ScrollUp(1, DISPLAY_LIVE_SCROLL_WIDTH); /* page 0 = status line */
+	ssd1306_SetCursor(0, SSD1306_HEIGHT - 8);
+	ssd1306_WriteString(str, DISPLAY_DEFAULT_FONT, White);
+	display_fifo_bar(fifo_bar_length); /* glyph background just overwrote it */
+}
+
+/*
+ * horizontal fifo utilization bar on the bottom pixel row ... kept out of text by the font, Font_6x8 leaves the
+ * bottom row of every glyph blank, so the bar can share the newest line's page without covering any text
+ */
+void display_fifo_bar(uint8_t length)
+{
+	fifo_bar_length = length;
+	ssd1306_DrawRectangle(0, SSD1306_HEIGHT - 1, length, SSD1306_HEIGHT - 1, White);
+	ssd1306_DrawRectangle(length, SSD1306_HEIGHT - 1, SSD1306_WIDTH - 4, SSD1306_HEIGHT - 1, Black);
 }
 
 void display_draw_scroll_arrow(ScrollDirection arrow_direction)
@@ -184,3 +261,55 @@ void display_draw_scroll_arrow(ScrollDirection arrow_direction)
 		ssd1306_DrawPixel(4, 4, White);
 	}
 }
+
+/*
+ * Drawing functions only change the framebuffer ... display_present() (main loop) sends the accumulated changes
+ * at most once every DISPLAY_FRAME_INTERVAL_MS, so a burst of packets costs one flush instead of one per call
+ */
+void display_present(void)
+{
+	uint32_t now = HAL_GetTick();
+
+	if(now - last_present_tick < DISPLAY_FRAME_INTERVAL_MS)
+		return;
+	if(!ssd1306_IsDirty() || ssd1306_IsBusy()) /* nothing to send, or previous frame still on the bus */
+		return;
+	last_present_tick = now;
+	flush_count++;
+	PROFILE_BEGIN(PROFILE_DISPLAY_FLUSH);
+	ssd1306_UpdateScreen();
+	PROFILE_END(PROFILE_DISPLAY_FLUSH);
+}
+
+/* keep a frame on the bus moving (every main loop pass, backlog or not) ... true = next transfer is waiting for the bus to go idle, main loop must not sleep */
+bool display_service(void)
+{
+	return 0 != ssd1306_ServiceTransfer();
+}
+
+/* when display_present() can next send (false = nothing to send, or frame on the bus ... its end wakes the main loop) */
+bool display_get_present_time(uint32_t *at)
+{
+	if(!ssd1306_IsDirty() || ssd1306_IsBusy())
+		return false;
+	*at = last_present_tick + DISPLAY_FRAME_INTERVAL_MS;
+	return true;
+}
+
+#if defined(HOST_TEST)
+/* host tests only ... flush immediately, ignoring frame interval (firmware presents from the main loop, splash included) */
+void display_present_now(void)
+{
+	last_present_tick = HAL_GetTick();
+	flush_count++;
+	PROFILE_BEGIN(PROFILE_DISPLAY_FLUSH);
+	ssd1306_UpdateScreen();
+	PROFILE_END(PROFILE_DISPLAY_FLUSH);
+}
+#endif
+
+/* number of flushes started since power-up */
+uint32_t display_get_flush_count(void)
+{
+	return flush_count;
+}
@@ -0,0 +1,122 @@
+/*
+ * events.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "main.h"
+#include "events.h"
+
+/*
+ * Main loop sleep ... interrupt handlers post event bits, the main loop takes them at the top of a pass, and
+ * when a pass found nothing to do it calls events_wait(). The check for posted events and the WFI happen with
+ * interrupts masked, so an event posted after the pass looked at its source can't be slept through (WFI still
+ * wakes on the pending interrupt, the handler runs once interrupts are unmasked).
+ *
+ * Time spent in WFI is measured with the DWT cycle counter (enabled by scheduler_init()) and reported as an
+ * idle percentage per EVENTS_IDLE_WINDOW_MS. The core clock (and so CYCCNT) only keeps running through WFI
+ * because debug-in-sleep is set in events_init() ... clearing it would save a little more power and leave
+ * the idle figure at 0. Host builds may substitute the cycle counter, the sleep and the
+ * interrupt masking to drive this from a simulated interrupt source.
+ */
+
+#ifndef EVENTS_CYCLE_COUNT
+#define EVENTS_CYCLE_COUNT()	(DWT->CYCCNT)
+#endif
+
+#ifndef EVENTS_SLEEP
+#define EVENTS_SLEEP()			__WFI()
+#endif
+
+#define EVENTS_COUNT	(sizeof(((EventStats *)0)->posted) / sizeof(uint32_t))
+
+static volatile uint32_t pending_events = 0;
+static volatile uint32_t posted[EVENTS_COUNT];
+static uint32_t sleeps = 0;
+static uint32_t window_start;		/* cycle count at start of current idle window */
+static uint32_t window_idle;		/* cycles asleep in current window */
+static uint16_t idle_permille = 0;	/* last complete window */
+
+/* close idle window once it is EVENTS_IDLE_WINDOW_MS long ... main loop only */
+static void events_update_idle(void)
+{
+	uint32_t elapsed = EVENTS_CYCLE_COUNT() - window_start;
+
+	if(elapsed < (SystemCoreClock / 1000u) * EVENTS_IDLE_WINDOW_MS)
+		return;
+	idle_permille = (uint16_t)(((uint64_t)window_idle * 1000u) / elapsed);
+	window_start += elapsed;
+	window_idle = 0;
+}
+
+void events_init(void)
+{
+	pending_events = 0;
+	for(uint8_t i = 0; i < EVENTS_COUNT; i++)
+		posted[i] = 0;
+	sleeps = 0;
+	idle_permille = 0;
+	window_idle = 0;
+	window_start = EVENTS_CYCLE_COUNT();
+
+	HAL_DBGMCU_EnableDBGSleepMode(); /* keep debugger connected while core sleeps in WFI */
+}
+
+/* interrupt handlers (or main loop) ... safe against nesting, handlers of different priority may post */
+void events_post(uint32_t events)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	pending_events |= events;
+	for(uint8_t i = 0; i < EVENTS_COUNT; i++)
+	{
+		if(events & (1u << i))
+			posted[i]++;
+	}
+	__set_PRIMASK(primask);
+}
+
+uint32_t events_take(void)
+{
+	uint32_t events;
+
+	__disable_irq();
+	events = pending_events;
+	pending_events = 0;
+	__enable_irq();
+
+	events_update_idle();
+	return events;
+}
+
+/* nothing left to do in this pass ... sleep unless something was posted since the last take */
+uint32_t events_wait(void)
+{
+	__disable_irq();
+	if(0 == pending_events)
+	{
+		uint32_t start = EVENTS_CYCLE_COUNT();
+		EVENTS_SLEEP();
+		window_idle += EVENTS_CYCLE_COUNT() - start; /* handler that woke us hasn't run yet, not counted as idle */
+		sleeps++;
+	}
+	__enable_irq();
+
+	return events_take();
+}
+
+/* idle time of last complete window in 1/10 % */
+uint16_t events_get_idle_permille(void)
+{
+	return idle_permille;
+}
+
+void events_get_stats(EventStats *stats)
+{
+	stats->idle_permille = idle_permille;
+	stats->sleeps = sleeps;
+	for(uint8_t i = 0; i < EVENTS_COUNT; i++)
+		stats->posted[i] = posted[i];
+}
@@ -0,0 +1,120 @@
+/*
+ * history.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "history.h"
+
+#if HISTORY_USE_COMPRESSED
+static const HistoryBackend *backend = &history_compressed_backend;
+#else
+static const HistoryBackend *backend = &history_sram_backend;
+#endif
+static uint32_t capacity = 0;
+
+/* select storage backend and start with an empty history ... returns capacity in records */
+uint32_t history_init(const HistoryBackend *new_backend)
+{
+	if(new_backend != NULL)
+		backend = new_backend;
+	capacity = backend->reset();
+
+	return capacity;
+}
+
+/* copy assembled midi packet into history, returns sequence number assigned to the record */
+uint32_t history_append(const stc_midi *ptr_packet)
+{
+	stc_midi_history record;
+	uint32_t sequence = backend->next();
+
+	record.running_status = ptr_packet->running_status;
+	record.data[0] = ptr_packet->data[0];
+	record.data[1] = ptr_packet->data[1];
+	record.time_stamp = ptr_packet->time_stamp;
+	record.channel = ptr_packet->channel;
+	backend->append(&record);
+
+	return sequence;
+}
+
+bool history_read(uint32_t sequence, stc_midi_history *record)
+{
+	return backend->read(sequence, record);
+}
+
+uint32_t history_oldest(void)
+{
+	return backend->oldest();
+}
+
+/* only meaningful when history_count() != 0 */
+uint32_t history_newest(void)
+{
+	return backend->next() - 1;
+}
+
+uint32_t history_count(void)
+{
+	return backend->next() - backend->oldest();
+}
+
+/* total number of records appended since history_init() (retained or not) */
+uint32_t history_total(void)
+{
+	return backend->next();
+}
+
+uint32_t history_capacity(void)
+{
+	return capacity;
+}
+
+void history_evict_before(uint32_t sequence)
+{
+	backend->evict_before(sequence);
+}
+
+/*
+ * binary search for record nearest to time (base + offset_ms) ... O(log n) reads
+ * timestamps are non-decreasing within a session, comparing offsets from base (session start) keeps the
+ * search valid across HAL tick rollover, history_init() at session restart discards the previous session
+ */
+uint32_t history_find_time(uint32_t base, uint32_t offset_ms)
+{
+	stc_midi_history record;
+	uint32_t low = backend->oldest(), high = backend->next();
+	uint32_t oldest = low, next = high;
+
+	if(low == high) /* history is empty */
+		return low;
+
+	while(low != high) /* find first record at or after offset_ms */
+	{
+		uint32_t middle = low + (high - low) / 2;
+
+		backend->read(middle, &record);
+		if(record.time_stamp - base < offset_ms)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	if(low == next) /* offset_ms is after newest record */
+		return next - 1;
+	if(low != oldest) /* pick closer of first record at/after offset_ms and its predecessor */
+	{
+		uint32_t after_offset, before_offset;
+
+		backend->read(low, &record);
+		after_offset = record.time_stamp - base;
+		backend->read(low - 1, &record);
+		before_offset = record.time_stamp - base;
+		if(offset_ms - before_offset < after_offset - offset_ms)
+			return low - 1;
+	}
+
+	return low;
+}
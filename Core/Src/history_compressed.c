@@ -0,0 +1,242 @@
+/*
+ * history_compressed.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "string.h"
+#include "history.h"
+
+#if HISTORY_USE_COMPRESSED
+
+/*
+ * Compressed history backend ... same SRAM budget as the SRAM ring, several times the records.
+ *
+ * Records are stored in a byte ring as blocks of HISTORY_KEYFRAME_INTERVAL records. The first record
+ * of a block is a keyframe (full status byte + absolute timestamp) so any block can be decoded on its
+ * own. The other records are delta-encoded:
+ *
+ *   keyframe: [status] [data1] [data2]* [timestamp, 4 bytes little endian]
+ *   delta:    [flag|data1] [status]** [data2]* [time delta, varint (7 bits/byte, LSB first)]
+ *
+ *   *  only for 2-byte messages (everything except program change / channel pressure)
+ *   ** only when status differs from previous record (flag = bit 7 of first byte ... data bytes are 7-bit)
+ *
+ * The channel is not stored, it is recovered from the status byte. Oldest whole blocks are evicted when
+ * the ring runs out of room. Reads decode a whole block into a small cache, so painting a screen of
+ * neighboring records costs one block decode.
+ */
+
+#define HISTORY_COMPRESSED_BYTES	(NUMBER_PAGES * sizeof(stc_midi_history))	/* same SRAM footprint as SRAM ring */
+#define HISTORY_COMPRESSED_MASK		(HISTORY_COMPRESSED_BYTES - 1)
+#define HISTORY_MAX_RECORD_BYTES	(8u)		/* delta record: flag/data1 + status + data2 + 5 byte varint */
+#define HISTORY_MIN_BLOCK_BYTES		(4u + 2u * HISTORY_KEYFRAME_INTERVAL)	/* 1-byte messages, small deltas */
+#define HISTORY_MAX_BLOCKS			(HISTORY_COMPRESSED_BYTES / HISTORY_MIN_BLOCK_BYTES + 1)
+#define HISTORY_STATUS_FLAG			(0x80u)
+
+_Static_assert((HISTORY_COMPRESSED_BYTES & HISTORY_COMPRESSED_MASK) == 0, "compressed history size must be a power of two");
+
+static uint8_t history_bytes[HISTORY_COMPRESSED_BYTES];
+static uint16_t block_offset[HISTORY_MAX_BLOCKS];	/* ring of block start offsets, oldest block at block_first */
+static uint16_t block_first = 0;
+static uint16_t block_count = 0;
+static uint32_t head = 0;					/* free-running write offset (masked on access) */
+static uint32_t tail = 0;					/* free-running offset of oldest block */
+static uint32_t first_block_sequence = 0;	/* sequence number of first record in oldest block */
+static uint32_t oldest_sequence = 0;		/* oldest readable record (may be inside oldest block after evict_before) */
+static uint32_t next_sequence = 0;
+
+/* encoder state (previous record) */
+static uint8_t last_status = 0;
+static uint32_t last_time_stamp = 0;
+
+/* decoded block cache */
+static stc_midi_history block_cache[HISTORY_KEYFRAME_INTERVAL];
+static uint32_t cached_block_sequence = 0;
+static uint8_t cached_block_records = 0;	/* 0 = cache empty */
+
+static bool has_two_data_bytes(uint8_t status)
+{
+	return !((status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0);
+}
+
+static void put_byte(uint8_t byte)
+{
+	history_bytes[head++ & HISTORY_COMPRESSED_MASK] = byte;
+}
+
+static uint8_t get_byte(uint32_t *offset)
+{
+	return history_bytes[(*offset)++ & HISTORY_COMPRESSED_MASK];
+}
+
+static void evict_oldest_block(void)
+{
+	block_first = (block_first + 1) % HISTORY_MAX_BLOCKS;
+	block_count--;
+	first_block_sequence += HISTORY_KEYFRAME_INTERVAL;
+	tail = (block_count != 0) ? tail + ((block_offset[block_first] - tail) & HISTORY_COMPRESSED_MASK) : head;
+	if((int32_t)(oldest_sequence - first_block_sequence) < 0)
+		oldest_sequence = first_block_sequence;
+	cached_block_records = 0;
+}
+
+static uint32_t compressed_reset(void)
+{
+	head = tail = 0;
+	block_first = block_count = 0;
+	first_block_sequence = oldest_sequence = next_sequence = 0;
+	last_status = 0;
+	last_time_stamp = 0;
+	cached_block_records = 0;
+
+	/* nominal capacity ... running status note messages with small time deltas take 3 bytes */
+	return HISTORY_COMPRESSED_BYTES / 3;
+}
+
+static void compressed_append(const stc_midi_history *record)
+{
+	bool is_keyframe = (0 == next_sequence % HISTORY_KEYFRAME_INTERVAL);
+
+	/* make room for worst case record, and a new block descriptor if needed (never evict the block being appended to) */
+	while(block_count > (is_keyframe ? 0 : 1) &&(HISTORY_COMPRESSED_BYTES - (head - tail) < HISTORY_MAX_RECORD_BYTES || (is_keyframe && block_count >= HISTORY_MAX_BLOCKS)))
+		evict_oldest_block();
+
+	if(is_keyframe)
+	{
+		block_offset[(block_first + block_count) % HISTORY_MAX_BLOCKS] = head & HISTORY_COMPRESSED_MASK;
+		block_count++;
+		put_byte(record->running_status);
+		put_byte(record->data[0]);
+		if(has_two_data_bytes(record->running_status))
+			put_byte(record->data[1]);
+		for(uint8_t i = 0; i < 4; i++)
+			put_byte(record->time_stamp >> (8 * i));
+	}
+	else
+	{
+		uint32_t delta = record->time_stamp - last_time_stamp;
+
+		if(record->running_status != last_status)
+		{
+			put_byte(HISTORY_STATUS_FLAG | record->data[0]);
+			put_byte(record->running_status);
+		}
+		else
+		{
+			put_byte(record->data[0]);
+		}
+		if(has_two_data_bytes(record->running_status))
+			put_byte(record->data[1]);
+		do
+		{
+			put_byte((delta & 0x7F) | (delta > 0x7F ? 0x80 : 0x00));
+			delta >>= 7;
+		} while(delta != 0);
+	}
+
+	last_status = record->running_status;
+	last_time_stamp = record->time_stamp;
+	/* invalidate cache if it holds the block being appended to */
+	if(cached_block_records != 0 && next_sequence - cached_block_sequence < HISTORY_KEYFRAME_INTERVAL)
+		cached_block_records = 0;
+	next_sequence++;
+}
+
+/* decode every record of block (relative to oldest block) into block_cache */
+static void decode_block(uint16_t block)
+{
+	uint32_t offset = block_offset[(block_first + block) % HISTORY_MAX_BLOCKS];
+	uint32_t sequence = first_block_sequence + (uint32_t)block * HISTORY_KEYFRAME_INTERVAL;
+	uint8_t records = (next_sequence - sequence < HISTORY_KEYFRAME_INTERVAL) ? next_sequence - sequence : HISTORY_KEYFRAME_INTERVAL;
+	uint8_t status = 0;
+	uint32_t time_stamp = 0;
+
+	for(uint8_t i = 0; i < records; i++)
+	{
+		stc_midi_history *record = &block_cache[i];
+
+		if(0 == i)
+		{
+			status = get_byte(&offset);
+			record->data[0] = get_byte(&offset);
+			record->data[1] = has_two_data_bytes(status) ? get_byte(&offset) : 0;
+			time_stamp = 0;
+			for(uint8_t b = 0; b < 4; b++)
+				time_stamp |= (uint32_t)get_byte(&offset) << (8 * b);
+		}
+		else
+		{
+			uint8_t first = get_byte(&offset);
+			uint32_t delta = 0;
+			uint8_t shift = 0;
+			uint8_t byte;
+
+			if(first & HISTORY_STATUS_FLAG)
+				status = get_byte(&offset);
+			record->data[0] = first & 0x7F;
+			record->data[1] = has_two_data_bytes(status) ? get_byte(&offset) : 0;
+			do
+			{
+				byte = get_byte(&offset);
+				delta |= (uint32_t)(byte & 0x7F) << shift;
+				shift += 7;
+			} while(byte & 0x80);
+			time_stamp += delta;
+		}
+		record->running_status = status;
+		record->time_stamp = time_stamp;
+		record->channel = (status & 0x0F) + 1; /* MIDI channels are 1–16 */
+	}
+
+	cached_block_sequence = sequence;
+	cached_block_records = records;
+}
+
+static bool compressed_read(uint32_t sequence, stc_midi_history *record)
+{
+	if(sequence - oldest_sequence >= next_sequence - oldest_sequence) /* outside [oldest, next) */
+		return false;
+
+	if(0 == cached_block_records || sequence - cached_block_sequence >= cached_block_records)
+		decode_block((sequence - first_block_sequence) / HISTORY_KEYFRAME_INTERVAL);
+
+	*record = block_cache[sequence - cached_block_sequence];
+	return true;
+}
+
+static uint32_t compressed_oldest(void)
+{
+	return oldest_sequence;
+}
+
+static uint32_t compressed_next(void)
+{
+	return next_sequence;
+}
+
+static void compressed_evict_before(uint32_t sequence)
+{
+	if((int32_t)(sequence - oldest_sequence) <= 0) /* already evicted */
+		return;
+	if((int32_t)(sequence - next_sequence) > 0) /* clamp to newest + 1 (empty history) */
+		sequence = next_sequence;
+	oldest_sequence = sequence;
+
+	/* release storage of whole blocks (current block is kept, it holds the encoder state) */
+	while(block_count > 1 && sequence - first_block_sequence >= HISTORY_KEYFRAME_INTERVAL)
+		evict_oldest_block();
+}
+
+const HistoryBackend history_compressed_backend = {
+	"Compressed",
+	compressed_reset,
+	compressed_append,
+	compressed_read,
+	compressed_oldest,
+	compressed_next,
+	compressed_evict_before
+};
+
+#endif /* HISTORY_USE_COMPRESSED */
@@ -0,0 +1,74 @@
+/*
+ * history_sram.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "history.h"
+
+/*
+ * SRAM ring backend ... fixed array of NUMBER_PAGES records, newest record overwrites oldest
+ * once the ring is full. Record for a sequence number lives in slot (sequence & HISTORY_SRAM_MASK),
+ * so the free-running 32-bit sequence counter can wrap without disturbing the slot mapping.
+ */
+
+_Static_assert((NUMBER_PAGES & (NUMBER_PAGES - 1)) == 0, "NUMBER_PAGES must be a power of two");
+#define HISTORY_SRAM_MASK	(NUMBER_PAGES - 1)
+
+static stc_midi_history midi_history[NUMBER_PAGES]; /* declare history array */
+static uint32_t next_sequence = 0;
+static uint32_t oldest_sequence = 0;
+
+static uint32_t sram_reset(void)
+{
+	next_sequence = 0;
+	oldest_sequence = 0;
+
+	return sizeof(midi_history) / sizeof(stc_midi_history); /* confirm total number of elements */
+}
+
+static void sram_append(const stc_midi_history *record)
+{
+	midi_history[next_sequence & HISTORY_SRAM_MASK] = *record;
+	next_sequence++;
+	if(next_sequence - oldest_sequence > NUMBER_PAGES) /* check for circular rollover ... oldest record was overwritten */
+		oldest_sequence = next_sequence - NUMBER_PAGES;
+}
+
+static bool sram_read(uint32_t sequence, stc_midi_history *record)
+{
+	if(sequence - oldest_sequence >= next_sequence - oldest_sequence) /* outside [oldest, next) */
+		return false;
+	*record = midi_history[sequence & HISTORY_SRAM_MASK];
+	return true;
+}
+
+static uint32_t sram_oldest(void)
+{
+	return oldest_sequence;
+}
+
+static uint32_t sram_next(void)
+{
+	return next_sequence;
+}
+
+static void sram_evict_before(uint32_t sequence)
+{
+	if((int32_t)(sequence - oldest_sequence) <= 0) /* already evicted */
+		return;
+	if((int32_t)(sequence - next_sequence) > 0) /* clamp to newest + 1 (empty history) */
+		sequence = next_sequence;
+	oldest_sequence = sequence;
+}
+
+const HistoryBackend history_sram_backend = {
+	"SRAM",
+	sram_reset,
+	sram_append,
+	sram_read,
+	sram_oldest,
+	sram_next,
+	sram_evict_before
+};
@@ -0,0 +1,131 @@
+/*
+ * loop_monitor.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "main.h"
+#include "loop_monitor.h"
+#include "profile.h"
+#include "scheduler.h"
+#include "display.h"
+
+/*
+ * Main loop pass time ... from the top of the pass to just before it sleeps, so WFI time is not counted. The
+ * gap between two looks at rxFIFO is what decides whether it overflows, blocking I2C and printf make it grow.
+ *
+ * Every pass goes into the PROFILE_MAIN_LOOP histogram (console 'p'), the longest is kept with the stage that
+ * took most of it, the task that ran and the FIFO fill (console 'l'). A pass over LOOP_STALL_THRESHOLD_MS puts
+ * '!' on the status line for LOOP_STALL_FLAG_MS. Per pass that is a few cycle counter reads and compares,
+ * cheap enough to leave on.
+ */
+
+static const char *const stage_names[LOOP_STAGE_COUNT] = {
+	"midi fifo",
+	"midi packet",
+	"task",
+	"display",
+	"console",
+};
+
+static uint32_t pass_start;
+static uint32_t stage_start;
+static uint32_t pass_stage_cycles;		/* longest stage of current pass */
+static LoopStage pass_stage;
+static const char *pass_task;			/* task run in current pass (NULL = none) */
+static uint32_t stall_threshold_cycles;
+static LoopMonitorStats monitor;
+static uint32_t last_stall_ms;
+static bool is_flag_shown = false;
+
+extern volatile uint16_t fifo_count;
+
+void loop_monitor_reset(void)
+{
+	monitor = (LoopMonitorStats){ 0 };
+}
+
+void loop_monitor_init(void)
+{
+	stall_threshold_cycles = (SystemCoreClock / 1000u) * LOOP_STALL_THRESHOLD_MS;
+	is_flag_shown = false;
+	loop_monitor_reset();
+}
+
+void loop_monitor_begin(void)
+{
+	pass_start = PROFILE_CYCLES();
+	stage_start = pass_start;
+	pass_stage_cycles = 0;
+	pass_stage = LOOP_STAGE_MIDI_FIFO;
+	pass_task = NULL;
+}
+
+/* scheduler_dispatch() ran a task this pass ... kept with the pass whichever stage took longest */
+void loop_monitor_task_ran(void)
+{
+	pass_task = scheduler_get_last_task_name();
+}
+
+/* stage just finished ... time since the previous mark (or begin) is its */
+void loop_monitor_mark(LoopStage stage)
+{
+	uint32_t now = PROFILE_CYCLES();
+	uint32_t cycles = now - stage_start;
+
+	stage_start = now;
+	if(cycles > pass_stage_cycles)
+	{
+		pass_stage_cycles = cycles;
+		pass_stage = stage;
+	}
+}
+
+void loop_monitor_end(void)
+{
+	uint32_t cycles = PROFILE_CYCLES() - pass_start;
+	uint32_t now_ms = HAL_GetTick();
+
+	profile_record(PROFILE_MAIN_LOOP, cycles);
+	monitor.passes++;
+
+	if(cycles > monitor.longest.cycles)
+	{
+		monitor.longest = (LoopStall){
+			.cycles = cycles,
+			.stage_cycles = pass_stage_cycles,
+			.stage = pass_stage,
+			.task = pass_task,
+			.fifo_count = fifo_count,
+			.app_state = app_get_state(),
+			.time_ms = now_ms,
+		};
+	}
+
+	if(cycles > stall_threshold_cycles)
+	{
+		monitor.stalls++;
+		last_stall_ms = now_ms;
+		if(false == is_flag_shown)
+		{
+			is_flag_shown = true;
+			display_stall_flag(true);
+		}
+	}
+	else if(is_flag_shown && now_ms - last_stall_ms > LOOP_STALL_FLAG_MS)
+	{
+		is_flag_shown = false;
+		display_stall_flag(false);
+	}
+}
+
+void loop_monitor_get_stats(LoopMonitorStats *stats)
+{
+	*stats = monitor;
+}
+
+const char* loop_monitor_stage_name(LoopStage stage)
+{
+	return (stage < LOOP_STAGE_COUNT) ? stage_names[stage] : "?";
+}
@@ -31,6 +31,14 @@
 #include "midi.h"
 #include "app_state_machine.h"
 #include "ui.h"
+#include "trigger.h"
+#include "console.h"
+#include "events.h"
+#include "timebase.h"
+#include "profile.h"
+#include "loop_monitor.h"
+#include "ram_monitor.h"
+#include "ram_budget.h"
 
 /* USER CODE END Includes */
 
@@ -41,6 +49,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define FIFO_TIMESTAMP_MASK		(0x00FFFFFFu) /* rxFIFO stores 24-bit byte timestamps */
 
 /* USER CODE END PD */
 
@@ -51,6 +60,7 @@
 
 /* Private variables ---------------------------------------------------------*/
 I2C_HandleTypeDef hi2c1;
+DMA_HandleTypeDef hdma_i2c1_tx;
 
 TIM_HandleTypeDef htim2;
 TIM_HandleTypeDef htim3;
@@ -60,9 +70,9 @@ UART_HandleTypeDef huart1;
 UART_HandleTypeDef huart2;
 
 /* USER CODE BEGIN PV */
-volatile uint32_t ms_counter = 0;
-
 volatile uint16_t fifo_count = 0; /* FIFO utilization */
+volatile uint32_t midi_armed_ms = 0, midi_first_byte_ms = 0; /* when capture started, when first byte arrived */
+volatile bool is_midi_first_byte = false; /* first byte since power-on received */
 uint8_t rxBuffer[80]; /* may not be necessary, single variable may be enough ... needs testing */
 volatile uint16_t headPointer = 0, tailPointer = 0; /* FIFO head and tail pointers */
 
@@ -72,17 +82,18 @@ typedef struct __attribute__((packed)) {
 	uint32_t byte_timestamp : 24;
 } rxData;
 volatile rxData rxFIFO[UART_FIFO_SIZE]; /* Rx FIFO ... no rollover protection, older characters overwritten if FIFO fills */
+_Static_assert(sizeof(rxData) == RAM_FIFO_ENTRY_BYTES, "rxData size differs from SRAM budget (ram_budget.h)");
 
 volatile uint32_t midi_timestamp = 0, midi_delta_timestamp = 0;
 uint16_t newest_message_encoder_value; /* encoder value for newest message ... will be used to automatically switch from SCROLL to LIVE mode */
 stc_midi *ptr_packet;
-volatile bool timeoutFlag = false;
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_I2C1_Init(void);
 static void MX_USART1_UART_Init(void);
 static void MX_TIM2_Init(void);
@@ -112,6 +123,12 @@ int main(void)
   /* USER CODE BEGIN 1 */
   uint8_t rx_data;
   uint32_t rx_data_timestamp;
+  uint32_t now;
+  bool is_backlogged;
+  bool is_busy;
+  uint32_t wakeup;
+
+  ram_monitor_paint(); /* stack high-water ... paint free RAM before any interrupt can use the stack */
 
   /* USER CODE END 1 */
 
@@ -134,6 +151,7 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_I2C1_Init();
   MX_USART1_UART_Init();
   MX_TIM2_Init();
@@ -142,29 +160,33 @@ int main(void)
   MX_TIM4_Init();
   /* USER CODE BEGIN 2 */
 
-  display_init();
-  display_splash_screen();
+  /* start MIDI capture first ... bytes wait in rxFIFO (timestamped) until the main loop drains them */
+  midi_armed_ms = HAL_GetTick();
+  HAL_UART_Receive_IT(&huart1, rxBuffer, 1); /* start UART in interrupt mode */
 
-  HAL_Delay(5000);
+  timebase_init(); /* TIM4 time base ... SysTick stopped when tickless */
 
-  /* initialize OLED display and paint opening UI screens */
-  display_start_screen();
+  display_init();
 
   // Start the encoder interfaces (TIM2 - scroll encoder, TIM3 - channel filter encoder)
   HAL_TIM_Encoder_Start(&htim2, TIM_CHANNEL_ALL);
   HAL_TIM_Encoder_Start(&htim3, TIM_CHANNEL_ALL);
 
-  __HAL_TIM_CLEAR_IT(&htim4, TIM_FLAG_UPDATE);
-
   scheduler_init();
+  events_init();
   tasks_init();
+  trigger_init();
+  console_init();
+  loop_monitor_init();
 
   printf("\r\n\n---- Application started. -------\r\n");
   printf("Number of history elements initialized = %d\r\n", ui_initialize_ui());
   printf("Number of OLED display lines = %d\r\n", SSD1306_HEIGHT / DISPLAY_DEFAULT_FONT.height - 1);
 
-  HAL_UART_Receive_IT(&huart1, rxBuffer, 1); /* start UART in interrupt mode */
-  printf("MIDI UART started.\r\n\n");
+  printf("MIDI UART started at %lu ms, %u bytes waiting.\r\n\n", (unsigned long)midi_armed_ms, fifo_count);
+
+  /* splash screen without blocking ... main loop runs, captured packets go to history until it ends */
+  ui_show_splash();
 
   newest_message_encoder_value = __HAL_TIM_GetCounter(&htim2); /* get current scroll encoder value */
 
@@ -174,10 +196,18 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
+	  /* events posted from here on end the sleep at the bottom of this pass early */
+	  events_take();
+	  is_busy = false;
+	  loop_monitor_begin(); /* pass time, stage of longest pass, stall flag on status line */
+
 	  /* check rxFIFO for incoming characters */
 	  if(0 != fifo_count) /* if true, new data is available */
 	  {
-		  rx_data_timestamp = rxFIFO[tailPointer].byte_timestamp; /* retrieve timestamp from FIFO */
+		  is_busy = true;
+		  /* retrieve timestamp from FIFO ... extend 24-bit timestamp back to 32 bits (byte can't be ~4.6 hours old) */
+		  now = HAL_GetTick();
+		  rx_data_timestamp = now - ((now - rxFIFO[tailPointer].byte_timestamp) & FIFO_TIMESTAMP_MASK);
 		  rx_data = rxFIFO[tailPointer++].rx_byte; /* retrieve new character from FIFO */
 		  fifo_count--;
 		  if(tailPointer >= UART_FIFO_SIZE) /* manage FIFO pointer rollover */
@@ -185,17 +215,49 @@ int main(void)
 
 		  ptr_packet = midi_build_packet(rx_data, rx_data_timestamp); /* build full 3-byte packets, save pointer for later use */
 	  }
+	  loop_monitor_mark(LOOP_STAGE_MIDI_FIFO);
 
 	  if(midi_isPacketAvailable())
 	  {
 	      /* hand packet to ui for processing */
 		  ui_process_midi_packet(ptr_packet);
+		  is_busy = true;
 	  }
+	  loop_monitor_mark(LOOP_STAGE_MIDI_PACKET);
 
-	  if(true == timeoutFlag)
+	  /* MIDI backlog ... FIFO draining and parsing preempt UI work, only high priority tasks run until it clears */
+	  is_backlogged = (fifo_count > UART_FIFO_BACKLOG_THRESHOLD);
+
+	  /* run one ready task (encoders, buttons, heartbeat, scroll fill timer) ... blocking I2C/printf stay out of SysTick */
+	  if(scheduler_dispatch(is_backlogged ? TASK_PRIORITY_HIGH : TASK_PRIORITY_LOW))
+	  {
+		  is_busy = true;
+		  loop_monitor_task_ran();
+	  }
+	  loop_monitor_mark(LOOP_STAGE_TASK);
+
+	  /* start next transfer of a frame on the bus (never from the completion interrupt), then send everything drawn
+	   * since last flush ... one coalesced frame, rate limited to DISPLAY_FRAME_INTERVAL_MS */
+	  if(display_service())
+		  is_busy = true;
+	  if(false == is_backlogged)
+		  display_present();
+	  loop_monitor_mark(LOOP_STAGE_DISPLAY);
+
+	  /* single key debug commands on console UART (h for help) */
+	  console_poll();
+	  loop_monitor_mark(LOOP_STAGE_CONSOLE);
+	  loop_monitor_end();
+
+	  /* nothing done this pass ... sleep (WFI) until an interrupt posts an event, idle time measured for console */
+	  if(false == is_busy)
 	  {
-		  ui_fill_display();
-		  timeoutFlag = false; /* clear the timer timeout interrupt flag */
+		  /* tickless ... make sure the next deadline and next display frame wake the core */
+		  if(scheduler_get_next_deadline(&wakeup))
+			  timebase_request_wakeup(wakeup);
+		  if(display_get_present_time(&wakeup))
+			  timebase_request_wakeup(wakeup);
+		  events_wait();
 	  }
 
     /* USER CODE END WHILE */
@@ -388,18 +450,24 @@ static void MX_TIM4_Init(void)
 
   /* USER CODE END TIM4_Init 0 */
 
+  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
   TIM_MasterConfigTypeDef sMasterConfig = {0};
 
   /* USER CODE BEGIN TIM4_Init 1 */
 
   /* USER CODE END TIM4_Init 1 */
   htim4.Instance = TIM4;
-  htim4.Init.Prescaler = 64800 -1;
+  htim4.Init.Prescaler = 36000-1;
   htim4.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim4.Init.Period = 500 - 1;
+  htim4.Init.Period = 65535;
   htim4.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
   htim4.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
-  if (HAL_TIM_OnePulse_Init(&htim4, TIM_OPMODE_SINGLE) != HAL_OK)
+  if (HAL_TIM_Base_Init(&htim4) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
+  if (HAL_TIM_ConfigClockSource(&htim4, &sClockSourceConfig) != HAL_OK)
   {
     Error_Handler();
   }
@@ -410,6 +478,7 @@ static void MX_TIM4_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN TIM4_Init 2 */
+  /* TIMEBASE_TICK_HZ from the 72 MHz timer clock, 16-bit free-running ... timebase_init() starts it */
 
   /* USER CODE END TIM4_Init 2 */
 
@@ -481,6 +550,22 @@ static void MX_USART2_UART_Init(void)
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Channel6_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -527,9 +612,9 @@ static void MX_GPIO_Init(void)
 
 /* USER CODE BEGIN 4 */
 
+/* 1 kHz time base and scheduler tick (TIMEBASE_USE_TICKLESS 0) ... SysTick is stopped in tickless mode */
 void HAL_SYSTICK_Callback(void) {
-    ms_counter++;
-    run_scheduled_tasks();
+    timebase_tick();
 }
 
 int __io_putchar(int ch) {
@@ -541,6 +626,7 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
 	if (huart->Instance == USART1)
 	{
+		PROFILE_BEGIN(PROFILE_UART_RX_ISR);
 		fifo_count++;
 		if(fifo_count > UART_FIFO_SIZE) /* check for FIFO rollover */
 		{
@@ -549,6 +635,11 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 		}
 		rxFIFO[headPointer].byte_timestamp = HAL_GetTick(); /* timestamp received byte */
 		rxFIFO[headPointer++].rx_byte = rxBuffer[0]; /* place received character from UART in FIFO */
+		if(false == is_midi_first_byte) /* time to first captured byte ... console i */
+		{
+			midi_first_byte_ms = HAL_GetTick();
+			is_midi_first_byte = true;
+		}
 
 //		HAL_UART_Transmit(&huart2, rxBuffer, 1, HAL_MAX_DELAY); /* echo raw data to console */
 
@@ -556,24 +647,29 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 			headPointer = 0;
 
 		HAL_UART_Receive_IT(&huart1, rxBuffer, 1); /* restart UART Rx interrupt */
+		events_post(EVENT_MIDI_RX); /* wake main loop */
+		PROFILE_END(PROFILE_UART_RX_ISR);
 	}
 }
 
-/**
-  * TIM4 - time-out timer
-  *
-  * @brief  Period elapsed callback in non blocking mode
-  * @param  htim : TIM handle
-  * @retval None
-  */
-void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+/* OLED DMA flush ... transfer done, main loop starts the next one (display_service()) */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
-	if(htim->Instance == TIM4)
+	if(hi2c->Instance == I2C1)
 	{
-		timeoutFlag = true; /* set timeOut flag to indicate scroll screen should be updated */
-		HAL_TIM_Base_Stop_IT(htim);
+		ssd1306_TxCpltCallback();
+		events_post(EVENT_DISPLAY); /* wake main loop */
 	}
+}
 
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	if(hi2c->Instance == I2C1)
+	{
+		ssd1306_TxErrorCallback();
+		if(!ssd1306_IsBusy()) /* frame finished ... main loop may start the next one */
+			events_post(EVENT_DISPLAY);
+	}
 }
 
 /* USER CODE END 4 */
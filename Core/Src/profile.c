@@ -0,0 +1,104 @@
+/*
+ * profile.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "profile.h"
+
+#if defined(PROFILE_HOST)
+#include <time.h>
+extern uint32_t SystemCoreClock;
+#endif
+
+/*
+ * Execution time per instrumented region ... PROFILE_BEGIN()/PROFILE_END() around a task body, an interrupt
+ * callback or a driver call. Recording is a subtract, a few adds and a count-leading-zeros, cheap enough for
+ * the USART1 interrupt. Each region is recorded from one context only (its task or its interrupt), so the
+ * counters need no locking ... a report may catch a region mid-update, a reset masks interrupts.
+ *
+ * Times are in core cycles (DWT CYCCNT, 13.9 ns @ 72 MHz). Regions that sleep or wait on the I2C bus include
+ * the wait; interrupts taken inside a region are counted in it too.
+ */
+
+static const char *const profile_region_names[PROFILE_REGION_COUNT] = {
+	"heartbeat",
+	"read_encoders",
+	"poll_buttons",
+	"USART1 rx ISR",
+	"EXTI ISR",
+	"TIM4 ISR",
+	"UpdateScreen",
+	"main loop pass",
+};
+
+typedef struct {
+	uint32_t count;
+	uint32_t min_cycles;
+	uint32_t max_cycles;
+	uint64_t total_cycles;
+	uint32_t histogram[PROFILE_HISTOGRAM_BINS];
+} ProfileRegionData;
+
+static ProfileRegionData regions[PROFILE_REGION_COUNT];
+
+#if defined(PROFILE_HOST)
+/* simulator stand-in for CYCCNT ... monotonic clock in core cycles, wraps like the real counter */
+uint32_t profile_host_cycles(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec) * (SystemCoreClock / 1000000u) / 1000u);
+}
+#endif
+
+void profile_reset(void)
+{
+#if !defined(PROFILE_HOST)
+	__disable_irq();
+#endif
+	for(uint8_t i = 0; i < PROFILE_REGION_COUNT; i++)
+	{
+		regions[i] = (ProfileRegionData){ 0 };
+	}
+#if !defined(PROFILE_HOST)
+	__enable_irq();
+#endif
+}
+
+void profile_record(ProfileRegion region, uint32_t cycles)
+{
+	ProfileRegionData *data = &regions[region];
+	uint32_t bin = 31u - (uint32_t)__builtin_clz(cycles | 1u); /* floor(log2(cycles)) */
+
+	bin = (bin > PROFILE_HISTOGRAM_SHIFT) ? bin - PROFILE_HISTOGRAM_SHIFT : 0;
+	if(bin >= PROFILE_HISTOGRAM_BINS)
+		bin = PROFILE_HISTOGRAM_BINS - 1;
+
+	if(0 == data->count || cycles < data->min_cycles)
+		data->min_cycles = cycles;
+	data->count++;
+	data->total_cycles += cycles;
+	if(cycles > data->max_cycles)
+		data->max_cycles = cycles;
+	data->histogram[bin]++;
+}
+
+bool profile_get_stats(ProfileRegion region, ProfileStats *stats)
+{
+	if(region >= PROFILE_REGION_COUNT)
+		return false;
+
+	const ProfileRegionData *data = &regions[region];
+
+	stats->name = profile_region_names[region];
+	stats->count = data->count;
+	stats->min_cycles = data->min_cycles;
+	stats->max_cycles = data->max_cycles;
+	stats->total_cycles = data->total_cycles;
+	for(uint8_t i = 0; i < PROFILE_HISTOGRAM_BINS; i++)
+		stats->histogram[i] = data->histogram[i];
+	return true;
+}
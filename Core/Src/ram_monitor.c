@@ -0,0 +1,72 @@
+/*
+ * ram_monitor.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <stddef.h>
+#include "main.h"
+#include "ram_monitor.h"
+
+/*
+ * Stack painting ... at power-on the RAM between the end of the heap and the stack pointer is filled with
+ * RAM_MONITOR_PAINT. The stack grows down into it, so the lowest overwritten word marks the deepest the stack
+ * has been. Heap growth after painting also overwrites paint (from below), so the scan starts at the current
+ * heap end. Interrupt frames are pushed on the same stack (MSP) and are included.
+ *
+ *  ############################################################################
+ *  #  .data  #  .bss  #  heap ->  #   paint (free)   #   <- stack (used)     #
+ *  ############################################################################
+ *  ^-- _sdata        ^-- _end    ^-- _sbrk(0)       ^-- high water  _estack --^
+ */
+extern uint32_t _sdata, _edata, _sbss, _ebss, _end, _estack, _Min_Stack_Size; /* linker script symbols */
+void *_sbrk(ptrdiff_t incr);
+
+#define RAM_MONITOR_ORIGIN		(0x20000000u)
+
+static uint32_t *paint_start = NULL;	/* lowest painted word */
+static uint32_t *paint_end = NULL;		/* one past highest painted word */
+
+/* heap end rounded up to a word */
+static uint32_t* ram_monitor_heap_end(void)
+{
+	return (uint32_t*)(((uint32_t)_sbrk(0) + 3u) & ~3u);
+}
+
+/*
+ * call first thing in main() (USER CODE 1) ... before HAL_Init(), so no interrupt can push a frame below the
+ * stack pointer while it is being painted
+ */
+void ram_monitor_paint(void)
+{
+	uint32_t *p = ram_monitor_heap_end();
+
+	paint_start = p;
+	paint_end = (uint32_t*)((__get_MSP() - RAM_MONITOR_GUARD) & ~3u);
+	while(p < paint_end)
+		*p++ = RAM_MONITOR_PAINT;
+}
+
+void ram_monitor_get_stats(RamMonitorStats *stats)
+{
+	uint32_t *p = ram_monitor_heap_end();
+
+	stats->ram_size = (uint32_t)&_estack - RAM_MONITOR_ORIGIN;
+	stats->data_size = (uint32_t)&_edata - (uint32_t)&_sdata;
+	stats->bss_size = (uint32_t)&_ebss - (uint32_t)&_sbss;
+	stats->heap_size = (uint32_t)p - (uint32_t)&_end;
+	stats->stack_reserved = (uint32_t)&_Min_Stack_Size;
+	stats->is_painted = (NULL != paint_start);
+	stats->stack_high_water = 0;
+	stats->stack_free = 0;
+	if(false == stats->is_painted)
+		return;
+
+	if(p < paint_start)
+		p = paint_start;
+	while(p < paint_end && RAM_MONITOR_PAINT == *p) /* first disturbed word from below = deepest stack */
+		p++;
+	stats->stack_free = (uint32_t)p - (uint32_t)ram_monitor_heap_end();
+	stats->stack_high_water = (uint32_t)&_estack - (uint32_t)p;
+}
@@ -5,38 +5,376 @@
  *      Author: dwask
  */
 
+#include "main.h"
 #include "scheduler.h"
+#include "timebase.h"
 
-#define MAX_TASKS 8
+/* execution time source for budgets ... DWT cycle counter (host test builds may substitute their own) */
+#ifndef SCHEDULER_CYCLE_COUNT
+#define SCHEDULER_CYCLE_COUNT() (DWT->CYCCNT)
+#endif
 
+/* one slot per ms, one bit per slot in wheel_occupied ... must stay 64 */
+#define WHEEL_SLOTS     (64u)
+#define WHEEL_MASK      (WHEEL_SLOTS - 1u)
+
+/*
+ * SysTick marks tasks ready, the main loop runs them ... tasks may block (I2C, printf) without holding off
+ * HAL_IncTick() or the MIDI UART interrupt. Deadlines advance by interval from the previous deadline (not
+ * from when the task ran), so a late dispatch doesn't make the schedule drift.
+ *
+ * Cooperative, so a long task can't be cut short ... each run is timed with the DWT cycle counter against
+ * the task's budget, overruns are counted for the console report. One task per scheduler_dispatch() call,
+ * so the main loop drains the MIDI FIFO between tasks.
+ *
+ * Armed tasks and timers sit on a hashed timer wheel ... slot = deadline % WHEEL_SLOTS, a doubly linked list
+ * per slot. Start/stop link or unlink one entry (O(1)), the tick only walks the slot whose time has come and
+ * skips entries due in a later revolution. wheel_occupied has a bit per non-empty slot, so the distance to
+ * the next deadline is a rotate and count-trailing-zeros, and empty stretches are skipped in one step.
+ *
+ * The wheel belongs to the tick ... the main loop changes it with interrupts off (a few links, no loops).
+ * released is written by the tick only, dispatched by the main loop only ... no locking needed for those.
+ */
 typedef struct {
+    const char *name;
     TaskCallback callback;
-    uint32_t interval_ms;
-    uint32_t last_run;
+    TaskPriority priority;
+    uint32_t interval_ms;           // 0 = one-shot
+    bool is_armed;                  // linked into the wheel
+    uint32_t deadline;              // next deadline (timebase_get_ms()) while armed
+    TaskId next;                    // wheel slot list
+    TaskId prev;
+    volatile uint32_t due;          // deadline of oldest pending release (earliest deadline first)
+    volatile uint32_t released;     // deadlines reached
+    uint32_t dispatched;            // deadlines handled by a run (or counted as missed)
+    uint32_t budget_cycles;
+    uint32_t runs;
+    uint32_t missed;
+    uint32_t last_cycles;
+    uint32_t max_cycles;
+    uint32_t overruns;
 } Task;
 
 static Task task_list[MAX_TASKS];
-static uint8_t task_count = 0;
-extern volatile uint32_t ms_counter;
+static volatile uint16_t task_count = 0;
+static uint32_t missed = 0;         // deadlines dropped because the task was still waiting to run
+
+static TaskId wheel[WHEEL_SLOTS];   // head of each slot list
+static uint64_t wheel_occupied;     // bit n set = wheel[n] not empty
+static uint32_t wheel_time;         // last ms the wheel has been advanced to (may lag behind now when tickless)
+static volatile bool is_released;   // tick released something since dispatch last looked
+static TaskId last_run = SCHEDULER_NO_TASK;
+
+static uint32_t scheduler_cycles_per_us(void) {
+    return SystemCoreClock / 1000000u;
+}
+
+static void scheduler_link(TaskId id) {
+    Task *task = &task_list[id];
+    uint32_t slot = task->deadline & WHEEL_MASK;
+
+    task->prev = SCHEDULER_NO_TASK;
+    task->next = wheel[slot];
+    if (task->next != SCHEDULER_NO_TASK) {
+        task_list[task->next].prev = id;
+    }
+    wheel[slot] = id;
+    wheel_occupied |= (uint64_t)1 << slot;
+    task->is_armed = true;
+}
+
+static void scheduler_unlink(TaskId id) {
+    Task *task = &task_list[id];
+    uint32_t slot = task->deadline & WHEEL_MASK;
+
+    if (task->prev != SCHEDULER_NO_TASK) {
+        task_list[task->prev].next = task->next;
+    } else {
+        wheel[slot] = task->next;
+    }
+    if (task->next != SCHEDULER_NO_TASK) {
+        task_list[task->next].prev = task->prev;
+    }
+    if (wheel[slot] == SCHEDULER_NO_TASK) {
+        wheel_occupied &= ~((uint64_t)1 << slot);
+    }
+    task->is_armed = false;
+}
+
+/*
+ * put task on the wheel delay_ms from now ... a deadline is never in the past, 0 = next ms. Now, not wheel_time:
+ * tickless, the wheel is only advanced at deadlines. Any deadline after wheel_time is met exactly.
+ * The compare is requested here, not left to the main loop before it sleeps ... a busy loop never sleeps, and
+ * only the compare interrupt releases deadlines (no-op with the 1 kHz tick)
+ */
+static void scheduler_arm(TaskId id, uint32_t delay_ms) {
+    task_list[id].deadline = timebase_get_ms() + (delay_ms != 0 ? delay_ms : 1u);
+    scheduler_link(id);
+    timebase_request_wakeup(task_list[id].deadline);
+}
+
+/* ms from wheel_time to the next non-empty slot (1..WHEEL_SLOTS), SCHEDULER_NO_DEADLINE if the wheel is empty */
+static uint32_t scheduler_slots_to_next(void) {
+    if (wheel_occupied == 0) {
+        return SCHEDULER_NO_DEADLINE;
+    }
+    uint32_t start = (wheel_time + 1u) & WHEEL_MASK;
+    uint64_t rotated = wheel_occupied >> start;
+
+    if (start != 0) {
+        rotated |= wheel_occupied << (WHEEL_SLOTS - start);
+    }
+    return (uint32_t)__builtin_ctzll(rotated) + 1u;
+}
+
+/* release every entry of the slot whose deadline is now ... entries for a later revolution stay put */
+static void scheduler_expire(uint32_t now) {
+    TaskId id = wheel[now & WHEEL_MASK];
+
+    while (id != SCHEDULER_NO_TASK) {
+        Task *task = &task_list[id];
+        TaskId next = task->next;
+
+        if (task->deadline == now) {
+            scheduler_unlink(id);
+            if (task->released == task->dispatched) {
+                task->due = now;
+            }
+            task->released++;
+            if (task->interval_ms != 0) {
+                task->deadline = now + task->interval_ms;
+                scheduler_link(id);
+            }
+            is_released = true;
+        }
+        id = next;
+    }
+}
+
+static TaskId scheduler_add(const char *name, TaskCallback callback, uint32_t interval_ms, TaskPriority priority, uint32_t budget_us, bool is_armed) {
+    if (task_count >= MAX_TASKS) {
+        return SCHEDULER_NO_TASK;
+    }
+    TaskId id = task_count;
+
+    task_list[id] = (Task){
+        .name = name,
+        .callback = callback,
+        .priority = priority,
+        .interval_ms = interval_ms,
+        .next = SCHEDULER_NO_TASK,
+        .prev = SCHEDULER_NO_TASK,
+        .budget_cycles = budget_us * scheduler_cycles_per_us(),
+    };
+    task_count = id + 1;
+    if (is_armed) {
+        __disable_irq();
+        scheduler_arm(id, interval_ms);
+        __enable_irq();
+    }
+    return id;
+}
 
 void scheduler_init(void) {
     task_count = 0;
+    missed = 0;
+    last_run = SCHEDULER_NO_TASK;
+    for (uint32_t slot = 0; slot < WHEEL_SLOTS; slot++) {
+        wheel[slot] = SCHEDULER_NO_TASK;
+    }
+    wheel_occupied = 0;
+    wheel_time = timebase_get_ms();
+    is_released = false;
+
+    /* free-running cycle counter for task budgets */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* periodic task, first run one interval from now */
+TaskId scheduler_add_task(const char *name, TaskCallback callback, uint32_t interval_ms, TaskPriority priority, uint32_t budget_us) {
+    return scheduler_add(name, callback, interval_ms, priority, budget_us, true);
+}
+
+/* one-shot timer, stopped until scheduler_start_timer() */
+TaskId scheduler_add_timer(const char *name, TaskCallback callback, TaskPriority priority, uint32_t budget_us) {
+    return scheduler_add(name, callback, 0, priority, budget_us, false);
+}
+
+/* (re)start one-shot timer ... runs once, delay_ms from now. A pending run is dropped */
+void scheduler_start_timer(TaskId id, uint32_t delay_ms) {
+    if (id < 0 || id >= task_count) {
+        return;
+    }
+    Task *task = &task_list[id];
+
+    __disable_irq();
+    if (task->is_armed) {
+        scheduler_unlink(id);
+    }
+    task->dispatched = task->released;
+    scheduler_arm(id, delay_ms);
+    __enable_irq();
 }
 
-void scheduler_add_task(TaskCallback callback, uint32_t interval_ms) {
-    if (task_count < MAX_TASKS) {
-        task_list[task_count++] = (Task){callback, interval_ms, 0};
+/* stop one-shot timer (or periodic task) ... a pending run is dropped */
+void scheduler_stop_timer(TaskId id) {
+    if (id < 0 || id >= task_count) {
+        return;
     }
+    Task *task = &task_list[id];
+
+    __disable_irq();
+    if (task->is_armed) {
+        scheduler_unlink(id);
+    }
+    task->dispatched = task->released;
+    __enable_irq();
+}
+
+/* interrupt context ... no callbacks here */
+void scheduler_tick(void) {
+    scheduler_advance(timebase_get_ms());
 }
 
-void run_scheduled_tasks(void) {
-    for (uint8_t i = 0; i < task_count; i++) {
-        if ((ms_counter - task_list[i].last_run) >= task_list[i].interval_ms) {
-            task_list[i].last_run = ms_counter;
-            task_list[i].callback();
+/*
+ * interrupt context ... bring the wheel up to now, releasing every deadline on the way. Only non-empty slots
+ * are visited, so a call after several ms without a tick costs no more than the deadlines it releases
+ */
+void scheduler_advance(uint32_t now) {
+    while ((int32_t)(now - wheel_time) > 0) {
+        uint32_t step = scheduler_slots_to_next();
+
+        if (step > now - wheel_time) {
+            wheel_time = now;
+            break;
         }
+        wheel_time += step;
+        scheduler_expire(wheel_time);
+    }
+}
+
+/*
+ * absolute time of the earliest slot holding an armed task or timer ... never later than the next deadline, exact
+ * while every armed deadline is within WHEEL_SLOTS ms of the last advance. The slot of a deadline a revolution
+ * or more out can come round first and make the answer early (the slot is checked and passed over). False if
+ * nothing is armed
+ */
+bool scheduler_get_next_deadline(uint32_t *deadline) {
+    __disable_irq();
+    uint32_t step = scheduler_slots_to_next();
+    uint32_t time = wheel_time;
+    __enable_irq();
+
+    if (step == SCHEDULER_NO_DEADLINE) {
+        return false;
+    }
+    *deadline = time + step;
+    return true;
+}
+
+/* ms from now until scheduler_get_next_deadline() (0 = due), SCHEDULER_NO_DEADLINE if nothing is armed */
+uint32_t scheduler_get_time_to_next(void) {
+    uint32_t deadline;
+
+    if (!scheduler_get_next_deadline(&deadline)) {
+        return SCHEDULER_NO_DEADLINE;
     }
+    int32_t remaining = (int32_t)(deadline - timebase_get_ms());
+    return remaining > 0 ? (uint32_t)remaining : 0;
 }
 
+/*
+ * main loop ... runs the most urgent ready task with priority <= lowest_priority (highest priority first, then
+ * earliest deadline), at most one per call. Returns true if a task ran
+ */
+bool scheduler_dispatch(TaskPriority lowest_priority) {
+    TaskId selected = SCHEDULER_NO_TASK;
+    uint16_t ready = 0;
+
+    if (!is_released) {
+        return false;   // nothing released since the last call found the list empty
+    }
+    is_released = false;
 
+    for (TaskId i = 0; i < task_count; i++) {
+        Task *task = &task_list[i];
 
+        if (task->released == task->dispatched) {
+            continue;
+        }
+        ready++;
+        if (task->priority > lowest_priority) {
+            continue;
+        }
+        if (selected == SCHEDULER_NO_TASK || task->priority < task_list[selected].priority ||
+            (task->priority == task_list[selected].priority && (int32_t)(task->due - task_list[selected].due) < 0)) {
+            selected = i;
+        }
+    }
+    if (ready > (selected != SCHEDULER_NO_TASK ? 1u : 0u)) {
+        is_released = true;     // still work waiting (or held off by lowest_priority), look again next call
+    }
+    if (selected == SCHEDULER_NO_TASK) {
+        return false;
+    }
+
+    Task *task = &task_list[selected];
+    uint32_t released = task->released;
+    uint32_t pending = released - task->dispatched;
+
+    task->missed += pending - 1;    // one run covers every deadline that passed while waiting
+    missed += pending - 1;
+    task->dispatched = released;
+    last_run = selected;
+
+    uint32_t start = SCHEDULER_CYCLE_COUNT();
+    task->callback();
+    uint32_t cycles = SCHEDULER_CYCLE_COUNT() - start;
+
+    task->runs++;
+    task->last_cycles = cycles;
+    if (cycles > task->max_cycles) {
+        task->max_cycles = cycles;
+    }
+    if (task->budget_cycles != 0 && cycles > task->budget_cycles) {
+        task->overruns++;
+    }
+    return true;
+}
+
+/* deadlines that passed without a run of their own since scheduler_init() (all tasks) */
+uint32_t scheduler_get_missed(void) {
+    return missed;
+}
+
+/* task run by the latest scheduler_dispatch() that ran one (NULL before the first) */
+const char* scheduler_get_last_task_name(void) {
+    return (last_run == SCHEDULER_NO_TASK) ? NULL : task_list[last_run].name;
+}
+
+uint16_t scheduler_get_task_count(void) {
+    return task_count;
+}
+
+bool scheduler_get_task_stats(TaskId id, TaskStats *stats) {
+    if (id < 0 || id >= task_count) {
+        return false;
+    }
+    const Task *task = &task_list[id];
+    const uint32_t cycles_per_us = scheduler_cycles_per_us();
+
+    *stats = (TaskStats){
+        .name = task->name,
+        .priority = task->priority,
+        .interval_ms = task->interval_ms,
+        .runs = task->runs,
+        .missed = task->missed,
+        .budget_us = task->budget_cycles / cycles_per_us,
+        .last_us = task->last_cycles / cycles_per_us,
+        .max_us = task->max_cycles / cycles_per_us,
+        .overruns = task->overruns,
+    };
+    return true;
+}
@@ -5,17 +5,33 @@
 
 #if defined(SSD1306_USE_I2C)
 
+#if defined(SSD1306_USE_DMA)
+static volatile uint8_t SSD1306_TxBusy = 0;
+// Blocking write during a DMA frame ... finish the frame first, driving it here since nothing else will until we return
+#define SSD1306_WAIT_TX_IDLE() while(SSD1306_TxBusy) { ssd1306_ServiceTransfer(); }
+#else
+#define SSD1306_WAIT_TX_IDLE()
+#endif
+
 void ssd1306_Reset(void) {
     /* for I2C - do nothing */
 }
 
 // Send a byte to the command register
 void ssd1306_WriteCommand(uint8_t byte) {
+    SSD1306_WAIT_TX_IDLE(); // blocking write must not collide with a DMA flush
     HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x00, 1, &byte, 1, HAL_MAX_DELAY);
 }
 
+// Send a sequence of command bytes in one transaction
+void ssd1306_WriteCommands(const uint8_t* buffer, size_t buff_size) {
+    SSD1306_WAIT_TX_IDLE();
+    HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x00, 1, (uint8_t*)buffer, buff_size, HAL_MAX_DELAY);
+}
+
 // Send data
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
+    SSD1306_WAIT_TX_IDLE();
     HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x40, 1, buffer, buff_size, HAL_MAX_DELAY);
 }
 
@@ -40,6 +56,14 @@ void ssd1306_WriteCommand(uint8_t byte) {
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET); // un-select OLED
 }
 
+// Send a sequence of command bytes
+void ssd1306_WriteCommands(const uint8_t* buffer, size_t buff_size) {
+    HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_RESET); // select OLED
+    HAL_GPIO_WritePin(SSD1306_DC_Port, SSD1306_DC_Pin, GPIO_PIN_RESET); // command
+    HAL_SPI_Transmit(&SSD1306_SPI_PORT, (uint8_t *) buffer, buff_size, HAL_MAX_DELAY);
+    HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET); // un-select OLED
+}
+
 // Send data
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_RESET); // select OLED
@@ -59,11 +83,70 @@ static uint8_t SSD1306_Buffer[SSD1306_BUFFER_SIZE];
 // Screen object
 static SSD1306_t SSD1306;
 
+// Columns changed since last ssd1306_UpdateScreen(), per page (DirtyStart > DirtyEnd = page clean)
+static uint8_t SSD1306_DirtyStart[SSD1306_HEIGHT / 8];
+static uint8_t SSD1306_DirtyEnd[SSD1306_HEIGHT / 8];
+
+// Display start line in pages ... logical page p lives in RAM page (p + SSD1306_PageOffset), see ssd1306_ScrollUp()
+static uint8_t SSD1306_PageOffset = 0;
+static uint8_t SSD1306_StartLinePending = 0;  // start line changed since last ssd1306_UpdateScreen()
+
+// Flush statistics (ssd1306_GetStats())
+static SSD1306_Stats_t SSD1306_Stats;
+
+#if defined(SSD1306_USE_I2C)
+#define SSD1306_BUS_OVERHEAD 2  // bytes per transaction on top of payload: address + control byte
+#else
+#define SSD1306_BUS_OVERHEAD 0
+#endif
+
+/* Account one frame of bytes sent by ssd1306_UpdateScreen() */
+static void ssd1306_CountFrame(uint16_t bytes) {
+    if(bytes == 0) {
+        return;
+    }
+    SSD1306_Stats.Frames++;
+    SSD1306_Stats.Bytes += bytes;
+    SSD1306_Stats.LastFrameBytes = bytes;
+    if(bytes > SSD1306_Stats.MaxFrameBytes) {
+        SSD1306_Stats.MaxFrameBytes = bytes;
+    }
+}
+
+/* RAM page holding logical page */
+static inline uint8_t ssd1306_RamPage(uint8_t page) {
+    return (page + SSD1306_PageOffset) % (SSD1306_HEIGHT/8);
+}
+
+/* Add columns x1..x2 of page to the dirty window */
+static inline void ssd1306_MarkDirty(uint8_t page, uint8_t x1, uint8_t x2) {
+    if(SSD1306_DirtyStart[page] > SSD1306_DirtyEnd[page]) {
+        SSD1306_DirtyStart[page] = x1;
+        SSD1306_DirtyEnd[page] = x2;
+        return;
+    }
+    if(x1 < SSD1306_DirtyStart[page]) SSD1306_DirtyStart[page] = x1;
+    if(x2 > SSD1306_DirtyEnd[page]) SSD1306_DirtyEnd[page] = x2;
+}
+
+static void ssd1306_MarkAllDirty(void) {
+    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
+        SSD1306_DirtyStart[i] = 0;
+        SSD1306_DirtyEnd[i] = SSD1306_WIDTH - 1;
+    }
+}
+
 /* Fills the Screenbuffer with values from a given buffer of a fixed length */
 SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len) {
     SSD1306_Error_t ret = SSD1306_ERR;
     if (len <= SSD1306_BUFFER_SIZE) {
         memcpy(SSD1306_Buffer,buf,len);
+        if(SSD1306_PageOffset != 0) {
+            // buf is in screen order ... back to start line 0
+            SSD1306_PageOffset = 0;
+            SSD1306_StartLinePending = 1;
+        }
+        ssd1306_MarkAllDirty();
         ret = SSD1306_OK;
     }
     return ret;
@@ -83,6 +166,7 @@ void ssd1306_Init(void) {
     ssd1306_WriteCommand(0x20); //Set Memory Addressing Mode
     ssd1306_WriteCommand(0x00); // 00b,Horizontal Addressing Mode; 01b,Vertical Addressing Mode;
                                 // 10b,Page Addressing Mode (RESET); 11b,Invalid
+                                // Horizontal mode - UpdateScreen sets a column/page window (0x21/0x22) per dirty span
 
     ssd1306_WriteCommand(0xB0); //Set Page Start Address for Page Addressing Mode,0-7
 
@@ -167,6 +251,8 @@ void ssd1306_Init(void) {
     // Set default values for screen object
     SSD1306.CurrentX = 0;
     SSD1306.CurrentY = 0;
+    SSD1306_PageOffset = 0;     // start line 0 set above
+    SSD1306_StartLinePending = 0;
     
     SSD1306.Initialized = 1;
 }
@@ -174,24 +260,337 @@ void ssd1306_Init(void) {
 /* Fill the whole screen with the given color */
 void ssd1306_Fill(SSD1306_COLOR color) {
     memset(SSD1306_Buffer, (color == Black) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer));
+    ssd1306_MarkAllDirty();
+}
+
+#if defined(SSD1306_USE_I2C) && defined(SSD1306_USE_DMA)
+
+/*
+ * Non-blocking flush. Dirty spans of the screenbuffer (back buffer) are copied into the front buffer and
+ * streamed out by DMA, one command + one data transaction per dirty page. The I2C completion interrupt only
+ * marks the transfer done, ssd1306_ServiceTransfer() (main loop) starts the next one, so no HAL call (and no
+ * HAL busy-flag wait) runs in interrupt context. Drawing into the back buffer continues while the previous
+ * frame is on the bus.
+ */
+
+// Front buffer rows hold a control byte slot ahead of the page data (column c at row[c + 1])
+#define SSD1306_FRONT_ROW (SSD1306_WIDTH + 1)
+
+typedef struct {
+    uint8_t command[8];     // control byte + [start line] + column/page window
+    uint8_t command_length;
+    uint8_t page;
+    uint8_t start;
+    uint8_t length;
+} SSD1306_Window_t;
+
+static uint8_t SSD1306_FrontBuffer[SSD1306_HEIGHT / 8 * SSD1306_FRONT_ROW];
+static SSD1306_Window_t SSD1306_Windows[SSD1306_HEIGHT / 8];
+static uint8_t SSD1306_WindowCount = 0;
+static uint8_t SSD1306_WindowIndex = 0;
+static uint8_t SSD1306_TxData = 0;                // 0 = window command next, 1 = window data next
+static volatile uint8_t SSD1306_TxActive = 0;     // transfer on the bus, cleared by completion interrupt
+static volatile uint8_t SSD1306_ResendAll = 0;    // transfer failed, resend whole screen
+
+/* Start DMA transfer for current step of current window ... main loop context only */
+static void ssd1306_StartTransfer(void) {
+    SSD1306_Window_t* window = &SSD1306_Windows[SSD1306_WindowIndex];
+    HAL_StatusTypeDef status;
+
+    if(!SSD1306_TxData) {
+        status = HAL_I2C_Master_Transmit_DMA(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, window->command, window->command_length);
+    } else {
+        uint8_t* row = &SSD1306_FrontBuffer[window->page * SSD1306_FRONT_ROW];
+        row[window->start] = 0x40; // control byte (data stream) just ahead of the span
+        status = HAL_I2C_Master_Transmit_DMA(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, &row[window->start], window->length + 1);
+    }
+    if(status != HAL_OK) {
+        ssd1306_TxErrorCallback();
+    }
 }
 
+/* Write the screenbuffer with changed to the screen ... returns immediately, previous frame still on the bus keeps changes pending */
+void ssd1306_UpdateScreen(void) {
+    if(SSD1306_TxBusy) {
+        return;
+    }
+    if(SSD1306_ResendAll) {
+        SSD1306_ResendAll = 0;
+        SSD1306_StartLinePending = 1;
+        ssd1306_MarkAllDirty();
+    }
+
+    // New start line goes out in the first command transaction of the frame
+    uint8_t start_line = SSD1306_StartLinePending;
+    SSD1306_StartLinePending = 0;
+
+    SSD1306_WindowCount = 0;
+    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
+        uint8_t start = SSD1306_DirtyStart[i];
+        uint8_t end = SSD1306_DirtyEnd[i];
+        if(start > end) {
+            // Page unchanged since last update
+            continue;
+        }
+        SSD1306_DirtyStart[i] = 0xFF;
+        SSD1306_DirtyEnd[i] = 0;
+
+        SSD1306_Window_t* window = &SSD1306_Windows[SSD1306_WindowCount++];
+        uint8_t n = 0;
+        window->command[n++] = 0x00; // control byte (command stream)
+        if(start_line) {
+            window->command[n++] = 0x40 | (SSD1306_PageOffset * 8);
+            start_line = 0;
+        }
+        window->command[n++] = 0x21;
+        window->command[n++] = SSD1306_X_OFFSET_LOWER + (SSD1306_X_OFFSET_UPPER << 4) + start;
+        window->command[n++] = SSD1306_X_OFFSET_LOWER + (SSD1306_X_OFFSET_UPPER << 4) + end;
+        window->command[n++] = 0x22;
+        window->command[n++] = i;
+        window->command[n++] = i;
+        window->command_length = n;
+        window->page = i;
+        window->start = start;
+        window->length = end - start + 1;
+        memcpy(&SSD1306_FrontBuffer[i * SSD1306_FRONT_ROW + start + 1], &SSD1306_Buffer[SSD1306_WIDTH*i + start], window->length);
+    }
+    if(start_line) {
+        // Start line changed, screenbuffer didn't ... command only window
+        SSD1306_Window_t* window = &SSD1306_Windows[SSD1306_WindowCount++];
+        window->command[0] = 0x00;
+        window->command[1] = 0x40 | (SSD1306_PageOffset * 8);
+        window->command_length = 2;
+        window->length = 0;
+    }
+    if(SSD1306_WindowCount == 0) {
+        return;
+    }
+
+    uint16_t frame_bytes = 0;
+    for(uint8_t i = 0; i < SSD1306_WindowCount; i++) {
+        // command_length includes the control byte
+        frame_bytes += SSD1306_BUS_OVERHEAD - 1 + SSD1306_Windows[i].command_length;
+        if(SSD1306_Windows[i].length) {
+            frame_bytes += SSD1306_BUS_OVERHEAD + SSD1306_Windows[i].length;
+        }
+    }
+    ssd1306_CountFrame(frame_bytes);
+
+    SSD1306_WindowIndex = 0;
+    SSD1306_TxData = 0;
+    SSD1306_TxBusy = 1;
+    SSD1306_TxActive = 1;
+    ssd1306_StartTransfer();
+}
+
+/*
+ * Call from main loop on every pass ... starts the next transfer of the frame once the previous one is done and
+ * the bus has gone idle (STOP sent). Returns 1 while a transfer is waiting to be started (main loop must not sleep,
+ * no interrupt will come), 0 when idle or a transfer is on the bus (its completion interrupt wakes the main loop).
+ */
+uint8_t ssd1306_ServiceTransfer(void) {
+    if(!SSD1306_TxBusy || SSD1306_TxActive) {
+        return 0;
+    }
+    if(__HAL_I2C_GET_FLAG(&SSD1306_I2C_PORT, I2C_FLAG_BUSY)) {
+        return 1;   // STOP of previous transfer still going out ... try again next pass
+    }
+    if(SSD1306_TxData || SSD1306_Windows[SSD1306_WindowIndex].length == 0) {
+        SSD1306_WindowIndex++;  // window done (command only window has no data)
+        SSD1306_TxData = 0;
+    } else {
+        SSD1306_TxData = 1;
+    }
+    if(SSD1306_WindowIndex >= SSD1306_WindowCount) {
+        SSD1306_TxBusy = 0; // frame complete
+        return 0;
+    }
+    SSD1306_TxActive = 1;
+    ssd1306_StartTransfer();
+    return 0;
+}
+
+/* Call from HAL_I2C_MasterTxCpltCallback() ... marks the transfer done, ssd1306_ServiceTransfer() continues the frame */
+void ssd1306_TxCpltCallback(void) {
+    SSD1306_TxActive = 0;
+}
+
+/* Call from HAL_I2C_ErrorCallback() ... drop frame, next update resends whole screen */
+void ssd1306_TxErrorCallback(void) {
+    SSD1306_ResendAll = 1;
+    SSD1306_TxActive = 0;
+    SSD1306_TxBusy = 0;
+}
+
+uint8_t ssd1306_IsBusy(void) {
+    return SSD1306_TxBusy;
+}
+
+#else
+
 /* Write the screenbuffer with changed to the screen */
 void ssd1306_UpdateScreen(void) {
-    // Write data to each page of RAM. Number of pages
+    // Write the dirty column span of each page of RAM. Number of pages
     // depends on the screen height:
     //
     //  * 32px   ==  4 pages
     //  * 64px   ==  8 pages
     //  * 128px  ==  16 pages
+    uint16_t frame_bytes = 0;
+
+    if(SSD1306_StartLinePending) {
+        SSD1306_StartLinePending = 0;
+        ssd1306_WriteCommand(0x40 | (SSD1306_PageOffset * 8));
+        frame_bytes += SSD1306_BUS_OVERHEAD + 1;
+    }
     for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
-        ssd1306_WriteCommand(0xB0 + i); // Set the current RAM page address.
-        ssd1306_WriteCommand(0x00 + SSD1306_X_OFFSET_LOWER);
-        ssd1306_WriteCommand(0x10 + SSD1306_X_OFFSET_UPPER);
-        ssd1306_WriteData(&SSD1306_Buffer[SSD1306_WIDTH*i],SSD1306_WIDTH);
+        uint8_t start = SSD1306_DirtyStart[i];
+        uint8_t end = SSD1306_DirtyEnd[i];
+        if(start > end) {
+            // Page unchanged since last update
+            continue;
+        }
+        SSD1306_DirtyStart[i] = 0xFF;
+        SSD1306_DirtyEnd[i] = 0;
+
+        // Column and page window for the span, sent as one command transaction
+        const uint8_t window[] = {
+            0x21, SSD1306_X_OFFSET_LOWER + (SSD1306_X_OFFSET_UPPER << 4) + start, SSD1306_X_OFFSET_LOWER + (SSD1306_X_OFFSET_UPPER << 4) + end,
+            0x22, i, i
+        };
+        ssd1306_WriteCommands(window, sizeof(window));
+        ssd1306_WriteData(&SSD1306_Buffer[SSD1306_WIDTH*i + start], end - start + 1);
+        frame_bytes += SSD1306_BUS_OVERHEAD + sizeof(window) + SSD1306_BUS_OVERHEAD + (end - start + 1);
+    }
+    ssd1306_CountFrame(frame_bytes);
+}
+
+uint8_t ssd1306_IsBusy(void) {
+    return 0;
+}
+
+uint8_t ssd1306_ServiceTransfer(void) {
+    return 0;
+}
+
+#endif
+
+/* Copy of flush statistics ... bytes are counted as they go on the bus (I2C address and control bytes included) */
+void ssd1306_GetStats(SSD1306_Stats_t* stats) {
+    *stats = SSD1306_Stats;
+}
+
+void ssd1306_ResetStats(void) {
+    memset(&SSD1306_Stats, 0, sizeof(SSD1306_Stats));
+}
+
+/* Returns 1 if the screenbuffer holds changes not yet sent by ssd1306_UpdateScreen() */
+uint8_t ssd1306_IsDirty(void) {
+    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
+        if(SSD1306_DirtyStart[i] <= SSD1306_DirtyEnd[i]) {
+            return 1;
+        }
+    }
+#if defined(SSD1306_USE_I2C) && defined(SSD1306_USE_DMA)
+    return SSD1306_ResendAll;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Move screenbuffer content to a new page offset, column by column. Logical pages from top_pages on are
+ * moved up one page in columns 0..width-1 (bottom page comes up blank), everything else stays where it is
+ * on screen. Only bytes that end up different are marked dirty.
+ */
+static void ssd1306_MovePages(uint8_t new_offset, uint8_t top_pages, uint8_t width) {
+    const uint8_t pages = SSD1306_HEIGHT/8;
+    uint8_t column[SSD1306_HEIGHT/8];
+
+    for(uint8_t x = 0; x < SSD1306_WIDTH; x++) {
+        for(uint8_t p = 0; p < pages; p++) {
+            column[p] = SSD1306_Buffer[ssd1306_RamPage(p) * SSD1306_WIDTH + x];
+        }
+        for(uint8_t p = 0; p < pages; p++) {
+            uint8_t value = column[p];
+            if(x < width && p >= top_pages) {
+                value = (p + 1 < pages) ? column[p + 1] : 0x00;
+            }
+            const uint8_t ram_page = (p + new_offset) % pages;
+            uint8_t* byte = &SSD1306_Buffer[ram_page * SSD1306_WIDTH + x];
+            if(value != *byte) {
+                *byte = value;
+                ssd1306_MarkDirty(ram_page, x, x);
+            }
+        }
+    }
+    if(new_offset != SSD1306_PageOffset) {
+        SSD1306_PageOffset = new_offset;
+        SSD1306_StartLinePending = 1;
+    }
+}
+
+/*
+ * Scroll the area below top_pages, columns 0..width-1, up by one page using the display start line (0x40 | line).
+ * The controller RAM already holds the scrolled text, so only the pinned parts (pages above top_pages and
+ * columns from width on) are rewritten at their new RAM page. The bottom page of the area comes up blank.
+ */
+void ssd1306_ScrollUp(uint8_t top_pages, uint8_t width) {
+    ssd1306_MovePages((SSD1306_PageOffset + 1) % (SSD1306_HEIGHT/8), top_pages, width);
+}
+
+#if defined(HOST_TEST)
+/* host tests only ... back to start line 0, screen content unchanged */
+void ssd1306_ResetScroll(void) {
+    ssd1306_MovePages(0, SSD1306_HEIGHT/8, 0);
+}
+#endif
+
+/*
+ * Shift pixel rows y1..y2 of columns 0..width-1 by dy rows (dy > 0 = down), rows shifted in come up blank.
+ * Works on whole columns (64-bit word per column), everything outside the area stays where it is.
+ * Only bytes that end up different are marked dirty.
+ */
+void ssd1306_ShiftRows(uint8_t y1, uint8_t y2, uint8_t width, int8_t dy) {
+    const uint8_t pages = SSD1306_HEIGHT/8;
+
+    if(y2 >= SSD1306_HEIGHT) y2 = SSD1306_HEIGHT - 1;
+    if(width > SSD1306_WIDTH) width = SSD1306_WIDTH;
+    if(y1 > y2 || dy == 0) {
+        return;
+    }
+
+    const uint64_t mask = (y2 == 63 ? ~0ULL : (1ULL << (y2 + 1)) - 1) & ~((1ULL << y1) - 1);
+    for(uint8_t x = 0; x < width; x++) {
+        uint64_t column = 0;
+        for(uint8_t p = 0; p < pages; p++) {
+            column |= (uint64_t)SSD1306_Buffer[ssd1306_RamPage(p) * SSD1306_WIDTH + x] << (8 * p);
+        }
+        uint64_t shifted = 0;
+        if(dy > -64 && dy < 64) {
+            shifted = dy > 0 ? (column & mask) << dy : (column & mask) >> -dy;
+        }
+        column = (column & ~mask) | (shifted & mask);
+        for(uint8_t p = 0; p < pages; p++) {
+            const uint8_t ram_page = ssd1306_RamPage(p);
+            uint8_t* byte = &SSD1306_Buffer[ram_page * SSD1306_WIDTH + x];
+            const uint8_t value = (uint8_t)(column >> (8 * p));
+            if(value != *byte) {
+                *byte = value;
+                ssd1306_MarkDirty(ram_page, x, x);
+            }
+        }
     }
 }
 
+/* Read back one pixel of the screenbuffer (as shown on screen) */
+SSD1306_COLOR ssd1306_GetPixel(uint8_t x, uint8_t y) {
+    if(x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+        return Black;
+    }
+    return (SSD1306_Buffer[x + ssd1306_RamPage(y / 8) * SSD1306_WIDTH] >> (y % 8)) & 0x01 ? White : Black;
+}
+
 /*
  * Draw one pixel in the screenbuffer
  * X => X Coordinate
@@ -205,10 +604,48 @@ void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
     }
    
     // Draw in the right color
-    if(color == White) {
-        SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] |= 1 << (y % 8);
-    } else { 
-        SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
+    const uint8_t page = ssd1306_RamPage(y / 8);
+    uint8_t* byte = &SSD1306_Buffer[x + page * SSD1306_WIDTH];
+    uint8_t value = (color == White) ? (*byte | (1 << (y % 8))) : (*byte & ~(1 << (y % 8)));
+
+    // Only a real change needs to go out on the next update
+    if(value != *byte) {
+        *byte = value;
+        ssd1306_MarkDirty(page, x, x);
+    }
+}
+
+/*
+ * Write glyph columns at the cursor ... each column is at most 8 pixels high, so it lands in one page byte,
+ * or two when the cursor is not page aligned. Foreground and background are both written (same as the
+ * per-pixel path), the rest of each byte is kept.
+ */
+static void ssd1306_BlitGlyph(const uint8_t* columns, uint8_t width, uint8_t height, SSD1306_COLOR color) {
+    const uint8_t x = SSD1306.CurrentX;
+    const uint8_t page = ssd1306_RamPage(SSD1306.CurrentY / 8);
+    const uint8_t next_page = ssd1306_RamPage(SSD1306.CurrentY / 8 + 1);     // only used when glyph crosses into next page
+    const uint8_t shift = SSD1306.CurrentY % 8;
+    const uint8_t cell = 0xFF >> (8 - height);
+    uint8_t* upper = &SSD1306_Buffer[page * SSD1306_WIDTH + x];
+    uint8_t* lower = &SSD1306_Buffer[next_page * SSD1306_WIDTH + x];
+    const uint8_t upper_mask = cell << shift;
+    const uint8_t lower_mask = (shift + height > 8) ? cell >> (8 - shift) : 0;
+
+    for(uint8_t j = 0; j < width; j++) {
+        uint8_t bits = (color == White) ? columns[j] : (uint8_t)~columns[j] & cell;
+        uint8_t value = (upper[j] & ~upper_mask) | (uint8_t)(bits << shift);
+
+        if(value != upper[j]) {
+            upper[j] = value;
+            ssd1306_MarkDirty(page, x + j, x + j);
+        }
+        if(lower_mask) {
+            value = (lower[j] & ~lower_mask) | (bits >> (8 - shift));
+            if(value != lower[j]) {
+                lower[j] = value;
+                ssd1306_MarkDirty(next_page, x + j, x + j);
+            }
+        }
     }
 }
 
@@ -235,6 +672,13 @@ char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color) {
         return 0;
     }
     
+    // Column-byte font ... blit each glyph column into the one or two page bytes it covers
+    if(Font.columns != NULL && Font.height <= 8) {
+        ssd1306_BlitGlyph(&Font.columns[(ch - 32) * char_width], char_width, Font.height, color);
+        SSD1306.CurrentX += char_width;
+        return ch;
+    }
+
     // Use the font to write
     for(i = 0; i < Font.height; i++) {
         b = Font.data[(ch - 32) * Font.height + i];
@@ -276,6 +720,12 @@ void ssd1306_SetCursor(uint8_t x, uint8_t y) {
 
 /* Draw line by Bresenhem's algorithm */
 void ssd1306_Line(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
+    if(x1 == x2 || y1 == y2) {
+        // Horizontal or vertical ... same pixels as a one pixel wide rectangle
+        ssd1306_FillRectangle(x1, y1, x2, y2, color);
+        return;
+    }
+
     int32_t deltaX = abs(x2 - x1);
     int32_t deltaY = abs(y2 - y1);
     int32_t signX = ((x1 < x2) ? 1 : -1);
@@ -492,24 +942,64 @@ void ssd1306_FillCircle(uint8_t par_x,uint8_t par_y,uint8_t par_r,SSD1306_COLOR
 
 /* Draw a rectangle */
 void ssd1306_DrawRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
-    ssd1306_Line(x1,y1,x2,y1,color);
-    ssd1306_Line(x2,y1,x2,y2,color);
-    ssd1306_Line(x2,y2,x1,y2,color);
-    ssd1306_Line(x1,y2,x1,y1,color);
+    if(y1 == y2 || x1 == x2) {
+        // Degenerate rectangle (e.g. one pixel high bar) ... all four sides are the same span
+        ssd1306_FillRectangle(x1, y1, x2, y2, color);
+        return;
+    }
+    ssd1306_FillRectangle(x1,y1,x2,y1,color);
+    ssd1306_FillRectangle(x2,y1,x2,y2,color);
+    ssd1306_FillRectangle(x1,y2,x2,y2,color);
+    ssd1306_FillRectangle(x1,y1,x1,y2,color);
 
     return;
 }
 
-/* Draw a filled rectangle */
+/*
+ * Draw a filled rectangle ... corners in any order, inclusive, clipped to the screen.
+ * Written a page at a time: rows of the rectangle inside a page form one byte mask, applied to every column.
+ */
 void ssd1306_FillRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
     uint8_t x_start = ((x1<=x2) ? x1 : x2);
     uint8_t x_end   = ((x1<=x2) ? x2 : x1);
     uint8_t y_start = ((y1<=y2) ? y1 : y2);
     uint8_t y_end   = ((y1<=y2) ? y2 : y1);
 
-    for (uint8_t y= y_start; (y<= y_end)&&(y<SSD1306_HEIGHT); y++) {
-        for (uint8_t x= x_start; (x<= x_end)&&(x<SSD1306_WIDTH); x++) {
-            ssd1306_DrawPixel(x, y, color);
+    if(x_start >= SSD1306_WIDTH || y_start >= SSD1306_HEIGHT) {
+        return;
+    }
+    if(x_end >= SSD1306_WIDTH) {
+        x_end = SSD1306_WIDTH - 1;
+    }
+    if(y_end >= SSD1306_HEIGHT) {
+        y_end = SSD1306_HEIGHT - 1;
+    }
+
+    for(uint8_t page = y_start / 8; page <= y_end / 8; page++) {
+        uint8_t mask = 0xFF;
+        if(page == y_start / 8) {
+            mask &= 0xFF << (y_start % 8);
+        }
+        if(page == y_end / 8) {
+            mask &= 0xFF >> (7 - (y_end % 8));
+        }
+
+        const uint8_t ram_page = ssd1306_RamPage(page);
+        uint8_t* row = &SSD1306_Buffer[ram_page * SSD1306_WIDTH];
+        uint8_t first = SSD1306_WIDTH, last = 0;
+        for(uint8_t x = x_start; x <= x_end; x++) {
+            uint8_t value = (color == White) ? (row[x] | mask) : (row[x] & ~mask);
+            // Compare before write ... only real changes go out on the next update
+            if(value != row[x]) {
+                row[x] = value;
+                if(first == SSD1306_WIDTH) {
+                    first = x;
+                }
+                last = x;
+            }
+        }
+        if(first != SSD1306_WIDTH) {
+            ssd1306_MarkDirty(ram_page, first, last);
         }
     }
     return;
@@ -522,25 +1012,20 @@ SSD1306_Error_t ssd1306_InvertRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint
   if ((x1 > x2) || (y1 > y2)) {
     return SSD1306_ERR;
   }
-  uint32_t i;
-  if ((y1 / 8) != (y2 / 8)) {
-    /* if rectangle doesn't lie on one 8px row */
+  for (uint32_t page = y1 / 8; page <= (uint32_t)y2 / 8; page++) {
+    /* rows of rectangle inside this page */
+    uint8_t mask = 0xFF;
+    if (page == y1 / 8) {
+      mask &= 0xFF << (y1 % 8);
+    }
+    if (page == (uint32_t)y2 / 8) {
+      mask &= 0xFF >> (7 - (y2 % 8));
+    }
+    const uint8_t ram_page = ssd1306_RamPage(page);
     for (uint32_t x = x1; x <= x2; x++) {
-      i = x + (y1 / 8) * SSD1306_WIDTH;
-      SSD1306_Buffer[i] ^= 0xFF << (y1 % 8);
-      i += SSD1306_WIDTH;
-      for (; i < x + (y2 / 8) * SSD1306_WIDTH; i += SSD1306_WIDTH) {
-        SSD1306_Buffer[i] ^= 0xFF;
-      }
-      SSD1306_Buffer[i] ^= 0xFF >> (7 - (y2 % 8));
-    }
-  } else {
-    /* if rectangle lies on one 8px row */
-    const uint8_t mask = (0xFF << (y1 % 8)) & (0xFF >> (7 - (y2 % 8)));
-    for (i = x1 + (y1 / 8) * SSD1306_WIDTH;
-         i <= (uint32_t)x2 + (y2 / 8) * SSD1306_WIDTH; i++) {
-      SSD1306_Buffer[i] ^= mask;
+      SSD1306_Buffer[x + ram_page * SSD1306_WIDTH] ^= mask;
     }
+    ssd1306_MarkDirty(ram_page, x1, x2);
   }
   return SSD1306_OK;
 }
@@ -397,6 +397,104 @@ static const uint16_t Font6x8 [] = {
 0x4000, 0x2000, 0x2000, 0x1000, 0x2000, 0x2000, 0x4000, 0x0000,  // }
 0x4000, 0xa800, 0x1000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // ~
 };
+/* Font6x8 transposed to column bytes (bit 0 = top row), same layout as a display page ... used by the WriteChar blitter */
+static const uint8_t Font6x8_columns [] = {
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // sp
+0x00, 0x00, 0x5f, 0x00, 0x00, 0x00,  // !
+0x00, 0x07, 0x00, 0x07, 0x00, 0x00,  // "
+0x14, 0x7f, 0x14, 0x7f, 0x14, 0x00,  // #
+0x24, 0x2a, 0x7f, 0x2a, 0x12, 0x00,  // $
+0x23, 0x13, 0x08, 0x64, 0x62, 0x00,  // %
+0x36, 0x49, 0x56, 0x20, 0x50, 0x00,  // &
+0x00, 0x08, 0x07, 0x03, 0x00, 0x00,  // '
+0x00, 0x1c, 0x22, 0x41, 0x00, 0x00,  // (
+0x00, 0x41, 0x22, 0x1c, 0x00, 0x00,  // )
+0x2a, 0x1c, 0x7f, 0x1c, 0x2a, 0x00,  // *
+0x08, 0x08, 0x3e, 0x08, 0x08, 0x00,  // +
+0x00, 0x00, 0x70, 0x30, 0x00, 0x00,  // ,
+0x08, 0x08, 0x08, 0x08, 0x08, 0x00,  // -
+0x00, 0x00, 0x60, 0x60, 0x00, 0x00,  // .
+0x20, 0x10, 0x08, 0x04, 0x02, 0x00,  // /
+0x3e, 0x51, 0x49, 0x45, 0x3e, 0x00,  // 0
+0x00, 0x42, 0x7f, 0x40, 0x00, 0x00,  // 1
+0x72, 0x49, 0x49, 0x49, 0x46, 0x00,  // 2
+0x21, 0x41, 0x49, 0x4d, 0x33, 0x00,  // 3
+0x18, 0x14, 0x12, 0x7f, 0x10, 0x00,  // 4
+0x27, 0x45, 0x45, 0x45, 0x39, 0x00,  // 5
+0x3c, 0x4a, 0x49, 0x49, 0x31, 0x00,  // 6
+0x41, 0x21, 0x11, 0x09, 0x07, 0x00,  // 7
+0x36, 0x49, 0x49, 0x49, 0x36, 0x00,  // 8
+0x46, 0x49, 0x49, 0x29, 0x1e, 0x00,  // 9
+0x00, 0x00, 0x14, 0x00, 0x00, 0x00,  // :
+0x00, 0x40, 0x34, 0x00, 0x00, 0x00,  // ;
+0x00, 0x08, 0x14, 0x22, 0x41, 0x00,  // <
+0x14, 0x14, 0x14, 0x14, 0x14, 0x00,  // =
+0x00, 0x41, 0x22, 0x14, 0x08, 0x00,  // >
+0x02, 0x01, 0x59, 0x09, 0x06, 0x00,  // ?
+0x3e, 0x41, 0x5d, 0x59, 0x4e, 0x00,  // @
+0x7c, 0x12, 0x11, 0x12, 0x7c, 0x00,  // A
+0x7f, 0x49, 0x49, 0x49, 0x36, 0x00,  // B
+0x3e, 0x41, 0x41, 0x41, 0x22, 0x00,  // C
+0x7f, 0x41, 0x41, 0x41, 0x3e, 0x00,  // D
+0x7f, 0x49, 0x49, 0x49, 0x41, 0x00,  // E
+0x7f, 0x09, 0x09, 0x09, 0x01, 0x00,  // F
+0x3e, 0x41, 0x41, 0x51, 0x73, 0x00,  // G
+0x7f, 0x08, 0x08, 0x08, 0x7f, 0x00,  // H
+0x00, 0x41, 0x7f, 0x41, 0x00, 0x00,  // I
+0x20, 0x40, 0x41, 0x3f, 0x01, 0x00,  // J
+0x7f, 0x08, 0x14, 0x22, 0x41, 0x00,  // K
+0x7f, 0x40, 0x40, 0x40, 0x40, 0x00,  // L
+0x7f, 0x02, 0x1c, 0x02, 0x7f, 0x00,  // M
+0x7f, 0x04, 0x08, 0x10, 0x7f, 0x00,  // N
+0x3e, 0x41, 0x41, 0x41, 0x3e, 0x00,  // O
+0x7f, 0x09, 0x09, 0x09, 0x06, 0x00,  // P
+0x3e, 0x41, 0x51, 0x21, 0x5e, 0x00,  // Q
+0x7f, 0x09, 0x19, 0x29, 0x46, 0x00,  // R
+0x26, 0x49, 0x49, 0x49, 0x32, 0x00,  // S
+0x03, 0x01, 0x7f, 0x01, 0x03, 0x00,  // T
+0x3f, 0x40, 0x40, 0x40, 0x3f, 0x00,  // U
+0x1f, 0x20, 0x40, 0x20, 0x1f, 0x00,  // V
+0x3f, 0x40, 0x38, 0x40, 0x3f, 0x00,  // W
+0x63, 0x14, 0x08, 0x14, 0x63, 0x00,  // X
+0x03, 0x04, 0x78, 0x04, 0x03, 0x00,  // Y
+0x61, 0x59, 0x49, 0x4d, 0x43, 0x00,  // Z
+0x00, 0x7f, 0x41, 0x41, 0x41, 0x00,  // [
+0x02, 0x04, 0x08, 0x10, 0x20, 0x00,  /* \ */
+0x00, 0x41, 0x41, 0x41, 0x7f, 0x00,  // ]
+0x04, 0x02, 0x01, 0x02, 0x04, 0x00,  // ^
+0x40, 0x40, 0x40, 0x40, 0x40, 0x00,  // _
+0x00, 0x03, 0x07, 0x08, 0x00, 0x00,  // `
+0x20, 0x54, 0x54, 0x78, 0x40, 0x00,  // a
+0x7f, 0x28, 0x44, 0x44, 0x38, 0x00,  // b
+0x38, 0x44, 0x44, 0x44, 0x28, 0x00,  // c
+0x38, 0x44, 0x44, 0x28, 0x7f, 0x00,  // d
+0x38, 0x54, 0x54, 0x54, 0x18, 0x00,  // e
+0x00, 0x08, 0x7e, 0x09, 0x02, 0x00,  // f
+0x18, 0x24, 0x24, 0x1c, 0x78, 0x00,  // g
+0x7f, 0x08, 0x04, 0x04, 0x78, 0x00,  // h
+0x00, 0x44, 0x7d, 0x40, 0x00, 0x00,  // i
+0x20, 0x40, 0x40, 0x3d, 0x00, 0x00,  // j
+0x7f, 0x10, 0x28, 0x44, 0x00, 0x00,  // k
+0x00, 0x41, 0x7f, 0x40, 0x00, 0x00,  // l
+0x7c, 0x04, 0x78, 0x04, 0x78, 0x00,  // m
+0x7c, 0x08, 0x04, 0x04, 0x78, 0x00,  // n
+0x38, 0x44, 0x44, 0x44, 0x38, 0x00,  // o
+0x7c, 0x18, 0x24, 0x24, 0x18, 0x00,  // p
+0x18, 0x24, 0x24, 0x18, 0x7c, 0x00,  // q
+0x7c, 0x08, 0x04, 0x04, 0x08, 0x00,  // r
+0x48, 0x54, 0x54, 0x54, 0x24, 0x00,  // s
+0x04, 0x04, 0x3f, 0x44, 0x24, 0x00,  // t
+0x3c, 0x40, 0x40, 0x20, 0x7c, 0x00,  // u
+0x1c, 0x20, 0x40, 0x20, 0x1c, 0x00,  // v
+0x3c, 0x40, 0x30, 0x40, 0x3c, 0x00,  // w
+0x44, 0x28, 0x10, 0x28, 0x44, 0x00,  // x
+0x4c, 0x10, 0x10, 0x10, 0x7c, 0x00,  // y
+0x44, 0x64, 0x54, 0x4c, 0x44, 0x00,  // z
+0x00, 0x08, 0x36, 0x41, 0x00, 0x00,  // {
+0x00, 0x00, 0x77, 0x00, 0x00, 0x00,  // |
+0x00, 0x41, 0x36, 0x08, 0x00, 0x00,  // }
+0x02, 0x01, 0x02, 0x04, 0x02, 0x00,  // ~
+};
 #endif
 
 /* see ./examples/custom-fonts/ */
@@ -895,21 +993,21 @@ static const uint8_t char_width[] = {
 #endif
 
 #ifdef SSD1306_INCLUDE_FONT_6x8
-const SSD1306_Font_t Font_6x8 = {6, 8, Font6x8, NULL};
+const SSD1306_Font_t Font_6x8 = {6, 8, Font6x8, NULL, Font6x8_columns};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_7x10
-const SSD1306_Font_t Font_7x10 = {7, 10, Font7x10, NULL};
+const SSD1306_Font_t Font_7x10 = {7, 10, Font7x10, NULL, NULL};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_11x18
-const SSD1306_Font_t Font_11x18 = {11, 18, Font11x18, NULL};
+const SSD1306_Font_t Font_11x18 = {11, 18, Font11x18, NULL, NULL};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_16x26
-const SSD1306_Font_t Font_16x26 = {16, 26, Font16x26, NULL};
+const SSD1306_Font_t Font_16x26 = {16, 26, Font16x26, NULL, NULL};
 #endif
 
 /* see ./examples/custom-fonts/ */
 #ifdef SSD1306_INCLUDE_FONT_16x24
-const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL};
+const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL, NULL};
 #endif
 
 #ifdef SSD1306_INCLUDE_FONT_16x15
@@ -917,5 +1015,5 @@ const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL};
  * @copyright Google https://github.com/googlefonts/roboto
  * @license This font is licensed under the Apache License, Version 2.0.
 */
-const SSD1306_Font_t Font_16x15 = {16, 15, Font16x15, char_width};
+const SSD1306_Font_t Font_16x15 = {16, 15, Font16x15, char_width, NULL};
 #endif
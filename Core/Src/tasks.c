@@ -15,18 +15,18 @@
 #include "display.h"
 #include "filter_channels.h"
 #include "ui.h"
-
-extern volatile bool timeoutFlag;
+#include "profile.h"
 
 // Task implementation
 
 void heartbeat(void)
 {
+	PROFILE_BEGIN(PROFILE_HEARTBEAT);
 	HAL_GPIO_TogglePin(LED_GPIO_Port, LED_Pin);
 
 	/* animate "Waiting ..." message on oled display */
 	char temp[5];
-	if(false == ui_is_capture_active()) /* "Waiting" screen is active */
+	if(APP_STATE_SPLASH != app_get_state() && false == ui_is_capture_active()) /* "Waiting" screen is active */
 	{
 		static uint16_t counter = 0;
 		uint8_t i;
@@ -43,15 +43,37 @@ void heartbeat(void)
 		counter++;
 		display_string(temp, 1, 12, White, true);
 	}
+	PROFILE_END(PROFILE_HEARTBEAT);
 }
 
 void read_encoders(void)
 {
 	static int16_t rotary_scroll_previous_value = 0, rotary_filter_previous_value = 0;
+	static bool is_time_jump_active = false;
+	static int16_t time_jump_filter_value = 0, time_jump_counts = 0;
+	PROFILE_BEGIN(PROFILE_READ_ENCODERS);
+
+	/* scroll button released after jump-to-time ... put filter encoder back where channel selection left it */
+	if(is_time_jump_active && !button_is_held(BUTTON_SCROLL))
+	{
+		is_time_jump_active = false;
+		__HAL_TIM_SET_COUNTER(&htim3, time_jump_filter_value);
+		rotary_filter_previous_value = time_jump_filter_value;
+	}
 
 	int16_t rotary_scroll_current_value = (int16_t)__HAL_TIM_GET_COUNTER(&htim2) / 2;
 	int16_t rotary_filter_current_value = (int16_t)__HAL_TIM_GET_COUNTER(&htim3);
 
+	if(APP_STATE_SPLASH == app_get_state()) /* any encoder movement skips splash screen ... movement itself is dropped */
+	{
+		if(rotary_scroll_current_value != rotary_scroll_previous_value || rotary_filter_current_value != rotary_filter_previous_value)
+			ui_end_splash();
+		rotary_scroll_previous_value = rotary_scroll_current_value;
+		rotary_filter_previous_value = rotary_filter_current_value;
+		PROFILE_END(PROFILE_READ_ENCODERS);
+		return;
+	}
+
 	int16_t delta = (int16_t)(rotary_scroll_current_value - rotary_scroll_previous_value);
 	rotary_scroll_previous_value = rotary_scroll_current_value;
 	if (0 != delta)
@@ -59,16 +81,53 @@ void read_encoders(void)
 		ui_scroll_history(delta); /* scroll wheel active, send delta to ui for processing */
 	}
 
-	if(rotary_filter_current_value != rotary_filter_previous_value)
+	if(rotary_filter_current_value != rotary_filter_previous_value && button_is_held(BUTTON_SCROLL))
+	{
+		/* scroll button held ... filter encoder selects jump-to-time (4 counts per detent, counter wraps at period) */
+		int16_t counts = rotary_filter_current_value - rotary_filter_previous_value;
+		int16_t encoder_range = htim3.Init.Period + 1;
+		if(counts > encoder_range / 2)
+			counts -= encoder_range;
+		else if(counts < -encoder_range / 2)
+			counts += encoder_range;
+
+		if(false == is_time_jump_active)
+		{
+			is_time_jump_active = true;
+			time_jump_filter_value = rotary_filter_previous_value; /* channel selection position, restored on release */
+			time_jump_counts = 0;
+			button_claim(BUTTON_SCROLL);
+			ui_time_jump_begin();
+		}
+		rotary_filter_previous_value = rotary_filter_current_value;
+		time_jump_counts += counts;
+		if(time_jump_counts / 4 != 0)
+		{
+			ui_time_jump_step(time_jump_counts / 4);
+			time_jump_counts %= 4;
+		}
+	}
+	else if(rotary_filter_current_value != rotary_filter_previous_value)
 	{
 		printf("Filter raw = %d\r\n", rotary_filter_current_value);
 
 		display_channel(filter_setChannelFromEncoder(rotary_filter_current_value));
 		rotary_filter_previous_value = rotary_filter_current_value;
 	}
+	PROFILE_END(PROFILE_READ_ENCODERS);
 }
 
 static void poll_buttons(void) {
+    PROFILE_BEGIN(PROFILE_POLL_BUTTONS);
+    if (APP_STATE_SPLASH == app_get_state()) {
+        /* any button skips splash screen ... claimed, so its release does nothing else */
+        for (ButtonID id = 0; id < BUTTON_COUNT; id++) {
+            if (button_is_held(id)) {
+                button_claim(id);
+                ui_end_splash();
+            }
+        }
+    }
     button_poll();
 
     switch (button_get_event(BUTTON_SCROLL)) {
@@ -92,13 +151,16 @@ static void poll_buttons(void) {
         default:
             break;
     }
+    PROFILE_END(PROFILE_POLL_BUTTONS);
 }
 
 // --- Task initialization/registration ---
 void tasks_init(void) {
-    scheduler_add_task(heartbeat, 500);
-    scheduler_add_task(read_encoders, 21);
-    scheduler_add_task(poll_buttons, 13);
+    /* budgets (us) cover the blocking printf of a typical event on the console UART */
+    scheduler_add_task("heartbeat", heartbeat, 500, TASK_PRIORITY_HIGH, 500);
+    scheduler_add_task("encoders", read_encoders, 21, TASK_PRIORITY_NORMAL, 5000);
+    scheduler_add_task("buttons", poll_buttons, 13, TASK_PRIORITY_NORMAL, 5000);
+    ui_init_tasks();
     // Add more tasks here
 }
 
@@ -0,0 +1,198 @@
+/*
+ * timebase.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "main.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "events.h"
+#include "profile.h"
+
+/*
+ * Tickless time base ... TIM4 counts at TIMEBASE_TICK_HZ with no interrupt per ms. The update interrupt (every
+ * 32.768 s) extends the 16-bit counter, ms = start + extended count / TIMEBASE_TICKS_PER_MS, so time wraps
+ * at 2^32 ms exactly like the SysTick counter it replaces. An overflow that has happened but not been serviced
+ * yet (UIF still set, counter just wrapped) is counted in by the reader, so the time never steps back.
+ *
+ * Channel 1 compare wakes the core at the earliest requested time ... the scheduler's next deadline (set by
+ * the compare interrupt itself after advancing the scheduler), every task or timer as it is armed (the main loop
+ * may be too busy to sleep for a while) and the main loop's own requests before it sleeps (next display frame).
+ * Requests only ever move the wake-up earlier. A compare value is 16 bits, so a wake-up more than 32.768 s away
+ * matches early ... the interrupt sees it isn't due and re-arms. A wake-up that is already due when programmed
+ * raises the compare interrupt by software.
+ *
+ * Until timebase_init() the HAL SysTick counter is the time base (HAL_Init() and clock setup time out on it),
+ * TIM4 time continues from it.
+ */
+
+#if TIMEBASE_USE_TICKLESS
+
+extern TIM_HandleTypeDef htim4;
+#define TIMEBASE_TIM            (htim4.Instance)
+#define TIMEBASE_HALF_PERIOD    (0x8000u)
+
+static volatile bool is_running = false;
+static volatile uint32_t overflows = 0;     // TIM4 update events since timebase_init() ... count bits 16 and up
+static uint32_t start_ms;                   // HAL tick when TIM4 took over
+static volatile bool is_wakeup_set = false;
+static volatile uint32_t wakeup_ms;
+static volatile uint32_t wakeups = 0;
+
+/* ms since timebase_init(), modulo 2^32 ... interrupts off, so overflows and UIF are read as a pair */
+static uint32_t timebase_elapsed_ms(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    uint32_t high = overflows;
+    uint32_t count = TIMEBASE_TIM->CNT;
+    if ((TIMEBASE_TIM->SR & TIM_SR_UIF) && count < TIMEBASE_HALF_PERIOD) {
+        high++;     // wrapped, update interrupt not serviced yet
+    }
+    __set_PRIMASK(primask);
+
+    /* (high * 65536 + count) / 2 ... bits above 2^32 ms drop out */
+    return (high << 15) | (count / TIMEBASE_TICKS_PER_MS);
+}
+
+/* put wakeup_ms in the compare register ... interrupts off */
+static void timebase_program_compare(void) {
+    TIMEBASE_TIM->CCR1 = (uint16_t)((wakeup_ms - start_ms) * TIMEBASE_TICKS_PER_MS);
+    if ((int32_t)(timebase_get_ms() - wakeup_ms) >= 0) {
+        TIMEBASE_TIM->EGR = TIM_EGR_CC1G;   // due already (or became due while writing) ... compare interrupt now
+    }
+}
+
+void timebase_init(void) {
+    TIM_TypeDef *tim = TIMEBASE_TIM;
+
+    /* MX_TIM4_Init() sets up the free-running count (prescaler for TIMEBASE_TICK_HZ, period 0xFFFF), stopped */
+    tim->CR1 = 0;
+    tim->DIER = 0;
+    tim->CCMR1 = 0;                         // CC1 output compare, frozen (no pin)
+    tim->CNT = 0;
+    tim->SR = 0;
+
+    __disable_irq();
+    overflows = 0;
+    is_wakeup_set = false;
+    wakeups = 0;
+    start_ms = uwTick;
+    tim->DIER = TIM_DIER_UIE | TIM_DIER_CC1IE;
+    tim->CR1 = TIM_CR1_CEN;
+    is_running = true;
+    HAL_SuspendTick();                      // no more 1 kHz interrupt
+    __enable_irq();
+}
+
+uint32_t timebase_get_ms(void) {
+    if (!is_running) {
+        return uwTick;
+    }
+    return start_ms + timebase_elapsed_ms();
+}
+
+/* HAL timeouts and HAL_Delay() run on the TIM4 time base once SysTick is stopped */
+uint32_t HAL_GetTick(void) {
+    return timebase_get_ms();
+}
+
+void timebase_tick(void) {
+}
+
+void timebase_request_wakeup(uint32_t at_ms) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (!is_wakeup_set || (int32_t)(at_ms - wakeup_ms) < 0) {
+        wakeup_ms = at_ms;
+        is_wakeup_set = true;
+        timebase_program_compare();
+    }
+    __set_PRIMASK(primask);
+}
+
+/* compare match ... advance scheduler, wake main loop, arm for the scheduler's next deadline */
+static void timebase_wakeup(void) {
+    uint32_t now = timebase_get_ms();
+    uint32_t deadline;
+
+    __disable_irq();
+    if (!is_wakeup_set) {
+        __enable_irq();
+        return;
+    }
+    if ((int32_t)(now - wakeup_ms) < 0) {
+        timebase_program_compare();     // 16-bit alias of a wake-up further out
+        __enable_irq();
+        return;
+    }
+    is_wakeup_set = false;
+    __enable_irq();
+
+    wakeups++;
+    scheduler_advance(now);
+    events_post(EVENT_TICK);
+    if (scheduler_get_next_deadline(&deadline)) {
+        timebase_request_wakeup(deadline);
+    }
+}
+
+/* whole TIM4 interrupt ... HAL_TIM_IRQHandler() after it would clear a flag raised meanwhile and lose that wake-up or overflow */
+void timebase_irq_handler(void) {
+    PROFILE_BEGIN(PROFILE_TIMEBASE_ISR);
+    TIM_TypeDef *tim = TIMEBASE_TIM;
+
+    /* UIF cleared and overflows counted as one step ... a higher priority reader (USART1 timestamps) sees either both or neither */
+    __disable_irq();
+    if (tim->SR & TIM_SR_UIF) {
+        __HAL_TIM_CLEAR_FLAG(&htim4, TIM_FLAG_UPDATE);
+        overflows++;
+    }
+    __enable_irq();
+
+    if (tim->SR & TIM_SR_CC1IF) {
+        __HAL_TIM_CLEAR_FLAG(&htim4, TIM_FLAG_CC1);
+        timebase_wakeup();
+    }
+    PROFILE_END(PROFILE_TIMEBASE_ISR);
+}
+
+uint32_t timebase_get_wakeups(void) {
+    return wakeups;
+}
+
+#else /* 1 kHz SysTick */
+
+static volatile uint32_t ms_counter = 0;
+static volatile uint32_t wakeups = 0;
+
+void timebase_init(void) {
+    ms_counter = uwTick;
+}
+
+uint32_t timebase_get_ms(void) {
+    return ms_counter;
+}
+
+void timebase_tick(void) {
+    ms_counter++;
+    wakeups++;
+    scheduler_tick();   // mark due tasks ready ... they run from main loop
+    events_post(EVENT_TICK);
+}
+
+void timebase_request_wakeup(uint32_t at_ms) {
+    (void)at_ms;        // SysTick wakes the core every ms anyway
+}
+
+void timebase_irq_handler(void) {
+}
+
+uint32_t timebase_get_wakeups(void) {
+    return wakeups;
+}
+
+#endif /* TIMEBASE_USE_TICKLESS */
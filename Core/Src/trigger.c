@@ -0,0 +1,198 @@
+/*
+ * trigger.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "stddef.h"
+#include "trigger.h"
+
+/*
+ * Pre/post-trigger capture ... evaluated once per posted packet from ui_post_packet_to_history().
+ *
+ * A trigger is a sequence of 1..TRIGGER_MAX_STEPS conditions that must match consecutive messages.
+ * Matched like a string search (Knuth-Morris-Pratt) ... after a mismatch the partial match falls back to the
+ * longest run of steps that is still matched (trigger_failure[], built when configured), so A,A,B fires on
+ * A,A,A,B. Conditions are compared field by field there: a step equal to an earlier one is the same symbol.
+ * Each message advances at most one step, so cost per message is constant amortised.
+ * On a complete match the next post_count records are captured, then the history is frozen with
+ * pre_count records kept ahead of the matching message.
+ *
+ * e.g. catch a note-on with velocity 0 on any channel:
+ *   TriggerCondition note_off = {0xF0, 0x90, 0, 0, 127, 0, 0};
+ *   trigger_configure(&note_off, 1, TRIGGER_DEFAULT_PRE_COUNT, TRIGGER_DEFAULT_POST_COUNT);
+ *   trigger_arm();
+ */
+
+typedef struct {
+	const char *name;
+	TriggerCondition condition;
+} TriggerPreset;
+
+/* single message triggers selectable from the console ... any channel, default window */
+static const TriggerPreset trigger_presets[] = {
+	{"All Notes Off (CC 123)", {0xF0, 0xB0, 0, 123, 123, 0, 127}},
+	{"All Sound Off (CC 120)", {0xF0, 0xB0, 0, 120, 120, 0, 127}},
+	{"Reset All Controllers (CC 121)", {0xF0, 0xB0, 0, 121, 121, 0, 127}},
+	{"Note on velocity 127", {0xF0, 0x90, 0, 0, 127, 127, 127}},
+	{"Program change", {0xF0, 0xC0, 0, 0, 127, 0, 127}}
+};
+
+static TriggerCondition trigger_steps[TRIGGER_MAX_STEPS];
+static uint8_t trigger_number_steps = 0;
+static uint8_t trigger_step = 0;			/* next condition to match */
+static uint8_t trigger_failure[TRIGGER_MAX_STEPS + 1];	/* steps still matched after a mismatch at step n */
+static uint32_t trigger_pre_count = TRIGGER_DEFAULT_PRE_COUNT;
+static uint32_t trigger_post_count = TRIGGER_DEFAULT_POST_COUNT;
+static uint32_t trigger_post_remaining = 0;
+static uint32_t trigger_sequence = 0;		/* sequence number of message completing the match */
+static TriggerState trigger_state = TRIGGER_DISARMED;
+
+static bool trigger_condition_matches(const TriggerCondition *condition, const stc_midi *ptr_packet)
+{
+	return (ptr_packet->running_status & condition->status_mask) == condition->status_value
+		&& (condition->channel == 0 || condition->channel == ptr_packet->channel)
+		&& ptr_packet->data[0] >= condition->data1_min && ptr_packet->data[0] <= condition->data1_max
+		&& ptr_packet->data[1] >= condition->data2_min && ptr_packet->data[1] <= condition->data2_max;
+}
+
+static bool trigger_condition_equals(const TriggerCondition *a, const TriggerCondition *b)
+{
+	return a->status_mask == b->status_mask && a->status_value == b->status_value && a->channel == b->channel
+		&& a->data1_min == b->data1_min && a->data1_max == b->data1_max
+		&& a->data2_min == b->data2_min && a->data2_max == b->data2_max;
+}
+
+/* trigger_failure[n] = longest proper prefix of steps 0..n-1 that is also a suffix of them */
+static void trigger_build_failure(void)
+{
+	uint8_t length = 0;
+
+	trigger_failure[0] = 0;
+	trigger_failure[1] = 0;
+	for(uint8_t i = 1; i < trigger_number_steps; i++)
+	{
+		while(0 != length && false == trigger_condition_equals(&trigger_steps[i], &trigger_steps[length]))
+			length = trigger_failure[length];
+		if(trigger_condition_equals(&trigger_steps[i], &trigger_steps[length]))
+			length++;
+		trigger_failure[i + 1] = length;
+	}
+}
+
+/* load default trigger (preset 0), armed if TRIGGER_DEFAULT_ENABLE */
+void trigger_init(void)
+{
+	trigger_load_preset(0);
+#if TRIGGER_DEFAULT_ENABLE
+	trigger_arm();
+#endif
+}
+
+uint8_t trigger_get_preset_count(void)
+{
+	return sizeof(trigger_presets) / sizeof(trigger_presets[0]);
+}
+
+const char* trigger_get_preset_name(uint8_t preset)
+{
+	return (preset < trigger_get_preset_count()) ? trigger_presets[preset].name : "";
+}
+
+/* load preset with default window ... leaves trigger disarmed */
+void trigger_load_preset(uint8_t preset)
+{
+	if(preset >= trigger_get_preset_count())
+		return;
+	trigger_configure(&trigger_presets[preset].condition, 1, TRIGGER_DEFAULT_PRE_COUNT, TRIGGER_DEFAULT_POST_COUNT);
+}
+
+/* set trigger sequence and window ... leaves trigger disarmed, pre_count + post_count must stay below history_capacity() */
+void trigger_configure(const TriggerCondition *steps, uint8_t number_steps, uint32_t pre_count, uint32_t post_count)
+{
+	if(number_steps > TRIGGER_MAX_STEPS)
+		number_steps = TRIGGER_MAX_STEPS;
+	for(uint8_t i = 0; i < number_steps; i++)
+		trigger_steps[i] = steps[i];
+	trigger_number_steps = number_steps;
+	trigger_build_failure();
+	trigger_pre_count = pre_count;
+	trigger_post_count = post_count;
+	trigger_state = TRIGGER_DISARMED;
+}
+
+void trigger_arm(void)
+{
+	if(0 == trigger_number_steps) /* nothing configured */
+		return;
+	trigger_step = 0;
+	trigger_state = TRIGGER_ARMED;
+}
+
+void trigger_disarm(void)
+{
+	trigger_state = TRIGGER_DISARMED;
+}
+
+/* new capture session ... arm again if trigger was in use */
+void trigger_rearm(void)
+{
+	if(TRIGGER_DISARMED != trigger_state)
+		trigger_arm();
+}
+
+/* evaluate packet just appended to history under sequence ... O(1) amortised */
+TriggerEvent trigger_process(const stc_midi *ptr_packet, uint32_t sequence)
+{
+	switch(trigger_state)
+	{
+		case TRIGGER_ARMED:
+			/* partial sequence broken ... fall back to the longest part still matched, this message may continue it */
+			while(0 != trigger_step && false == trigger_condition_matches(&trigger_steps[trigger_step], ptr_packet))
+				trigger_step = trigger_failure[trigger_step];
+			if(false == trigger_condition_matches(&trigger_steps[trigger_step], ptr_packet))
+				return TRIGGER_EVENT_NONE;
+			if(++trigger_step < trigger_number_steps)
+				return TRIGGER_EVENT_NONE;
+
+			trigger_sequence = sequence;
+			trigger_post_remaining = trigger_post_count;
+			trigger_state = TRIGGER_POST;
+			if(0 != trigger_post_remaining)
+				return TRIGGER_EVENT_MATCH;
+			trigger_state = TRIGGER_FROZEN;
+			return TRIGGER_EVENT_FROZEN;
+
+		case TRIGGER_POST:
+			if(--trigger_post_remaining != 0)
+				return TRIGGER_EVENT_NONE;
+			trigger_state = TRIGGER_FROZEN;
+			return TRIGGER_EVENT_FROZEN;
+
+		default:
+			return TRIGGER_EVENT_NONE;
+	}
+}
+
+TriggerState trigger_get_state(void)
+{
+	return trigger_state;
+}
+
+bool trigger_is_frozen(void)
+{
+	return TRIGGER_FROZEN == trigger_state;
+}
+
+uint32_t trigger_get_sequence(void)
+{
+	return trigger_sequence;
+}
+
+/* first sequence number of pre-trigger window ... free-running like the sequence numbers, may lie before the oldest
+ * retained record (match within pre_count records of session start), caller clamps to history_oldest() */
+uint32_t trigger_get_first_sequence(void)
+{
+	return trigger_sequence - trigger_pre_count;
+}
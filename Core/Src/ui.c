@@ -15,6 +15,8 @@
 #include "main.h"
 #include "filter_channels.h"
 #include "midi.h"
+#include "trigger.h"
+#include "scheduler.h"
 
 #include "string.h"
 
@@ -28,54 +30,177 @@
 
 #define ENABLE_CONSOLE_TEST 0
 
-/* macro to calculate true mathematical modulo, not c library remainder */
-#define MODULO(x, m) ((((x) % (m)) + (m)) % (m))
+/* LIVE view: 1 = newest line at bottom, older lines scrolled up by display start line (one page per message)
+ *            0 = page at a time, top to bottom, screen cleared when full */
+#define LIVE_HARDWARE_SCROLL 1
 
-/* my modulo macro to "wrap around" circular buffer */
-#define MYMODULO(x, m) ((x + m) % m)
+/* spacing of incremental fill steps after a jump ... one scroll screen line per step, main loop runs in between */
+#define SCROLL_FILL_STEP_MS	(1u)
+
+/* splash screen time after power-on ... capture is already running, a button or encoder ends it early */
+#define SPLASH_SCREEN_MS	(5000u)
+
+/* jump-to-time step per filter encoder detent (scroll button held) */
+#define TIME_JUMP_STEP_SECONDS	(1000u)
+#define TIME_JUMP_STEP_MINUTES	(60000u)
+
+/* rendered-line cache ... direct mapped on sequence number, holds more than one screen of consecutive records */
+#define LINE_CACHE_ENTRIES	(8u)	/* power of two */
+#define LINE_CACHE_WIDTH	(22u)	/* 21 characters + terminator */
+
+/* wrap-safe sequence number comparisons ... valid while compared sequence numbers are less than 2^31 apart */
+#define SEQUENCE_BEFORE(a, b)	((int32_t)((uint32_t)(a) - (uint32_t)(b)) < 0)
+#define SEQUENCE_AFTER(a, b)	((int32_t)((uint32_t)(a) - (uint32_t)(b)) > 0)
 
 static uint8_t display_line_pointer = FIRST_DISPLAY_LINE;
 static ScrollDirection scroll_direction_indicator = DOWN;
 
+/* all counts are free-running 32-bit values ... at 1000 messages/second they wrap after ~49 days */
 struct CaptureSession {
 	bool     is_capture_active;		// Whether a capture session is in progress
-	int16_t  midi_total_count;		// Total packet count, running total of midi packets
+	uint32_t midi_total_count;		// Total packet count, running total of midi packets
 	bool     has_rollover_occurred;	// Whether rollover of physical memory has occurred
-	uint8_t  number_rollovers;		// Number of rollovers that have occurred
-    uint16_t number_records;		// Number of records in physical memory (no rollover = total count, rollover = NUMBER_PAGES
-    uint16_t newest_index;			// Rollover-protected physical index for newest record
-    uint16_t oldest_index;			// Rollover-protected physical index for oldest
+	uint32_t number_rollovers;		// Number of rollovers that have occurred
+    uint32_t number_records;		// Number of records retained in history (no rollover = total count, rollover = history capacity)
+    uint32_t newest_sequence;		// Sequence number of newest record
+    uint32_t oldest_sequence;		// Sequence number of oldest retained record
+};
+
+/* what a scroll screen line shows ... lets a repaint skip lines that are already on screen */
+typedef enum {
+	SCROLL_LINE_BLANK = 0,
+	SCROLL_LINE_RECORD,
+	SCROLL_LINE_END
+} ScrollLineKind;
+
+struct ScrollLine {
+	ScrollLineKind kind;
+	uint32_t sequence;					// Sequence number of record shown (SCROLL_LINE_RECORD only)
 };
 
 struct ScrollSession {
 	bool     is_scroll_active;		// Whether a scroll session is in progress
 	bool	 is_scroll_at_end;		// Whether scroll wheel movement has reached end of history
-	int16_t  scroll_index;			// Rollover-protected physical index for scroll record-of-interest
-	uint16_t number_records;		// Count of midi packets in history at session entry (new packet arrival while in scroll accounted for in scroll_total_count)
-	uint16_t scroll_total_count;	// Local scroll session copy of total midi packet count ... for test if new packets have arrived
-	int16_t  display[LAST_DISPLAY_LINE]; // Holds scroll history indexes for painting display during scroll back/forward
-	int16_t  new_arrival_total;		// Additional count added to "LIVE" threshold while in scroll session
-	int16_t  delta_total;			// Total of all scroll wheel movements during session
-	int16_t  filtered_index;		// Index of record that matches channel filter
+	uint32_t scroll_sequence;		// Sequence number of scroll record-of-interest (top line of scroll screen)
+	uint32_t display[LAST_DISPLAY_LINE]; // Holds scroll history sequence numbers for painting display during scroll back/forward
+	uint8_t  display_count;			// Number of valid entries in display[] ... next line shows "End of history"
     ScrollDirection direction;  	// UI status line up/down arrow display direction indicator
+	bool     is_screen_known;		// Whether screen[] matches text area of display (false after LIVE drew over it)
+	struct ScrollLine screen[LAST_DISPLAY_LINE]; // What display lines 1..6 currently show
 };
 
 static struct CaptureSession capture_session = {0};
 static struct ScrollSession scroll_session = {0};
 
-stc_midi_history midi_history[NUMBER_PAGES]; /* declare history array */
+/* formatted text of recently displayed history records ... scrolling one line formats one new record */
+struct LineCacheEntry {
+	bool     is_valid;
+	uint32_t sequence;
+	char     text[LINE_CACHE_WIDTH];
+};
+
+static struct LineCacheEntry line_cache[LINE_CACHE_ENTRIES];
+
+static uint32_t time_jump_target = 0;	/* jump-to-time target, ms relative to session start */
+static uint32_t time_jump_step = TIME_JUMP_STEP_SECONDS;
+
+static TaskId scroll_fill_timer = SCHEDULER_NO_TASK;	/* one-shot, runs ui_fill_display() ... re-armed once per line */
+
+/*
+ * resumable fill of the scroll screen after a jump (protothread style, state lives here instead of on the stack)
+ * each ui_fill_display() run paints at most one line and re-arms the one-shot, so FIFO draining, packets and
+ * other tasks get main loop passes between lines. A new jump restarts the fill, a scroll detent or LIVE cancels it
+ */
+struct ScrollFill {
+	bool     is_pending;			// Whether lines are left to paint
+	uint8_t  next_line;				// Next scroll screen line to bring up to date
+	uint32_t started;				// Fills started (jumps)
+	uint32_t completed;				// Fills that reached the last line
+	uint32_t cancelled;				// Fills abandoned by a scroll detent, a newer jump or LIVE
+};
 
-extern TIM_HandleTypeDef htim4;
-extern volatile bool timeoutFlag;
+static struct ScrollFill scroll_fill = {0};
 
-/* declare and assign pointer to history array (will be used to access history) */
-stc_midi_history* ptr_history;
+static TaskId splash_timer = SCHEDULER_NO_TASK;		/* one-shot, runs ui_end_splash() */
 
 int32_t scroll_bar_movement_ratio = (SCROLL_BAR_MAX_VERTICAL_SIZE * 1024 / NUMBER_PAGES);
 
+/* retrieve history record by sequence number */
+static const stc_midi_history* ui_get_record(uint32_t sequence)
+{
+	static stc_midi_history record;
+
+	if(false == history_read(sequence, &record))
+		record = (stc_midi_history){0};
+	return &record;
+}
+
+/*
+ * build display string for history record ... served from line cache when record was formatted recently
+ * cached text depends on record only (not on channel filter), evicted records always miss
+ */
+static char* ui_format_record(uint32_t sequence)
+{
+	struct LineCacheEntry *entry = &line_cache[sequence & (LINE_CACHE_ENTRIES - 1)];
+
+	if(entry->is_valid && entry->sequence == sequence && !SEQUENCE_BEFORE(sequence, capture_session.oldest_sequence))
+		return entry->text;
+
+	const stc_midi_history *record = ui_get_record(sequence);
+	char *text = midi_process_message(record->running_status, record->data[0], record->data[1]);
+
+	strncpy(entry->text, text, LINE_CACHE_WIDTH - 1);
+	entry->text[LINE_CACHE_WIDTH - 1] = '\0';
+	entry->sequence = sequence;
+	entry->is_valid = true;
+	return entry->text;
+}
+
+/* drop all cached lines ... sequence numbers restart with every new session */
+static void ui_invalidate_line_cache(void)
+{
+	for(uint8_t i = 0; i < LINE_CACHE_ENTRIES; i++)
+		line_cache[i].is_valid = false;
+}
+
+static bool ui_is_record_filtered_in(uint32_t sequence)
+{
+	return filter_getChannel() == 0 || filter_getChannel() == ui_get_record(sequence)->channel;
+}
+
+/* register ui timers with scheduler ... call once from tasks_init() */
+void ui_init_tasks(void)
+{
+	scroll_fill_timer = scheduler_add_timer("scroll fill", ui_fill_display, TASK_PRIORITY_LOW, 5000);
+	splash_timer = scheduler_add_timer("splash", ui_end_splash, TASK_PRIORITY_LOW, 5000);
+}
+
+/* paint splash screen without blocking ... main loop keeps draining rxFIFO, packets go to history until ui_end_splash() */
+void ui_show_splash(void)
+{
+	app_set_state(APP_STATE_SPLASH);
+	display_clear_screen(Black);
+	display_splash_screen();
+	scheduler_start_timer(splash_timer, SPLASH_SCREEN_MS);
+}
+
+/* splash timeout, button or encoder ... paint opening screen, newest packet captured meanwhile shows up in LIVE */
+void ui_end_splash(void)
+{
+	if(APP_STATE_SPLASH != app_get_state())
+		return;
+
+	scheduler_stop_timer(splash_timer);
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	display_start_screen();
+	if(capture_session.is_capture_active)
+		ui_restore_display();
+	else
+		ui_draw_scroll_bar(1, SSD1306_HEIGHT, ABSOLUTE, White, false); /* initial scroll bar, as ui_initialize_ui() */
+}
+
 uint16_t ui_initialize_ui(void)
 {
-	ptr_history = midi_history; /* initialize pointer to first element of history array */
 	display_line_pointer = FIRST_DISPLAY_LINE;
 
 	ui_draw_scroll_bar(1, SSD1306_HEIGHT, ABSOLUTE, White, false); /* draw an initial scroll bar ... single row of pixels at bottom of scroll bar area */
@@ -83,19 +208,12 @@ uint16_t ui_initialize_ui(void)
 
 	capture_session = (struct CaptureSession){0};
 	scroll_session = (struct ScrollSession){0};
-
-	/* initialize history */
-	for(uint16_t i = 0; i < NUMBER_PAGES; i++)
-	{
-		ptr_history->packetID = i; /* page identifier (permanent index to this array element) */
-		ptr_history++; /* move to next array element */
-	}
-
-	ptr_history = midi_history; /* reposition pointer to first element of history array */
+	ui_invalidate_line_cache();
 
 	__HAL_TIM_SET_COUNTER(&htim2, 0); /* reset scroll encoder counter */
+	trigger_rearm(); /* new session unfreezes history */
 
-	return sizeof(midi_history) / sizeof(stc_midi_history); /* confirm total number of elements */
+	return history_init(NULL); /* empty history on current backend, confirm total number of elements */
 }
 
 void ui_process_midi_packet(stc_midi* ptr_packet)
@@ -107,34 +225,34 @@ void ui_process_midi_packet(stc_midi* ptr_packet)
 
 void ui_post_packet_to_history(stc_midi* ptr_packet)
 {
+	/* trigger window captured ... history frozen until new session, packets still shown in LIVE */
+	if(trigger_is_frozen())
+		return;
+
 	/* post to history - put packet in history regardless of APP_STATE or channel filter setting */
-	ptr_history->time_stamp = ptr_packet->time_stamp;
-	ptr_history->channel = ptr_packet->channel;
-	ptr_history->running_status = ptr_packet->running_status;
-	ptr_history->data[0] = ptr_packet->data[0];
-	ptr_history->data[1] = ptr_packet->data[1];
-
-	ptr_history++; /* move history pointer to next position in circular history buffer */
-	/* check for circular rollover */
-	if(ptr_history >= &midi_history[NUMBER_PAGES])
+	uint32_t sequence = history_append(ptr_packet);
+
+	/* window captured ... keep pre-trigger records only (console reports match and freeze from main loop) */
+	if(TRIGGER_EVENT_FROZEN == trigger_process(ptr_packet, sequence))
 	{
-		ptr_history = midi_history; /* reset pointer to beginning */
+		uint32_t first_sequence = trigger_get_first_sequence();
+
+		if(SEQUENCE_BEFORE(first_sequence, history_oldest())) /* fewer than pre_count records before match */
+			first_sequence = history_oldest();
+		history_evict_before(first_sequence);
 	}
 
 	/* update capture session statistics */
 	capture_session.midi_total_count++;
 	capture_session.is_capture_active = true;
-	if(capture_session.midi_total_count >= NUMBER_PAGES)
+	if(capture_session.midi_total_count >= history_capacity())
 	{
 		capture_session.has_rollover_occurred = true;
-		capture_session.number_rollovers = capture_session.midi_total_count/NUMBER_PAGES;
+		capture_session.number_rollovers = capture_session.midi_total_count / history_capacity();
 	}
-	capture_session.number_records = capture_session.has_rollover_occurred ? NUMBER_PAGES : capture_session.midi_total_count;
-	capture_session.newest_index = MODULO(capture_session.midi_total_count - 1, NUMBER_PAGES);
-	if(false == capture_session.has_rollover_occurred)
-		capture_session.oldest_index = 0;
-	else
-		capture_session.oldest_index = MODULO(capture_session.newest_index + 1, NUMBER_PAGES);
+	capture_session.number_records = history_count();
+	capture_session.newest_sequence = history_newest();
+	capture_session.oldest_sequence = history_oldest();
 }
 
 void ui_post_packet_to_display(stc_midi* ptr_packet)
@@ -143,16 +261,24 @@ void ui_post_packet_to_display(stc_midi* ptr_packet)
 	{
 		case APP_STATE_MIDI_DISPLAY:
 			/* process scroll bar */
-			float height = (float)MODULO(capture_session.midi_total_count, NUMBER_PAGES) / NUMBER_PAGES;
-			ui_draw_scroll_bar(height, 0, PERCENT, (capture_session.number_rollovers + 1) % 2, capture_session.number_rollovers);
+			float height = (float)(capture_session.midi_total_count % history_capacity()) / history_capacity();
+			ui_draw_scroll_bar(height, 0, PERCENT, (capture_session.number_rollovers + 1) % 2, capture_session.number_rollovers != 0);
 
 			/* post to display if channel filter matches and uart FIFO is less than 12.5% full */
-			if((fifo_count < UART_FIFO_SIZE >> 3) && (filter_getChannel() == 0 || filter_getChannel() == ptr_packet->channel))
+			if((fifo_count < UART_FIFO_BACKLOG_THRESHOLD) && (filter_getChannel() == 0 || filter_getChannel() == ptr_packet->channel))
 			{
 				/* put relative midi session timestamp on status line */
 				uint32_t midi_delta_timestamp = session_getDeltaTime(ptr_packet->time_stamp);
-				display_status(display_getMode(), midi_delta_timestamp, 0, ui_get_scroll_direction_indicator());
+				if(trigger_is_frozen()) /* notify ui ... trigger window held in history, scroll to inspect */
+					display_string_to_status_line("TRIG frozen", 0);
+				else
+					display_status(display_getMode(), midi_delta_timestamp, 0, ui_get_scroll_direction_indicator());
+				scroll_session.is_screen_known = false; /* text area no longer holds scroll screen */
 
+#if LIVE_HARDWARE_SCROLL
+				/* newest record at bottom, older ones move up */
+				display_live_line(midi_process_message(ptr_packet->running_status, ptr_packet->data[0], ptr_packet->data[1]));
+#else
 				if(FIRST_DISPLAY_LINE == display_line_pointer) /* display is full, create new blank page */
 					display_clear_page(Black);
 
@@ -177,6 +303,7 @@ void ui_post_packet_to_display(stc_midi* ptr_packet)
 				display_line_pointer++; /* move display pointer for next arrival */
 				if(display_line_pointer > LAST_DISPLAY_LINE)
 					display_line_pointer = FIRST_DISPLAY_LINE;
+#endif
 			}
 			else /* animate new data arrival indicator to notify ui of non-matching data arrival in background */
 			{
@@ -204,76 +331,233 @@ void ui_post_packet_to_display(stc_midi* ptr_packet)
 //			ssd1306_UpdateScreen();
 			break;
 
+		case APP_STATE_SPLASH: /* leave splash screen alone ... LIVE catches up in ui_end_splash() */
+			return;
+
 		default:
 			break;
 	}
 
 	/* display horizontal fifo utilization bar */
-	ssd1306_DrawRectangle(0, SSD1306_HEIGHT - 1, fifo_count / (UART_FIFO_SIZE/SSD1306_WIDTH), SSD1306_HEIGHT - 1, White);
-	ssd1306_DrawRectangle(fifo_count / (UART_FIFO_SIZE/SSD1306_WIDTH), SSD1306_HEIGHT - 1, SSD1306_WIDTH - 4, SSD1306_HEIGHT - 1, Black);
-	ssd1306_UpdateScreen();
+	display_fifo_bar(fifo_count / (UART_FIFO_SIZE/SSD1306_WIDTH));
 }
 
-int16_t ui_get_filtered_record_index(int16_t index, uint16_t number_records_to_check, ScrollDirection direction)
+/* search from *sequence (inclusive) toward older (DOWN) or newer (UP) records for a record matching channel filter */
+bool ui_get_filtered_record(uint32_t *sequence, ScrollDirection direction)
 {
-	/* search for next record matching channel filter */
-	int16_t filtered_index = index;
-	if(0 == number_records_to_check)
-		number_records_to_check = capture_session.has_rollover_occurred ? capture_session.midi_total_count : NUMBER_PAGES;
-	for(uint16_t i = 0; i < number_records_to_check; i++)
+	uint32_t candidate = *sequence;
+
+	if(0 == capture_session.number_records)
+		return false;
+	if(SEQUENCE_BEFORE(candidate, capture_session.oldest_sequence)) /* clamp search to retained history */
+	{
+		if(DOWN == direction)
+			return false;
+		candidate = capture_session.oldest_sequence;
+	}
+	if(SEQUENCE_AFTER(candidate, capture_session.newest_sequence))
+	{
+		if(UP == direction)
+			return false;
+		candidate = capture_session.newest_sequence;
+	}
+
+	while(true)
 	{
+		if(ui_is_record_filtered_in(candidate))
+		{
+			*sequence = candidate; /* matching channel found, return sequence number of matching record */
+			return true;
+		}
 		if(DOWN == direction)
-			filtered_index = MYMODULO((index - i), NUMBER_PAGES);
+		{
+			if(candidate == capture_session.oldest_sequence)
+				return false;
+			candidate--;
+		}
 		else
-			filtered_index = MYMODULO((index + 2 + i), NUMBER_PAGES);
-		if(filter_getChannel() == 0 || filter_getChannel() == midi_history[filtered_index].channel)
-			return filtered_index; /* matching channel found, return index of matching record */
+		{
+			if(candidate == capture_session.newest_sequence)
+				return false;
+			candidate++;
+		}
+	}
+}
+
+/* line i (0 = record-of-interest) of scroll screen per scroll_session.display[] ... "End of history" follows last retained record */
+static struct ScrollLine ui_get_scroll_line(uint8_t i)
+{
+	for(uint8_t j = 0; j <= i; j++)
+	{
+		if(j >= scroll_session.display_count || SEQUENCE_BEFORE(scroll_session.display[j], capture_session.oldest_sequence)) /* end of history reached (or overwritten) */
+			return (struct ScrollLine){j == i ? SCROLL_LINE_END : SCROLL_LINE_BLANK, 0};
+	}
+	return (struct ScrollLine){SCROLL_LINE_RECORD, scroll_session.display[i]};
+}
+
+/* bring line i of scroll screen up to date ... nothing is drawn (returns false) if it already shows the right thing */
+static bool ui_paint_scroll_line(uint8_t i)
+{
+	struct ScrollLine line = ui_get_scroll_line(i);
+
+	if(line.kind == scroll_session.screen[i].kind && line.sequence == scroll_session.screen[i].sequence)
+		return false;
+	if(SCROLL_LINE_BLANK != scroll_session.screen[i].kind) /* ceol stops short of 21st character column */
+		display_clear_line(i + 1);
+
+	switch(line.kind)
+	{
+		case SCROLL_LINE_RECORD:
+			/* use scroll_session.display[] sequence numbers for retrieval (already channel filtered) */
+			display_string(ui_format_record(line.sequence), i + 1, 0, White, true);
+			break;
+		case SCROLL_LINE_END:
+			display_string("End of history", i + 1, 0, White, true);
+			break;
+		default:
+			break;
+	}
+	scroll_session.screen[i] = line;
+	return true;
+}
+
+/*
+ * move scroll screen text by lines (> 0 = down, list moved toward newer records) in the framebuffer ... lines
+ * still on screen are kept, lines moved in come up blank. Unknown screen (or move of a whole screen) is cleared
+ */
+static void ui_shift_scroll_screen(int16_t lines)
+{
+	if(false == scroll_session.is_screen_known || lines >= (int16_t)LAST_DISPLAY_LINE || lines <= -(int16_t)LAST_DISPLAY_LINE)
+	{
+		display_clear_page(Black);
+		for(uint8_t i = 0; i < LAST_DISPLAY_LINE; i++)
+			scroll_session.screen[i] = (struct ScrollLine){SCROLL_LINE_BLANK, 0};
+		scroll_session.is_screen_known = true;
+		return;
+	}
+	if(0 == lines)
+		return;
+
+	display_shift_lines(lines);
+	if(lines > 0)
+	{
+		for(uint8_t i = LAST_DISPLAY_LINE; i-- > 0;)
+			scroll_session.screen[i] = (i >= lines) ? scroll_session.screen[i - lines] : (struct ScrollLine){SCROLL_LINE_BLANK, 0};
+	}
+	else
+	{
+		for(uint8_t i = 0; i < LAST_DISPLAY_LINE; i++)
+			scroll_session.screen[i] = (i - lines < (int16_t)LAST_DISPLAY_LINE) ? scroll_session.screen[i - lines] : (struct ScrollLine){SCROLL_LINE_BLANK, 0};
 	}
-	return NUMBER_PAGES + 1; /* default return value for "no records found" */
 }
 
+/* (re)start incremental fill from line 1 ... an unfinished fill is abandoned, its lines are repainted as needed */
+static void ui_start_fill(void)
+{
+	if(scroll_fill.is_pending)
+		scroll_fill.cancelled++;
+	scroll_fill.is_pending = true;
+	scroll_fill.next_line = FIRST_DISPLAY_LINE;
+	scroll_fill.started++;
+	scheduler_start_timer(scroll_fill_timer, SCROLL_FILL_STEP_MS);
+}
+
+/* abandon unfinished fill ... screen was completed another way (scroll detent) or left (LIVE) */
+static void ui_cancel_fill(void)
+{
+	scheduler_stop_timer(scroll_fill_timer);
+	if(scroll_fill.is_pending)
+		scroll_fill.cancelled++;
+	scroll_fill.is_pending = false;
+}
+
+/*
+ * deferred fill (one-shot timer) after a jump ... one step paints the next line not drawn by ui_paint_scroll_record()
+ * lines already up to date are skipped without drawing, so each step costs at most one formatted line
+ */
 void ui_fill_display(void)
 {
-	int16_t filtered_index = scroll_session.filtered_index; /* use filtered index to begin channel filter search */
-	for(uint8_t i = 1; i < LAST_DISPLAY_LINE; i++) /* process next/last 5 lines of display */
+	if(false == scroll_fill.is_pending)
+		return;
+	if(false == scroll_session.is_scroll_active) /* back in LIVE before fill finished */
 	{
-		if(scroll_session.display[i] > NUMBER_PAGES) /* no need to go any further ... end of history reached */
-		{
-		  display_string("End of history", i + 1, 0, White, true);
-		  return;
-		}
+		ui_cancel_fill();
+		return;
+	}
 
-		if(filter_getChannel() == 0) /* no channel filter in place, retrieve all records */
-		{
-			/* use scroll_session.display[] indexes for retrieval */
-			display_string(midi_process_message(midi_history[scroll_session.display[i]].running_status, midi_history[scroll_session.display[i]].data[0], midi_history[scroll_session.display[i]].data[1]), i + 1, 0, White, true);
-		}
-		else /* look for records matching channel filter setting */
+	while(scroll_fill.next_line < LAST_DISPLAY_LINE)
+	{
+		if(ui_paint_scroll_line(scroll_fill.next_line++))
+			break; /* one line painted ... yield to main loop */
+	}
+
+	if(scroll_fill.next_line < LAST_DISPLAY_LINE)
+		scheduler_start_timer(scroll_fill_timer, SCROLL_FILL_STEP_MS); /* resume with next line */
+	else
+	{
+		scroll_fill.is_pending = false;
+		scroll_fill.completed++;
+	}
+}
+
+/* fills started/completed/cancelled since reset ... for console report */
+void ui_get_fill_stats(uint32_t *started, uint32_t *completed, uint32_t *cancelled)
+{
+	*started = scroll_fill.started;
+	*completed = scroll_fill.completed;
+	*cancelled = scroll_fill.cancelled;
+}
+
+/*
+ * paint scroll screen for scroll_session.scroll_sequence ... status line, scroll bar and text lines
+ * lines_moved = lines the list moved since last paint (> 0 toward newer), text already on screen is shifted
+ * instead of redrawn. paint_all = false paints record-of-interest only (ui_fill_display() fills the rest line by line, used by jumps)
+ */
+static void ui_paint_scroll_record(int16_t lines_moved, bool paint_all)
+{
+	ui_fill_scroll_display_buffer(scroll_session.scroll_sequence); /* fill display buffer while sequence numbers are known */
+	scroll_session.is_scroll_at_end = (1 == scroll_session.display_count);
+
+	app_set_state(APP_STATE_SCROLL_HISTORY);
+
+	/* animate scroll bar segment to indicate relative location of current screen within history */
+	uint32_t relative_index = scroll_session.scroll_sequence - capture_session.oldest_sequence;
+	int16_t scroll_segment_size = capture_session.number_records < LAST_DISPLAY_LINE ? capture_session.number_records : LAST_DISPLAY_LINE;
+	int16_t scroll_bar_segment_position;
+	scroll_bar_movement_ratio = (SCROLL_BAR_MAX_VERTICAL_SIZE * 1024 / capture_session.number_records);
+	scroll_bar_segment_position = SCROLL_BAR_TOP_PIXEL_POSITION + (((capture_session.number_records - 1) - relative_index) * scroll_bar_movement_ratio)/1024 + LAST_DISPLAY_LINE;
+	ui_draw_scroll_bar(scroll_segment_size - 1, scroll_bar_segment_position, ABSOLUTE, White, false);
+
+	/* build recalled record for display */
+	uint32_t midi_delta_timestamp = session_getDeltaTime(ui_get_record(scroll_session.scroll_sequence)->time_stamp);
+	/* prepare display/screen for requested scroll history */
+	ui_shift_scroll_screen(lines_moved);
+
+	/* record-of-interest already matches channel filter setting, retrieve and display record */
+	display_status(INDEX, midi_delta_timestamp, relative_index, scroll_session.direction);
+	for(uint8_t i = 0; i < LAST_DISPLAY_LINE; i++)
+	{
+		if(true == paint_all || 0 == i || SCROLL_LINE_END == ui_get_scroll_line(i).kind)
+			ui_paint_scroll_line(i);
+		else if(SCROLL_LINE_BLANK != scroll_session.screen[i].kind) /* stale line ... blank until deferred fill */
 		{
-			uint16_t number_records_to_search = (filtered_index + NUMBER_PAGES - capture_session.oldest_index) % NUMBER_PAGES;
-			filtered_index = ui_get_filtered_record_index(filtered_index, number_records_to_search, DOWN); /* always search down from here */
-			if(filtered_index > NUMBER_PAGES)
-			{
-				/* no record(s) found or reached end of history */
-				display_string("End of history", i + 1, 0, White, true);
-				return;
-			}
-			else
-			{
-				/* matching record found */
-				display_string(midi_process_message(midi_history[filtered_index].running_status, midi_history[filtered_index].data[0], midi_history[filtered_index].data[1]), i + 1, 0, White, true);
-				filtered_index -= 1; /* start next search after the current one */
-			}
+			display_clear_line(i + 1);
+			scroll_session.screen[i] = (struct ScrollLine){SCROLL_LINE_BLANK, 0};
 		}
 	}
 }
 
-/* abbreviated history during scroll due to oled i2c sluggishness, tim4 timeout will scroll rest of screen history */
+/*
+ * one matching record per detent ... the text already on screen is shifted by one line in the framebuffer and
+ * only the newly exposed line is drawn, so every detent shows a complete screen (partial flush sends the change)
+ */
 void ui_scroll_history(int16_t delta)
 {
-	char temp_buffer[16];
+	char temp_buffer[24];
+	uint32_t sequence;
+	int16_t lines_moved = 0;
 
-	if(0 == capture_session.midi_total_count) /* History is empty ... no midi packets received yet, just report message */
+	if(0 == capture_session.number_records) /* History is empty ... no midi packets received yet, just report message */
 	{
 		display_string("History is empty", 3, 0, White, true);
 		return;
@@ -288,191 +572,112 @@ void ui_scroll_history(int16_t delta)
 				/* do nothing ... can't scroll past current (i.e. newest) index */
 				return;
 			}
-			else /* <-- ccw scroll wheel rotation */
+			/* <-- ccw scroll wheel rotation ... first detent recalls newest (matching) record */
+			sequence = capture_session.newest_sequence;
+			if(false == ui_get_filtered_record(&sequence, DOWN))
 			{
-				scroll_session.is_scroll_active = true; /* first entry into scroll session ... change states to active */
-				scroll_session.scroll_total_count = capture_session.midi_total_count; /* get capture session total count ... will be used to determine if new data arrived while in scroll */
-				scroll_session.number_records = capture_session.number_records; /* set scroll session number of records at entry ... will anchor "end of history" */
-				scroll_session.new_arrival_total = 0;
-				scroll_session.direction = DOWN;
-				ui_set_scroll_direction_indicator(DOWN);
-				scroll_session.scroll_index = capture_session.newest_index + 1; /* first entry into scroll session, set scroll index to newest capture session index */
-				scroll_session.delta_total = delta; /* scroll wheel delta movements will be used to confine scrolling to newest<>oldest range */
-				scroll_session.scroll_index += delta; /* move scroll index to requested record */
-				scroll_session.filtered_index = scroll_session.scroll_index; /* copy index to filtered index ... used later for channel filtering */
-				ui_fill_scroll_display_buffer(scroll_session.scroll_index, scroll_session.number_records + scroll_session.delta_total + 1); /* fill display buffer while indexes are known */
+				/* no matching records found */
+				sprintf(temp_buffer, "%lu No match", (unsigned long)capture_session.number_records);
+				display_string_to_status_line(temp_buffer, 0);
+				return;
 			}
+			scroll_session.is_scroll_active = true; /* first entry into scroll session ... change states to active */
+			scroll_session.scroll_sequence = sequence;
+			scroll_session.direction = DOWN;
+			ui_set_scroll_direction_indicator(DOWN);
+			delta++; /* first detent consumed by entry */
 		}
-		else /* scroll session is already active */
+		else if(SEQUENCE_BEFORE(scroll_session.scroll_sequence, capture_session.oldest_sequence))
 		{
-			scroll_session.delta_total += delta;
-			if(scroll_session.scroll_total_count != capture_session.midi_total_count)
-			{
-				/* new data has arrived while in scroll session */
-				scroll_session.new_arrival_total = capture_session.midi_total_count - scroll_session.scroll_total_count;
-				scroll_session.scroll_total_count = capture_session.midi_total_count; /* update local copy for next test */
-			}
-			if(delta > 0) /* --> cw scroll wheel rotation */
-			{
-				scroll_session.is_scroll_at_end = false;
-				if(scroll_session.delta_total >= 0 + scroll_session.new_arrival_total)
-				{
-					/* return to LIVE mode ... can't scroll past current (i.e. newest) index */
-
-					/* kill oneshot timer if app_state back to LIVE */
-					HAL_TIM_Base_Stop_IT(&htim4);
-					__HAL_TIM_SET_COUNTER(&htim4, 0);
-					timeoutFlag = false;
-
-					display_clear_page(Black);
-					app_set_state(APP_STATE_MIDI_DISPLAY);
-					scroll_session.is_scroll_active = false;
-					display_setMode(LIVE);
-					ui_restore_display();
-					return;
-				}
-				else /* scroll up from session index */
-				{
-					scroll_session.direction = UP;
-					ui_set_scroll_direction_indicator(UP);
-					scroll_session.scroll_index = scroll_session.scroll_index + delta; /* move scroll index to requested record */
-					ui_fill_scroll_display_buffer(scroll_session.scroll_index, scroll_session.number_records + scroll_session.delta_total); /* fill display buffer while indexes are known */
-				}
-			}
-			else /* <-- ccw scroll wheel rotation */
-			{
-				if(scroll_session.delta_total <= 0 - scroll_session.number_records) /* reached end of history ... (capture_session.oldest_index - offset + NUMBER_PAGES) % NUMBER_PAGES) ... no more records to display */
-				{
-					/* post oldest message but set flag ... can't scroll past oldest */
-					scroll_session.delta_total = 1 - scroll_session.number_records;
-					scroll_session.scroll_index = capture_session.oldest_index; /* move scroll index to oldest record */
-					scroll_session.is_scroll_at_end = true;
-					ui_fill_scroll_display_buffer(scroll_session.scroll_index, scroll_session.number_records + scroll_session.delta_total); /* fill display buffer while indexes are known */
-				}
-				else /* scroll down from session index, adjust scroll index based on delta */
-				{
-					scroll_session.direction = DOWN;
-					ui_set_scroll_direction_indicator(DOWN);
-					scroll_session.scroll_index = scroll_session.scroll_index + delta; /* move scroll index to requested record */
-					ui_fill_scroll_display_buffer(scroll_session.scroll_index, scroll_session.number_records + scroll_session.delta_total + 1); /* fill display buffer while indexes are known */
-				}
-			}
+			scroll_session.scroll_sequence = capture_session.oldest_sequence; /* record-of-interest was overwritten while in scroll */
 		}
 
-		/* finish scroll tasks */
-		app_set_state(APP_STATE_SCROLL_HISTORY);
-
-		/* animate scroll bar segment to indicate relative location of current screen within history */
-		int16_t scroll_segment_size = scroll_session.number_records < LAST_DISPLAY_LINE ? scroll_session.number_records : LAST_DISPLAY_LINE;
-		int16_t scroll_bar_segment_position;
-		if(false == capture_session.has_rollover_occurred)
-		{
-			scroll_bar_movement_ratio = (SCROLL_BAR_MAX_VERTICAL_SIZE * 1024 / scroll_session.number_records);
-			scroll_bar_segment_position = SCROLL_BAR_TOP_PIXEL_POSITION + (((scroll_session.number_records - 1) - MYMODULO(scroll_session.scroll_index - capture_session.oldest_index, NUMBER_PAGES)) * scroll_bar_movement_ratio)/1024 + LAST_DISPLAY_LINE;
-		}
-		else
+		/* move record-of-interest one matching record per detent ... sequence numbers are unaffected by new arrivals */
+		scroll_session.is_scroll_at_end = false;
+		for(; delta > 0; delta--) /* --> cw scroll wheel rotation, scroll up toward newest */
 		{
-			scroll_bar_movement_ratio = (SCROLL_BAR_MAX_VERTICAL_SIZE * 1024 / NUMBER_PAGES);
-			scroll_bar_segment_position = SCROLL_BAR_TOP_PIXEL_POSITION + (((NUMBER_PAGES - 1) - MYMODULO(scroll_session.scroll_index - capture_session.oldest_index, NUMBER_PAGES)) * scroll_bar_movement_ratio)/1024 + LAST_DISPLAY_LINE;
-		}
-		if(scroll_session.delta_total < 0) /* clamp scroll bar upward movement if new data has arrived while in scroll */
-			ui_draw_scroll_bar(scroll_segment_size - 1, scroll_bar_segment_position, ABSOLUTE, White, false);
-
-		/* build recalled record for display */
-		uint32_t midi_delta_timestamp = session_getDeltaTime(midi_history[MYMODULO(scroll_session.scroll_index, NUMBER_PAGES)].time_stamp);
-		/* prepare display/screen for requested scroll history */
-		display_clear_page(Black);
-
-		/* TODO ... if channel filter not "ALL", search for first matching record. only display "No match" if end of history reached */
-
-		if(filter_getChannel() == 0) /* only display records that match channel filter setting */
-		{
-			/* no channel filter in place, retrieve and display record */
-			display_status(INDEX, midi_delta_timestamp, MYMODULO(scroll_session.scroll_index - capture_session.oldest_index, NUMBER_PAGES), scroll_session.direction);
-			display_string(midi_process_message(midi_history[MYMODULO(scroll_session.scroll_index, NUMBER_PAGES)].running_status, midi_history[MYMODULO(scroll_session.scroll_index, NUMBER_PAGES)].data[0], midi_history[MYMODULO(scroll_session.scroll_index, NUMBER_PAGES)].data[1]), 1, 0, White, true);
-		}
-		else /* search for first record matching channel filter setting */
-		{
-			/* Note - scroll_session.filtered_index was set equal to scroll_session.scroll_index upon first entry into scroll session (see above) */
-			scroll_session.filtered_index = ui_get_filtered_record_index(MYMODULO(scroll_session.filtered_index, NUMBER_PAGES), 0, scroll_session.direction); /* search for record matching channel filter setting */
-			if(scroll_session.filtered_index < NUMBER_PAGES)
-			{
-				/* record found ... retrieve and display record */
-				midi_delta_timestamp = session_getDeltaTime(midi_history[MYMODULO(scroll_session.filtered_index, NUMBER_PAGES)].time_stamp);
-				display_status(INDEX, midi_delta_timestamp, MYMODULO(scroll_session.filtered_index - capture_session.oldest_index, NUMBER_PAGES), scroll_session.direction);
-				display_string(midi_process_message(midi_history[MYMODULO(scroll_session.filtered_index, NUMBER_PAGES)].running_status, midi_history[MYMODULO(scroll_session.filtered_index, NUMBER_PAGES)].data[0], midi_history[MYMODULO(scroll_session.filtered_index, NUMBER_PAGES)].data[1]), 1, 0, White, true);
-				scroll_session.filtered_index -= 1; /* move past this occurrence for next search */
-			}
-			else
+			scroll_session.direction = UP;
+			ui_set_scroll_direction_indicator(UP);
+			sequence = scroll_session.scroll_sequence + 1;
+			if(SEQUENCE_AFTER(sequence, capture_session.newest_sequence) || false == ui_get_filtered_record(&sequence, UP))
 			{
-				/* no matching records found */
-				sprintf(temp_buffer, "%d No match", MYMODULO(scroll_session.scroll_index, NUMBER_PAGES));
-				display_string_to_status_line(temp_buffer, 0);
+				/* return to LIVE mode ... can't scroll past current (i.e. newest) index */
+
+				display_clear_page(Black);
+				app_set_state(APP_STATE_MIDI_DISPLAY);
+				scroll_session.is_scroll_active = false;
+				scroll_session.is_screen_known = false;
+				display_setMode(LIVE);
+				ui_restore_display();
+				return;
 			}
+			scroll_session.scroll_sequence = sequence;
+			lines_moved++;
 		}
-
-
-		if(true == scroll_session.is_scroll_at_end)
+		for(; delta < 0; delta++) /* <-- ccw scroll wheel rotation, scroll down toward oldest */
 		{
-			display_string("End of history", 2, 0, White, true);
+			scroll_session.direction = DOWN;
+			ui_set_scroll_direction_indicator(DOWN);
+			sequence = scroll_session.scroll_sequence - 1;
+			if(scroll_session.scroll_sequence == capture_session.oldest_sequence || false == ui_get_filtered_record(&sequence, DOWN))
+				break; /* reached end of history ... can't scroll past oldest */
+			scroll_session.scroll_sequence = sequence;
+			lines_moved--;
 		}
-	}
 
-	switch (app_get_state())
-	{
-		case APP_STATE_MIDI_DISPLAY:
-			/* kill oneshot timer if app_state back to LIVE */
-			HAL_TIM_Base_Stop_IT(&htim4);
-			__HAL_TIM_SET_COUNTER(&htim4, 0);
-			timeoutFlag = false;
-			break;
-		case APP_STATE_SCROLL_HISTORY:
-			/* restart one-shot timer (timeout period set to .5sec) ... expiration will fill screen with next 5 values */
-			HAL_TIM_Base_Stop_IT(&htim4);
-			__HAL_TIM_SET_COUNTER(&htim4, 0);
-			HAL_TIM_Base_Start_IT(&htim4);
-			break;
-		default:
-			break;
+		ui_paint_scroll_record(lines_moved, true); /* finish scroll tasks */
 	}
+
+	/* screen is complete ... cancel fill left over from a jump */
+	ui_cancel_fill();
 }
 
-int16_t ui_restore_display(void)
+uint32_t ui_restore_display(void)
 {
-	int16_t index = ptr_history - midi_history - 1;  /* get index for latest message */
+	uint32_t sequence = capture_session.newest_sequence;  /* get sequence number for latest message */
 	scroll_session.is_scroll_active = false; /* reset scroll session flag */
 	scroll_session.is_scroll_at_end = false;
+	scroll_session.is_screen_known = false; /* LIVE draws over scroll screen */
+	ui_cancel_fill(); /* back to LIVE */
 
 	/* redraw scroll bar and blank out background data arrival indicator */
-	float height = (float)MODULO(capture_session.midi_total_count, NUMBER_PAGES) / NUMBER_PAGES;
-	ui_draw_scroll_bar(height, 0, PERCENT, (capture_session.number_rollovers + 1) % 2, capture_session.number_rollovers);
+	float height = (float)(capture_session.midi_total_count % history_capacity()) / history_capacity();
+	ui_draw_scroll_bar(height, 0, PERCENT, (capture_session.number_rollovers + 1) % 2, capture_session.number_rollovers != 0);
 	ssd1306_FillRectangle(SSD1306_WIDTH - 2, 0, SSD1306_WIDTH, DISPLAY_DEFAULT_FONT.height - 2, Black);
 
-	if(filter_getChannel() == 0 || filter_getChannel() == midi_history[index].channel)
+	if(ui_is_record_filtered_in(sequence))
 	{
 		display_clear_page(Black);
+#if LIVE_HARDWARE_SCROLL
+		/* write most recent history record to bottom line of display */
+		display_live_line(ui_format_record(sequence));
+#else
 		display_line_pointer = FIRST_DISPLAY_LINE;
 
 		/* write most recent history record to first line of display */
-		display_string(midi_process_message((ptr_history - 1)->running_status, (ptr_history - 1)->data[0], (ptr_history - 1)->data[1]), FIRST_DISPLAY_LINE, 0, White, true);
+		display_string(ui_format_record(sequence), FIRST_DISPLAY_LINE, 0, White, true);
+#endif
 		/* put relative midi session timestamp on status line */
-		uint32_t midi_delta_timestamp = session_getDeltaTime((ptr_history - 1)->time_stamp);
+		uint32_t midi_delta_timestamp = session_getDeltaTime(ui_get_record(sequence)->time_stamp);
 		display_status(LIVE, midi_delta_timestamp, 0, ui_get_scroll_direction_indicator());
 	}
 	else
 	{
-		char temp_buffer[16];
-		sprintf(temp_buffer, "%d No match", index);
+		char temp_buffer[24];
+		sprintf(temp_buffer, "%lu No match", (unsigned long)(sequence - capture_session.oldest_sequence));
 		display_string_to_status_line(temp_buffer, 0);
 	}
 
-	return index;
+	return sequence;
 }
 
-int16_t ui_get_scroll_index(void)
+#if defined(HOST_TEST)
+/* host tests only ... record-of-interest on the scroll screen */
+uint32_t ui_get_scroll_sequence(void)
 {
-	return scroll_session.scroll_index;
+	return scroll_session.scroll_sequence;
 }
+#endif
 
 void ui_set_scroll_direction_indicator(ScrollDirection scroll_direction)
 {
@@ -484,40 +689,98 @@ ScrollDirection ui_get_scroll_direction_indicator(void)
 	return scroll_direction_indicator;
 }
 
-void ui_fill_scroll_display_buffer(int16_t index, int16_t number_records)
+/* collect record-of-interest plus following older records (matching channel filter) for display lines 1..6 */
+void ui_fill_scroll_display_buffer(uint32_t sequence)
 {
-	uint16_t i;
-	int16_t temp_index = index;
+	scroll_session.display[0] = sequence;
+	scroll_session.display_count = 1;
 
-	for(i = 0; i < number_records; i++)
+	while(scroll_session.display_count < LAST_DISPLAY_LINE)
 	{
-		if(i >= LAST_DISPLAY_LINE)
+		if(sequence == capture_session.oldest_sequence)
 			break;
-		scroll_session.display[i] = MYMODULO(temp_index--, NUMBER_PAGES);
-	}
-	for(; i < LAST_DISPLAY_LINE; i++)
-	{
-		scroll_session.display[i] = NUMBER_PAGES + 1;
+		sequence--;
+		if(false == ui_get_filtered_record(&sequence, DOWN))
+			break;
+		scroll_session.display[scroll_session.display_count++] = sequence;
 	}
 }
 
 void ui_jump_to_oldest(void)
 {
+	uint32_t sequence = capture_session.oldest_sequence;
+
+	if(false == ui_get_filtered_record(&sequence, UP)) /* history empty or no record matches channel filter */
+		return;
+
 	scroll_session.is_scroll_active = true; /* make sure scroll state is set to active */
 	scroll_session.direction = DOWN;
 	ui_set_scroll_direction_indicator(DOWN);
-	scroll_session.scroll_index = capture_session.oldest_index; /* set scroll index to oldest capture session index */
-	scroll_session.delta_total = 0 - scroll_session.number_records; /* scroll wheel delta movements will be used to confine scrolling to newest<>oldest range */
-	ui_fill_scroll_display_buffer(scroll_session.scroll_index, scroll_session.number_records + scroll_session.delta_total + 1); /* fill display buffer while indexes are known */
-	display_clear_page(Black);
-	display_status(INDEX, 0, MYMODULO(scroll_session.scroll_index - capture_session.oldest_index, NUMBER_PAGES), scroll_session.direction);
-	display_string(midi_process_message(midi_history[MYMODULO(scroll_session.scroll_index, NUMBER_PAGES)].running_status, midi_history[MYMODULO(scroll_session.scroll_index, NUMBER_PAGES)].data[0], midi_history[MYMODULO(scroll_session.scroll_index, NUMBER_PAGES)].data[1]), 1, 0, White, true);
-	ui_draw_scroll_bar(LAST_DISPLAY_LINE - 1, SSD1306_HEIGHT, ABSOLUTE, White, false);
+	scroll_session.scroll_sequence = sequence; /* set record-of-interest to oldest (matching) record */
+	ui_paint_scroll_record(LAST_DISPLAY_LINE, false);
 
-	/* restart one-shot timer (timeout period set to .5sec) ... expiration will fill screen with next 6 values */
-	HAL_TIM_Base_Stop_IT(&htim4);
-	__HAL_TIM_SET_COUNTER(&htim4, 0);
-	HAL_TIM_Base_Start_IT(&htim4);
+	/* fill next 5 lines incrementally, one per main loop pass */
+	ui_start_fill();
+}
+
+/* start jump-to-time from record currently on screen (record-of-interest in scroll, newest in LIVE) */
+void ui_time_jump_begin(void)
+{
+	uint32_t sequence = scroll_session.is_scroll_active ? scroll_session.scroll_sequence : capture_session.newest_sequence;
+
+	time_jump_target = 0;
+	if(0 != capture_session.number_records)
+		time_jump_target = session_getDeltaTime(ui_get_record(sequence)->time_stamp);
+}
+
+/* move jump-to-time target by steps (seconds or minutes) and land on nearest (matching) record ... O(log n) */
+void ui_time_jump_step(int16_t steps)
+{
+	char temp_buffer[24];
+	uint32_t sequence;
+	uint32_t session_length;
+	int32_t delta_ms = (int32_t)steps * (int32_t)time_jump_step;
+
+	if(0 == capture_session.number_records) /* History is empty ... nothing to jump to */
+	{
+		display_string("History is empty", 3, 0, White, true);
+		return;
+	}
+
+	/* clamp target to [session start, newest record] */
+	session_length = session_getDeltaTime(ui_get_record(capture_session.newest_sequence)->time_stamp);
+	if(delta_ms < 0 && (uint32_t)-delta_ms > time_jump_target)
+		time_jump_target = 0;
+	else
+		time_jump_target += delta_ms;
+	if(time_jump_target > session_length)
+		time_jump_target = session_length;
+
+	sequence = history_find_time(session_getStartTimestamp(), time_jump_target);
+	if(false == ui_get_filtered_record(&sequence, DOWN) && false == ui_get_filtered_record(&sequence, UP))
+	{
+		/* no matching records found */
+		sprintf(temp_buffer, "%lu No match", (unsigned long)capture_session.number_records);
+		display_string_to_status_line(temp_buffer, 0);
+		return;
+	}
+	printf("Jump to %lu:%02lu.%03lu\r\n", (unsigned long)(time_jump_target / 60000), (unsigned long)(time_jump_target / 1000 % 60), (unsigned long)(time_jump_target % 1000));
+
+	scroll_session.is_scroll_active = true;
+	scroll_session.direction = steps < 0 ? DOWN : UP;
+	ui_set_scroll_direction_indicator(scroll_session.direction);
+	scroll_session.scroll_sequence = sequence;
+	ui_paint_scroll_record(LAST_DISPLAY_LINE, false);
+
+	/* fill next 5 lines incrementally, one per main loop pass */
+	ui_start_fill();
+}
+
+void ui_toggle_time_jump_step(void)
+{
+	time_jump_step = (TIME_JUMP_STEP_SECONDS == time_jump_step) ? TIME_JUMP_STEP_MINUTES : TIME_JUMP_STEP_SECONDS;
+	display_string_to_status_line(TIME_JUMP_STEP_SECONDS == time_jump_step ? "Jump sec" : "Jump min", 0);
+	printf("Jump-to-time step = %s\r\n", TIME_JUMP_STEP_SECONDS == time_jump_step ? "seconds" : "minutes");
 }
 
 void ui_draw_scroll_bar(float height, float position, ScrollBarDimensionType dimension_type, SSD1306_COLOR color, bool rollover_indicator)
@@ -538,8 +801,6 @@ void ui_draw_scroll_bar(float height, float position, ScrollBarDimensionType dim
 		default:
 			break;
 	}
-
-	ssd1306_UpdateScreen();
 }
 
 bool ui_is_capture_active(void)
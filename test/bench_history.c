@@ -0,0 +1,96 @@
+/*
+ * bench_history.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <time.h>
+#include "test.h"
+#include "history.h"
+#include "midi_stream.h"
+
+/*
+ * Compression ratio and decode latency per screen, SRAM ring against compressed backend ... each stream style
+ * fills the history well past capacity, then BENCH_SCREENS screens (6 records, record-of-interest and the 5 older
+ * ones, as ui_fill_scroll_display_buffer() reads them) are read at random positions (jump) and one record apart
+ * (scroll detents). Latency is host time, useful for comparing the backends, not as a figure for the target.
+ */
+
+#define BENCH_RECORDS		(200000u)
+#define BENCH_SCREENS		(200000u)
+#define BENCH_SCREEN_LINES	(6u)
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* ns per screen, screens starting at random retained records (jump) or walking back one record per screen (scroll) */
+static double screen_ns(bool is_jump)
+{
+	stc_midi_history record;
+	uint32_t span = history_count() - BENCH_SCREEN_LINES;
+	uint32_t sequence = history_newest();
+	uint32_t checksum = 0;
+	uint64_t start = now_ns();
+
+	for(uint32_t s = 0; s < BENCH_SCREENS; s++)
+	{
+		if(is_jump)
+			sequence = history_oldest() + BENCH_SCREEN_LINES + test_random() % span;
+		else if(sequence == history_oldest() + BENCH_SCREEN_LINES)
+			sequence = history_newest();
+		else
+			sequence--;
+		for(uint32_t line = 0; line < BENCH_SCREEN_LINES; line++)
+		{
+			if(history_read(sequence - line, &record))
+				checksum += record.time_stamp;
+		}
+	}
+	if(0 == checksum) /* keep the reads */
+		printf(" ");
+	return (double)(now_ns() - start) / BENCH_SCREENS;
+}
+
+static int run(const HistoryBackend *backend, StreamStyle style, const char *style_name, uint32_t *held)
+{
+	stc_midi packet;
+
+	history_init(backend);
+	stream_init(style, 0);
+	for(uint32_t n = 0; n < BENCH_RECORDS; n++)
+	{
+		stream_next(&packet);
+		history_append(&packet);
+	}
+	CHECK(history_count() > BENCH_SCREEN_LINES, "%s %s: only %u records held", backend->name, style_name, history_count());
+
+	*held = history_count();
+	printf("  %-12s %-10s %5u records  %4.2f bytes/record  jump %6.0f ns/screen  scroll %6.0f ns/screen\n", style_name,
+			backend->name, history_count(), (double)(NUMBER_PAGES * sizeof(stc_midi_history)) / history_count(),
+			screen_ns(true), screen_ns(false));
+	return 0;
+}
+
+int main(void)
+{
+	static const StreamStyle styles[] = {STREAM_CHORDS, STREAM_CONTROLLERS, STREAM_MIXED};
+	static const char *names[] = {"chords", "controllers", "mixed"};
+	uint32_t sram_held, compressed_held;
+
+	for(uint8_t s = 0; s < 3; s++)
+	{
+		if(run(&history_sram_backend, styles[s], names[s], &sram_held) != 0
+				|| run(&history_compressed_backend, styles[s], names[s], &compressed_held) != 0)
+			return 1;
+		CHECK(compressed_held > sram_held, "%s: compressed holds %u records, SRAM ring %u", names[s], compressed_held, sram_held);
+		printf("  %-12s ratio %.2f\n", names[s], (double)compressed_held / sram_held);
+	}
+	printf("bench_history: OK\n");
+	return 0;
+}
@@ -0,0 +1,267 @@
+/*
+ * bench_scheduler.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <time.h>
+#include "test.h"
+#include "main.h"
+#include "scheduler.h"
+
+/*
+ * Timer wheel with hundreds of timers (built with MAX_TASKS = BENCH_TIMERS) ... BENCH_TIMERS one-shot timers under
+ * random start/restart/stop churn, delays from 0 to several wheel revolutions, plus periodic tasks, checked against
+ * a plain list of deadlines kept here: every run lands on its exact deadline, nothing runs that was stopped or
+ * moved, scheduler_get_next_deadline() is never later than the real next deadline and exact while every armed
+ * deadline is within WHEEL_SLOTS ms.
+ * The same churn again tickless (time jumps to the next deadline). Then host time per tick, per start/stop pair
+ * and per next-deadline query with every timer armed, against a scan over the same deadline list (what the old
+ * per-ms walk over every task cost), useful for comparing the two, not as a figure for the target.
+ */
+
+#define BENCH_TIMERS		(MAX_TASKS)
+#define PERIODIC			(16u)			/* of them periodic tasks, the rest one-shot timers */
+#define WHEEL_SLOTS			(64u)
+#define MAX_DELAY_MS		(5 * WHEEL_SLOTS)
+#define CHURN_MS			(200000u)
+#define BENCH_TICKS			(2000000u)
+
+static char names[BENCH_TIMERS];		/* task name = &names[n], tells the shared callback which timer ran */
+static TaskId ids[BENCH_TIMERS];
+static uint32_t intervals[BENCH_TIMERS];
+static bool is_armed[BENCH_TIMERS];		/* reference ... what should happen */
+static uint32_t deadlines[BENCH_TIMERS];
+static uint32_t runs, bad_runs;
+static uint32_t checks, early_answers;	/* next deadline queries, answers early because of a later revolution */
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void timer_run(void)
+{
+	uint32_t n = scheduler_get_last_task_name() - names;
+
+	if(!is_armed[n] || deadlines[n] != uwTick)
+	{
+		if(0 == bad_runs)
+			printf("  timer %u ran at %u, %s %u\n", n, uwTick, is_armed[n] ? "deadline" : "stopped, last deadline", deadlines[n]);
+		bad_runs++;
+	}
+	runs++;
+	if(0 != intervals[n])
+		deadlines[n] += intervals[n];
+	else
+		is_armed[n] = false;
+}
+
+static void start(void)
+{
+	uwTick = 0xFFFFFFFFu - CHURN_MS / 2; /* 2^32 ms wrap half way */
+	scheduler_init();
+	runs = bad_runs = checks = early_answers = 0;
+	for(uint32_t n = 0; n < BENCH_TIMERS; n++)
+	{
+		intervals[n] = (n < PERIODIC) ? 1 + test_random() % MAX_DELAY_MS : 0;
+		if(0 != intervals[n])
+			ids[n] = scheduler_add_task(&names[n], timer_run, intervals[n], TASK_PRIORITY_NORMAL, 0);
+		else
+			ids[n] = scheduler_add_timer(&names[n], timer_run, TASK_PRIORITY_NORMAL, 0);
+		is_armed[n] = (0 != intervals[n]);
+		deadlines[n] = uwTick + intervals[n];
+	}
+}
+
+/* a few random one-shot timers started, restarted or stopped */
+static void churn(void)
+{
+	for(uint32_t i = test_random() % 8; i != 0; i--)
+	{
+		uint32_t n = PERIODIC + test_random() % (BENCH_TIMERS - PERIODIC);
+		uint32_t delay = test_random() % (MAX_DELAY_MS + 1);
+
+		if(0 == test_random() % 4)
+		{
+			scheduler_stop_timer(ids[n]);
+			is_armed[n] = false;
+		}
+		else
+		{
+			scheduler_start_timer(ids[n], delay);
+			is_armed[n] = true;
+			deadlines[n] = uwTick + (delay != 0 ? delay : 1);
+		}
+	}
+}
+
+/* earliest armed deadline in the reference list, false if none */
+static bool scan_next(uint32_t *next)
+{
+	bool is_found = false;
+
+	for(uint32_t n = 0; n < BENCH_TIMERS; n++)
+	{
+		if(is_armed[n] && (!is_found || (int32_t)(deadlines[n] - *next) < 0))
+		{
+			*next = deadlines[n];
+			is_found = true;
+		}
+	}
+	return is_found;
+}
+
+static int check_next(const char *loop)
+{
+	uint32_t expected = 0, next = 0, latest = 0;
+	bool is_expected = scan_next(&expected), is_next = scheduler_get_next_deadline(&next);
+
+	CHECK(is_expected == is_next, "%s at %u: next deadline %s, expected %s", loop, uwTick, is_next ? "found" : "none",
+			is_expected ? "one" : "none");
+	if(!is_next)
+		return 0;
+	CHECK((int32_t)(next - expected) <= 0, "%s at %u: next deadline %u after the real one %u", loop, uwTick, next, expected);
+	for(uint32_t n = 0; n < BENCH_TIMERS; n++)
+	{
+		if(is_armed[n] && (int32_t)(deadlines[n] - uwTick) > (int32_t)latest)
+			latest = deadlines[n] - uwTick;
+	}
+	CHECK(latest > WHEEL_SLOTS || next == expected, "%s at %u: next deadline %u, expected %u (all within %u ms)",
+			loop, uwTick, next, expected, latest);
+	if(next != expected)
+		early_answers++;
+	checks++;
+	return 0;
+}
+
+static void dispatch_all(void)
+{
+	while(scheduler_dispatch(TASK_PRIORITY_LOW))
+		;
+}
+
+/* every deadline that passed ran ... nothing armed left in the past */
+static int check_passed(const char *loop)
+{
+	for(uint32_t n = 0; n < BENCH_TIMERS; n++)
+		CHECK(!is_armed[n] || (int32_t)(deadlines[n] - uwTick) > 0, "%s at %u: timer %u deadline %u passed without a run",
+				loop, uwTick, n, deadlines[n]);
+	return 0;
+}
+
+static int test_churn(bool is_tickless)
+{
+	const char *loop = is_tickless ? "tickless" : "tick";
+	uint32_t end, next;
+
+	start();
+	end = uwTick + CHURN_MS;
+	while((int32_t)(uwTick - end) < 0)
+	{
+		if(is_tickless && scheduler_get_next_deadline(&next) && (int32_t)(next - end) < 0)
+			uwTick = next;
+		else
+			uwTick++;
+		if(is_tickless)
+			scheduler_advance(uwTick);
+		else
+			scheduler_tick();
+		dispatch_all();
+		CHECK(0 == bad_runs, "%s: run off its deadline", loop);
+		if(check_passed(loop) != 0)
+			return 1;
+		churn();
+		if(check_next(loop) != 0)
+			return 1;
+	}
+	printf("  %-8s %6u runs in %u ms of churn, all on their deadlines, next deadline early %u of %u times\n", loop, runs,
+			CHURN_MS, early_answers, checks);
+	return 0;
+}
+
+/* ns per call of the wheel routines with every timer armed, against a scan of the same deadlines */
+static int bench(void)
+{
+	uint32_t next = 0, checksum = 0;
+	uint64_t begin;
+	double tick_ns, scan_tick_ns, start_ns, next_ns, scan_next_ns;
+
+	/* every timer a periodic task ... the wheel stays full without dispatching */
+	uwTick = 0;
+	scheduler_init();
+	for(uint32_t n = 0; n < BENCH_TIMERS; n++)
+	{
+		intervals[n] = 1 + test_random() % MAX_DELAY_MS;
+		ids[n] = scheduler_add_task(&names[n], timer_run, intervals[n], TASK_PRIORITY_NORMAL, 0);
+		is_armed[n] = true;
+		deadlines[n] = uwTick + intervals[n];
+	}
+
+	begin = now_ns();
+	for(uint32_t t = 0; t < BENCH_TICKS; t++)
+	{
+		uwTick++;
+		scheduler_tick();
+	}
+	tick_ns = (double)(now_ns() - begin) / BENCH_TICKS;
+
+	/* scan ... every deadline compared every ms, as the old run_scheduled_tasks() walked every task */
+	begin = now_ns();
+	for(uint32_t t = 0; t < BENCH_TICKS; t++)
+	{
+		uwTick++;
+		for(uint32_t n = 0; n < BENCH_TIMERS; n++)
+		{
+			if(is_armed[n] && deadlines[n] == uwTick)
+			{
+				deadlines[n] += intervals[n];
+				checksum++;
+			}
+		}
+	}
+	scan_tick_ns = (double)(now_ns() - begin) / BENCH_TICKS;
+
+	begin = now_ns();
+	for(uint32_t t = 0; t < BENCH_TICKS; t++)
+	{
+		TaskId id = ids[t % BENCH_TIMERS];
+
+		scheduler_stop_timer(id);
+		scheduler_start_timer(id, 1 + t % MAX_DELAY_MS);
+	}
+	start_ns = (double)(now_ns() - begin) / BENCH_TICKS;
+
+	begin = now_ns();
+	for(uint32_t t = 0; t < BENCH_TICKS; t++)
+		checksum += scheduler_get_time_to_next();
+	next_ns = (double)(now_ns() - begin) / BENCH_TICKS;
+
+	begin = now_ns();
+	for(uint32_t t = 0; t < BENCH_TICKS / 16; t++)
+	{
+		scan_next(&next);
+		checksum += next;
+	}
+	scan_next_ns = (double)(now_ns() - begin) / (BENCH_TICKS / 16);
+	if(0 == checksum) /* keep the loops */
+		printf(" ");
+
+	CHECK(tick_ns < scan_tick_ns && next_ns < scan_next_ns, "wheel tick %.1f ns, next %.1f ns against scan %.1f ns, %.1f ns",
+			tick_ns, next_ns, scan_tick_ns, scan_next_ns);
+	printf("  %u timers armed: tick %.1f ns (scan %.1f ns), start/stop pair %.1f ns, time to next %.1f ns (scan %.1f ns)\n",
+			BENCH_TIMERS, tick_ns, scan_tick_ns, start_ns, next_ns, scan_next_ns);
+	return 0;
+}
+
+int main(void)
+{
+	if(test_churn(false) != 0 || test_churn(true) != 0 || bench() != 0)
+		return 1;
+	printf("bench_scheduler: OK\n");
+	return 0;
+}
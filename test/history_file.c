@@ -0,0 +1,109 @@
+/*
+ * history_file.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "history_file.h"
+
+/*
+ * Memory-mapped file backend ... host stand-in for external storage and reference implementation for the
+ * target backends. Record for a sequence number lives at file offset (sequence % HISTORY_FILE_RECORDS) *
+ * sizeof(stc_midi_history), nothing is evicted unless evict_before() asks, so a session far longer than any
+ * target backend holds stays readable and each backend's retained window can be checked record by record.
+ */
+
+#define HISTORY_FILE_MASK	(HISTORY_FILE_RECORDS - 1)
+#define HISTORY_FILE_BYTES	((size_t)HISTORY_FILE_RECORDS * sizeof(stc_midi_history))
+
+static int fd = -1;
+static stc_midi_history *records = NULL;
+static uint32_t next_sequence = 0;
+static uint32_t oldest_sequence = 0;
+
+bool history_file_open(const char *path)
+{
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		return false;
+	if(ftruncate(fd, HISTORY_FILE_BYTES) != 0)
+	{
+		history_file_close();
+		return false;
+	}
+	records = mmap(NULL, HISTORY_FILE_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(MAP_FAILED == records)
+	{
+		records = NULL;
+		history_file_close();
+		return false;
+	}
+	return true;
+}
+
+void history_file_close(void)
+{
+	if(records != NULL)
+		munmap(records, HISTORY_FILE_BYTES);
+	if(fd >= 0)
+		close(fd);
+	records = NULL;
+	fd = -1;
+}
+
+static uint32_t file_reset(void)
+{
+	next_sequence = 0;
+	oldest_sequence = 0;
+
+	return HISTORY_FILE_RECORDS;
+}
+
+static void file_append(const stc_midi_history *record)
+{
+	records[next_sequence & HISTORY_FILE_MASK] = *record;
+	next_sequence++;
+	if(next_sequence - oldest_sequence > HISTORY_FILE_RECORDS)
+		oldest_sequence = next_sequence - HISTORY_FILE_RECORDS;
+}
+
+static bool file_read(uint32_t sequence, stc_midi_history *record)
+{
+	if(sequence - oldest_sequence >= next_sequence - oldest_sequence) /* outside [oldest, next) */
+		return false;
+	*record = records[sequence & HISTORY_FILE_MASK];
+	return true;
+}
+
+static uint32_t file_oldest(void)
+{
+	return oldest_sequence;
+}
+
+static uint32_t file_next(void)
+{
+	return next_sequence;
+}
+
+static void file_evict_before(uint32_t sequence)
+{
+	if((int32_t)(sequence - oldest_sequence) <= 0) /* already evicted */
+		return;
+	if((int32_t)(sequence - next_sequence) > 0) /* clamp to newest + 1 (empty history) */
+		sequence = next_sequence;
+	oldest_sequence = sequence;
+}
+
+const HistoryBackend history_file_backend = {
+	"File",
+	file_reset,
+	file_append,
+	file_read,
+	file_oldest,
+	file_next,
+	file_evict_before
+};
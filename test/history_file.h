@@ -0,0 +1,20 @@
+/*
+ * history_file.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef TEST_HISTORY_FILE_H_
+#define TEST_HISTORY_FILE_H_
+
+#include "history.h"
+
+#define HISTORY_FILE_RECORDS	(1u << 22)	/* 32 MB file, sparse until written */
+
+extern const HistoryBackend history_file_backend;
+
+bool history_file_open(const char *path);
+void history_file_close(void);
+
+#endif /* TEST_HISTORY_FILE_H_ */
@@ -0,0 +1,136 @@
+/*
+ * midi_stream.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "midi_stream.h"
+
+/*
+ * Phrases (a chord, a controller sweep, a program change) are queued as messages with their delay from the
+ * previous message, stream_next() pops one per call. Timestamps are non-decreasing and wrap at 2^32 ms like
+ * the HAL tick. One phrase in 256 starts after a long pause (2..70 s), so time deltas of every size occur.
+ */
+
+#define STREAM_QUEUE_SIZE	(64u)
+
+typedef struct {
+	uint32_t delay_ms;
+	uint8_t status;
+	uint8_t data[2];
+} StreamMessage;
+
+static StreamStyle stream_style;
+static uint32_t time_ms;
+static StreamMessage queue[STREAM_QUEUE_SIZE];
+static uint8_t queue_head, queue_count;
+
+static uint32_t random_range(uint32_t low, uint32_t high)
+{
+	return low + test_random() % (high - low + 1);
+}
+
+static void queue_message(uint32_t delay_ms, uint8_t status, uint8_t data1, uint8_t data2)
+{
+	StreamMessage *message = &queue[(queue_head + queue_count++) % STREAM_QUEUE_SIZE];
+
+	message->delay_ms = delay_ms;
+	message->status = status;
+	message->data[0] = data1 & 0x7F;
+	message->data[1] = data2 & 0x7F;
+}
+
+static void queue_chord(uint8_t channel)
+{
+	static const uint8_t intervals[4] = {0, 4, 7, 12};
+	uint8_t notes = random_range(3, 4);
+	uint8_t root = random_range(36, 84);
+
+	for(uint8_t i = 0; i < notes; i++) /* note on */
+		queue_message(0 == i ? random_range(20, 400) : random_range(0, 3), 0x90 | channel, root + intervals[i], random_range(40, 127));
+	for(uint8_t i = 0; i < notes; i++) /* note off ... note on velocity 0 */
+		queue_message(0 == i ? random_range(80, 800) : random_range(0, 2), 0x90 | channel, root + intervals[i], 0);
+}
+
+static void queue_sweep(uint8_t channel)
+{
+	uint8_t steps = random_range(10, 40);
+	bool is_bend = (0 == random_range(0, 2));
+	uint8_t controller = random_range(1, 11);
+	uint8_t value = random_range(0, 127);
+
+	for(uint8_t i = 0; i < steps; i++)
+	{
+		value += random_range(1, 3);
+		if(is_bend)
+			queue_message(random_range(4, 12), 0xE0 | channel, 0, value);
+		else
+			queue_message(random_range(4, 12), 0xB0 | channel, controller, value);
+	}
+}
+
+static void queue_phrase(void)
+{
+	uint8_t channel = (STREAM_MIXED == stream_style) ? random_range(0, 3) : 0;
+
+	switch(stream_style)
+	{
+		case STREAM_CHORDS:
+			queue_chord(channel);
+			break;
+		case STREAM_CONTROLLERS:
+			queue_sweep(channel);
+			break;
+		default:
+			switch(random_range(0, 5))
+			{
+				case 0:
+					queue_message(random_range(50, 500), 0xC0 | channel, random_range(0, 127), 0); /* program change */
+					break;
+				case 1:
+					queue_message(random_range(5, 50), 0xD0 | channel, random_range(0, 127), 0); /* channel pressure */
+					break;
+				case 2:
+					queue_sweep(channel);
+					break;
+				default:
+					queue_chord(channel);
+					break;
+			}
+			break;
+	}
+	if(0 == random_range(0, 255))
+		queue[queue_head].delay_ms += random_range(2000, 70000);
+}
+
+void stream_init(StreamStyle style, uint32_t start_ms)
+{
+	stream_style = style;
+	time_ms = start_ms;
+	queue_head = queue_count = 0;
+}
+
+void stream_next(stc_midi *packet)
+{
+	StreamMessage *message;
+
+	if(0 == queue_count)
+		queue_phrase();
+	message = &queue[queue_head];
+	queue_head = (queue_head + 1) % STREAM_QUEUE_SIZE;
+	queue_count--;
+
+	time_ms += message->delay_ms;
+	packet->running_status = message->status;
+	packet->data[0] = message->data[0];
+	packet->data[1] = message->data[1];
+	packet->time_stamp = time_ms;
+	packet->channel = (message->status & 0x0F) + 1; /* MIDI channels are 1–16 */
+}
+
+uint32_t stream_time(void)
+{
+	return time_ms;
+}
@@ -0,0 +1,25 @@
+/*
+ * midi_stream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef TEST_MIDI_STREAM_H_
+#define TEST_MIDI_STREAM_H_
+
+#include <stdint.h>
+#include "midi.h"
+
+/* synthetic MIDI traffic for host tests ... assembled packets as midi_build_packet() hands them to ui.c */
+typedef enum {
+	STREAM_CHORDS,		/* keyboard chords, 3-4 notes within a few ms, held, released with note on velocity 0 */
+	STREAM_CONTROLLERS,	/* controller and pitch bend sweeps, one message every few ms */
+	STREAM_MIXED		/* chords, sweeps, program changes and channel pressure on several channels */
+} StreamStyle;
+
+void stream_init(StreamStyle style, uint32_t start_ms);
+void stream_next(stc_midi *packet);
+uint32_t stream_time(void);
+
+#endif /* TEST_MIDI_STREAM_H_ */
@@ -0,0 +1,260 @@
+/*
+ * ssd1306_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <string.h>
+#include "main.h"
+#include "ssd1306.h"
+#include "events.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Controller model ... only what ssd1306.c uses is interpreted, other commands consume their parameter bytes.
+ * Control byte: bit 7 (Co) = one byte follows then another control byte, bit 6 (D/C) = data.
+ */
+
+#define SIM_PAGES	(8u)
+#define SIM_COLUMNS	(128u)
+
+static uint8_t ram[SIM_PAGES][SIM_COLUMNS];
+static uint8_t addressing_mode;		/* 0 horizontal, 1 vertical, 2 page */
+static uint8_t column, page;
+static uint8_t column_start, column_end, page_start, page_end;
+static uint8_t start_line;
+static uint8_t command[3];			/* command being assembled with its parameters */
+static uint8_t command_length, command_needed;
+static SimOledStats stats;
+
+static uint8_t parameter_count(uint8_t code)
+{
+	switch(code)
+	{
+		case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+			return 1;
+		case 0x21: case 0x22:
+			return 2;
+		case 0x26: case 0x27:
+			return 6;
+		default:
+			return 0;
+	}
+}
+
+static void execute(void)
+{
+	uint8_t code = command[0];
+
+	if(0x20 == code)
+		addressing_mode = command[1] & 0x03;
+	else if(0x21 == code)
+	{
+		column_start = column = command[1] & 0x7F;
+		column_end = command[2] & 0x7F;
+	}
+	else if(0x22 == code)
+	{
+		page_start = page = command[1] & 0x07;
+		page_end = command[2] & 0x07;
+	}
+	else if(code >= 0x40 && code <= 0x7F)
+		start_line = code & 0x3F;
+	else if(code >= 0xB0 && code <= 0xB7 && 2 == addressing_mode)
+		page = code & 0x07;
+	else if(code <= 0x0F && 2 == addressing_mode)
+		column = (column & 0xF0) | code;
+	else if(code >= 0x10 && code <= 0x1F && 2 == addressing_mode)
+		column = (column & 0x0F) | ((code & 0x07) << 4);
+}
+
+static void command_byte(uint8_t byte)
+{
+	stats.command_bytes++;
+	if(command_length < sizeof(command))
+		command[command_length] = byte;
+	command_length++;
+	if(1 == command_length)
+		command_needed = 1 + parameter_count(byte);
+	if(command_length == command_needed)
+	{
+		execute();
+		command_length = 0;
+	}
+}
+
+static void data_byte(uint8_t byte)
+{
+	ram[page][column] = byte;
+	stats.data_bytes++;
+	stats.page_data_bytes[page]++;
+	if(2 == addressing_mode)
+	{
+		if(column < SIM_COLUMNS - 1)
+			column++;
+	}
+	else if(column == column_end)
+	{
+		column = column_start;
+		page = (page == page_end) ? page_start : page + 1;
+	}
+	else
+		column++;
+}
+
+static void sink(uint16_t address, const uint8_t *data, uint16_t size)
+{
+	uint16_t i = 0;
+
+	(void)address;
+	stats.bytes += size + 1;
+	stats.transactions++;
+	if(size != 0 && (data[0] & 0x40))
+		stats.data_transactions++;
+	else
+		stats.command_transactions++;
+
+	while(i < size)
+	{
+		uint8_t control = data[i++];
+
+		if(control & 0x80) /* Co ... one byte, then next control byte */
+		{
+			if(i < size)
+			{
+				if(control & 0x40)
+					data_byte(data[i++]);
+				else
+					command_byte(data[i++]);
+			}
+			continue;
+		}
+		for(; i < size; i++) /* rest of transaction is a stream */
+		{
+			if(control & 0x40)
+				data_byte(data[i]);
+			else
+				command_byte(data[i]);
+		}
+	}
+}
+
+void sim_oled_attach(void)
+{
+	memset(ram, 0x55, sizeof(ram));
+	addressing_mode = 2;
+	column = page = 0;
+	column_start = 0;
+	column_end = SIM_COLUMNS - 1;
+	page_start = 0;
+	page_end = SIM_PAGES - 1;
+	start_line = 0;
+	command_length = 0;
+	sim_oled_reset_stats();
+	sim_i2c_sink = sink;
+}
+
+void sim_oled_reset_stats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+void sim_oled_get_stats(SimOledStats *copy)
+{
+	*copy = stats;
+}
+
+bool sim_oled_pixel(uint8_t x, uint8_t y)
+{
+	uint8_t row = (y + start_line) % (SIM_PAGES * 8);
+
+	return (ram[row / 8][x] >> (row % 8)) & 0x01;
+}
+
+uint8_t sim_oled_start_line(void)
+{
+	return start_line;
+}
+
+bool sim_oled_matches_framebuffer(uint8_t *x, uint8_t *y)
+{
+	for(uint8_t row = 0; row < SSD1306_HEIGHT; row++)
+	{
+		for(uint8_t col = 0; col < SSD1306_WIDTH; col++)
+		{
+			if(sim_oled_pixel(col, row) != (White == ssd1306_GetPixel(col, row)))
+			{
+				*x = col;
+				*y = row;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void sim_oled_write_pbm(FILE *file)
+{
+	fprintf(file, "P1\n%u %u\n", SIM_COLUMNS, SIM_PAGES * 8);
+	for(uint8_t row = 0; row < SIM_PAGES * 8; row++)
+	{
+		for(uint8_t col = 0; col < SIM_COLUMNS; col++)
+			fputc(sim_oled_pixel(col, row) ? '1' : '0', file);
+		fputc('\n', file);
+	}
+}
+
+/* next pixel of a P1 image ... whitespace and comments skipped, -1 at end of file */
+static int pbm_pixel(FILE *file)
+{
+	int c;
+
+	while((c = fgetc(file)) != EOF)
+	{
+		if('#' == c)
+		{
+			while((c = fgetc(file)) != EOF && c != '\n')
+				;
+		}
+		else if('0' == c || '1' == c)
+			return c - '0';
+	}
+	return -1;
+}
+
+bool sim_oled_matches_pbm(FILE *file, uint8_t *x, uint8_t *y)
+{
+	unsigned width, height;
+
+	*x = *y = 255;
+	if(fscanf(file, " P1 %u %u", &width, &height) != 2 || width != SIM_COLUMNS || height != SIM_PAGES * 8)
+		return false;
+	for(uint8_t row = 0; row < SIM_PAGES * 8; row++)
+	{
+		for(uint8_t col = 0; col < SIM_COLUMNS; col++)
+		{
+			if(pbm_pixel(file) != (int)sim_oled_pixel(col, row))
+			{
+				*x = col;
+				*y = row;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/* as main.c forwards the I2C1 completion interrupt */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+	ssd1306_TxCpltCallback();
+	events_post(EVENT_DISPLAY);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+	ssd1306_TxErrorCallback();
+}
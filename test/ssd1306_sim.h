@@ -0,0 +1,42 @@
+/*
+ * ssd1306_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef TEST_SSD1306_SIM_H_
+#define TEST_SSD1306_SIM_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Simulated SSD1306 on the host I2C bus (sim_i2c_sink) ... decodes control bytes, commands and data into a
+ * 128x64 display RAM the way the controller does (addressing modes, 0x21/0x22 window, page mode column and
+ * page commands, display start line), and counts what went over the bus.
+ */
+
+typedef struct {
+	uint32_t bytes;					/* on the bus, I2C address byte included */
+	uint32_t transactions;
+	uint32_t command_transactions;	/* first control byte selects commands */
+	uint32_t data_transactions;		/* first control byte selects data */
+	uint32_t command_bytes;			/* command and parameter bytes */
+	uint32_t data_bytes;			/* display RAM bytes written */
+	uint32_t page_data_bytes[8];	/* display RAM bytes written per RAM page */
+} SimOledStats;
+
+void sim_oled_attach(void);				/* power-on state (RAM full of 0x55 noise), install as I2C sink */
+void sim_oled_reset_stats(void);
+void sim_oled_get_stats(SimOledStats *stats);
+bool sim_oled_pixel(uint8_t x, uint8_t y);	/* as seen on the glass (start line applied) */
+uint8_t sim_oled_start_line(void);
+bool sim_oled_matches_framebuffer(uint8_t *x, uint8_t *y);	/* false with first differing pixel */
+
+/* glass image as plain PBM (P1), 1 = lit pixel ... same format as console `d`, so a dump from the target can serve as golden image */
+void sim_oled_write_pbm(FILE *file);
+bool sim_oled_matches_pbm(FILE *file, uint8_t *x, uint8_t *y);	/* false with first differing pixel (255,255 = not a 128x64 P1 image) */
+
+#endif /* TEST_SSD1306_SIM_H_ */
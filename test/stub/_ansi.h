@@ -0,0 +1,15 @@
+/*
+ * _ansi.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+/* newlib header pulled in by ssd1306.h ... only the C linkage markers are used */
+#ifndef TEST_STUB_ANSI_H_
+#define TEST_STUB_ANSI_H_
+
+#define _BEGIN_STD_C
+#define _END_STD_C
+
+#endif /* TEST_STUB_ANSI_H_ */
@@ -0,0 +1,205 @@
+/*
+ * hal_stub.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <stdio.h>
+#include "main.h"
+
+/*
+ * Host side of stm32f1xx_hal.h ... time is uwTick, advanced by the test (or HAL_Delay()), nothing runs on its
+ * own. Hooks a test can replace: sim_irq_unmasked() (deliver interrupts held off by __disable_irq()), sim_wfi(),
+ * sim_tim_clear_flag() (timer status flags are rc_w0, writing the other bits as 1 leaves them alone),
+ * HAL_I2C_MasterTxCpltCallback()/HAL_I2C_ErrorCallback() (main.c's versions are not part of the host build).
+ */
+
+TIM_TypeDef sim_tim2, sim_tim3, sim_tim4;
+USART_TypeDef sim_usart1, sim_usart2;
+GPIO_TypeDef sim_gpioa, sim_gpioc;
+DWT_Type sim_dwt;
+CoreDebug_Type sim_core_debug;
+
+volatile uint32_t sim_primask = 0;
+__IO uint32_t uwTick = 0;
+uint32_t SystemCoreClock = 72000000u;
+
+/* handles main.c owns on the target */
+I2C_HandleTypeDef hi2c1;
+TIM_HandleTypeDef htim2 = {TIM2, {0, 0xFFFF}}, htim3 = {TIM3, {0, 65}}, htim4 = {TIM4, {36000 - 1, 0xFFFF}};
+UART_HandleTypeDef huart1 = {USART1}, huart2 = {USART2};
+
+SimI2cSink sim_i2c_sink = NULL;
+bool sim_i2c_hold_dma = false;
+bool sim_i2c_bus_busy = false;
+static I2C_HandleTypeDef *dma_handle = NULL;	/* DMA transfer on the bus, completion held */
+
+__attribute__((weak)) void sim_irq_unmasked(void)
+{
+}
+
+__attribute__((weak)) void sim_wfi(void)
+{
+}
+
+__attribute__((weak)) uintptr_t sim_get_msp(void)
+{
+	return (uintptr_t)__builtin_frame_address(0);
+}
+
+__attribute__((weak)) void sim_tim_clear_flag(TIM_TypeDef *tim, uint32_t flag)
+{
+	tim->SR &= ~flag;
+}
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+	return HAL_OK;
+}
+
+void HAL_IncTick(void)
+{
+	uwTick++;
+}
+
+/* timebase.c provides the tickless one */
+__attribute__((weak)) uint32_t HAL_GetTick(void)
+{
+	return uwTick;
+}
+
+void HAL_Delay(uint32_t delay_ms)
+{
+	uwTick += delay_ms;
+}
+
+void HAL_SuspendTick(void)
+{
+}
+
+void HAL_ResumeTick(void)
+{
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+	return SystemCoreClock / 2;
+}
+
+void HAL_DBGMCU_EnableDBGSleepMode(void)
+{
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+	if(GPIO_PIN_SET == state)
+		port->ODR |= pin;
+	else
+		port->ODR &= ~(uint32_t)pin;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *port, uint16_t pin)
+{
+	port->ODR ^= pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin)
+{
+	return (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size, uint32_t timeout)
+{
+	(void)huart;
+	(void)timeout;
+	fwrite(data, 1, size, stdout);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *data, uint16_t size)
+{
+	(void)huart;
+	(void)data;
+	(void)size;
+	return HAL_OK;
+}
+
+/* blocking write ... control byte (memory address) and data as one transaction */
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t address, uint16_t mem_address, uint16_t mem_size,
+		uint8_t *data, uint16_t size, uint32_t timeout)
+{
+	uint8_t transaction[1 + 1024];
+
+	(void)hi2c;
+	(void)mem_size;
+	(void)timeout;
+	if(dma_handle != NULL || size > sizeof(transaction) - 1)
+		return HAL_BUSY;
+	transaction[0] = (uint8_t)mem_address;
+	for(uint16_t i = 0; i < size; i++)
+		transaction[1 + i] = data[i];
+	if(sim_i2c_sink != NULL)
+		sim_i2c_sink(address, transaction, size + 1);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t size)
+{
+	if(dma_handle != NULL)
+		return HAL_BUSY;
+	if(sim_i2c_sink != NULL)
+		sim_i2c_sink(address, data, size);
+	dma_handle = hi2c;
+	if(!sim_i2c_hold_dma)
+		sim_i2c_complete();
+	return HAL_OK;
+}
+
+bool sim_i2c_is_dma_busy(void)
+{
+	return dma_handle != NULL;
+}
+
+/* transfer complete interrupt */
+void sim_i2c_complete(void)
+{
+	I2C_HandleTypeDef *hi2c = dma_handle;
+
+	if(NULL == hi2c)
+		return;
+	dma_handle = NULL;
+	HAL_I2C_MasterTxCpltCallback(hi2c);
+}
+
+__attribute__((weak)) void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+}
+
+__attribute__((weak)) void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *data, uint16_t size, uint32_t timeout)
+{
+	(void)hspi;
+	(void)data;
+	(void)size;
+	(void)timeout;
+	return HAL_OK;
+}
+
+/* globals main.c owns on the target */
+volatile uint16_t fifo_count = 0;
+volatile uint32_t midi_armed_ms = 0, midi_first_byte_ms = 0;
+volatile bool is_midi_first_byte = false;
+
+void Error_Handler(void)
+{
+	printf("Error_Handler()\n");
+	while(1)
+	{
+	}
+}
@@ -0,0 +1,158 @@
+/*
+ * stm32f1xx_hal.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef TEST_STUB_STM32F1XX_HAL_H_
+#define TEST_STUB_STM32F1XX_HAL_H_
+
+/*
+ * Host stand-in for the HAL and CMSIS headers ... found ahead of Drivers/ by the test build, so Core/Inc/main.h
+ * and the modules in Core/Src compile unchanged. Peripherals are plain structs (no rc_w0 or other side effects),
+ * interrupt masking and WFI go through hooks in hal_stub.c, the I2C bus hands every transaction to sim_i2c_sink.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	HAL_OK = 0,
+	HAL_ERROR,
+	HAL_BUSY,
+	HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum {
+	RESET = 0,
+	SET = !RESET
+} FlagStatus;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+#define HAL_MAX_DELAY		(0xFFFFFFFFu)
+#define __IO				volatile
+
+/* peripheral registers used by the application */
+typedef struct { __IO uint32_t CR1, DIER, SR, EGR, CCMR1, CNT, PSC, ARR, CCR1; } TIM_TypeDef;
+typedef struct { __IO uint32_t SR, DR; } USART_TypeDef;
+typedef struct { __IO uint32_t IDR, ODR; } GPIO_TypeDef;
+typedef struct { __IO uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { __IO uint32_t DEMCR; } CoreDebug_Type;
+
+typedef struct { uint32_t Prescaler, Period; } TIM_Base_InitTypeDef;
+typedef struct { TIM_TypeDef *Instance; TIM_Base_InitTypeDef Init; } TIM_HandleTypeDef;
+typedef struct { USART_TypeDef *Instance; } UART_HandleTypeDef;
+typedef struct { void *Instance; } I2C_HandleTypeDef;
+typedef struct { void *Instance; } SPI_HandleTypeDef;
+
+extern TIM_TypeDef sim_tim2, sim_tim3, sim_tim4;
+extern USART_TypeDef sim_usart1, sim_usart2;
+extern GPIO_TypeDef sim_gpioa, sim_gpioc;
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_core_debug;
+
+#define TIM2		(&sim_tim2)
+#define TIM3		(&sim_tim3)
+#define TIM4		(&sim_tim4)
+#define USART1		(&sim_usart1)
+#define USART2		(&sim_usart2)
+#define GPIOA		(&sim_gpioa)
+#define GPIOC		(&sim_gpioc)
+#define DWT			(&sim_dwt)
+#define CoreDebug	(&sim_core_debug)
+
+#define TIM_CR1_CEN		(1u << 0)
+#define TIM_DIER_UIE	(1u << 0)
+#define TIM_DIER_CC1IE	(1u << 1)
+#define TIM_SR_UIF		(1u << 0)
+#define TIM_SR_CC1IF	(1u << 1)
+#define TIM_EGR_UG		(1u << 0)
+#define TIM_EGR_CC1G	(1u << 1)
+#define TIM_FLAG_UPDATE	TIM_SR_UIF
+#define TIM_FLAG_CC1	TIM_SR_CC1IF
+
+#define UART_FLAG_RXNE	(1u << 5)
+#define I2C_FLAG_BUSY	(0x00100002u)
+
+#define CoreDebug_DEMCR_TRCENA_Msk	(1u << 24)
+#define DWT_CTRL_CYCCNTENA_Msk		(1u << 0)
+
+#define GPIO_PIN_4		((uint16_t)0x0010)
+#define GPIO_PIN_5		((uint16_t)0x0020)
+#define GPIO_PIN_13		((uint16_t)0x2000)
+
+#define EXTI4_IRQn		(10)
+#define EXTI9_5_IRQn	(23)
+
+#define __HAL_TIM_SET_COUNTER(handle, count)	((handle)->Instance->CNT = (count))
+#define __HAL_TIM_GET_COUNTER(handle)			((handle)->Instance->CNT)
+#define __HAL_TIM_CLEAR_FLAG(handle, flag)		sim_tim_clear_flag((handle)->Instance, (flag))
+#define __HAL_UART_GET_FLAG(handle, flag)		((((handle)->Instance->SR & (flag)) == (flag)) ? SET : RESET)
+#define __HAL_I2C_GET_FLAG(handle, flag)		((I2C_FLAG_BUSY == (flag) && sim_i2c_bus_busy) ? SET : RESET)
+
+/* core ... interrupt mask and sleep are simulated, see hal_stub.c */
+extern volatile uint32_t sim_primask;
+void sim_irq_unmasked(void);
+void sim_wfi(void);
+uintptr_t sim_get_msp(void);
+void sim_tim_clear_flag(TIM_TypeDef *tim, uint32_t flag);
+
+static inline void __disable_irq(void) { sim_primask = 1; }
+static inline void __enable_irq(void) { sim_primask = 0; sim_irq_unmasked(); }
+static inline uint32_t __get_PRIMASK(void) { return sim_primask; }
+static inline void __set_PRIMASK(uint32_t primask) { if(primask) __disable_irq(); else __enable_irq(); }
+static inline void __WFI(void) { sim_wfi(); }
+static inline uintptr_t __get_MSP(void) { return sim_get_msp(); }
+
+/* HAL */
+extern __IO uint32_t uwTick;
+extern uint32_t SystemCoreClock;
+
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay_ms);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+void HAL_DBGMCU_EnableDBGSleepMode(void);
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *port, uint16_t pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *data, uint16_t size);
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t address, uint16_t mem_address, uint16_t mem_size,
+		uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t size);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *data, uint16_t size, uint32_t timeout);
+
+/* simulated I2C bus ... every transaction (first byte = control byte) goes to the sink, DMA transfers complete
+ * right away unless sim_i2c_hold_dma is set, then sim_i2c_complete() finishes the one on the bus. sim_i2c_bus_busy
+ * is the BUSY flag (STOP still going out after a completion), set and cleared by the test */
+typedef void (*SimI2cSink)(uint16_t address, const uint8_t *data, uint16_t size);
+extern SimI2cSink sim_i2c_sink;
+extern bool sim_i2c_hold_dma;
+extern bool sim_i2c_bus_busy;
+bool sim_i2c_is_dma_busy(void);
+void sim_i2c_complete(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_STUB_STM32F1XX_HAL_H_ */
@@ -0,0 +1,39 @@
+/*
+ * test.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#ifndef TEST_TEST_H_
+#define TEST_TEST_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Host tests ... each test is a plain program built by test/Makefile against the sources in Core/Src,
+ * prints one OK line with its figures, or the first failed check and exits 1.
+ */
+#define CHECK(cond, ...) do { \
+	if(!(cond)) { \
+		printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+		printf(__VA_ARGS__); \
+		printf("\n"); \
+		return 1; \
+	} \
+} while(0)
+
+/* deterministic pseudo random numbers (xorshift32) ... same stream on every host */
+static inline uint32_t test_random(void)
+{
+	static uint32_t state = 2463534242u;
+
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+#endif /* TEST_TEST_H_ */
@@ -0,0 +1,226 @@
+/*
+ * test_display_dma.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "main.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "app_state_machine.h"
+#include "midi_stream.h"
+#include "ssd1306_sim.h"
+
+/*
+ * OLED frames on a slow bus while MIDI keeps arriving ... simulated microseconds, I2C at 100 kHz (9 bit times per
+ * byte), MIDI bytes at 31250 baud into a FIFO (stream timing, then back to back), and main loop passes doing what
+ * main.c does (one byte, one packet, display_service(), display_present()). DMA transfers complete by simulated time, followed by a short bus busy
+ * (STOP) window. Packets must be parsed while frames are on the bus, no byte may wait long in the FIFO, the bus
+ * must not sit idle for more than a pass between transfers of a frame, and the controller image must match.
+ * A blocking command issued in the middle of a frame must finish the frame from its own wait loop.
+ */
+
+#define TEST_RUN_US			(30000000ull)	/* per stream style */
+#define BUS_US_PER_BYTE		(90u)			/* 100 kHz, 8 bits + ACK */
+#define BUS_STOP_US			(10u)			/* BUSY flag still set after completion interrupt */
+#define MIDI_US_PER_BYTE	(320u)			/* 31250 baud, 10 bits */
+#define PASS_US				(20u)			/* main loop pass with nothing to do */
+#define PACKET_US			(250u)			/* ui_process_midi_packet() drawing a line */
+#define MAX_BYTE_WAIT_US	(2000u)
+#define MAX_BUS_IDLE_US		(PASS_US + PACKET_US + BUS_STOP_US + 10u)
+
+static uint64_t now_us;
+static uint64_t transfer_end_us, bus_busy_until_us, transfer_done_us;
+static uint32_t transfer_bytes;
+static SimI2cSink oled_sink;
+
+/* UART side ... serialized stream messages with their arrival times, FIFO of received bytes */
+static uint8_t wire[3];
+static uint8_t wire_length, wire_index;
+static uint64_t wire_next_us;
+static bool is_flood;			/* bytes back to back at full baud rate, stream time stamps ignored */
+static uint8_t fifo[UART_FIFO_SIZE];
+static uint64_t fifo_arrival[UART_FIFO_SIZE];
+static uint16_t fifo_head, fifo_tail;
+
+static uint32_t max_fifo, max_byte_wait_us, max_bus_idle_us;
+static uint32_t packets, packets_during_frame, transfers;
+
+static void bus_sink(uint16_t address, const uint8_t *data, uint16_t size)
+{
+	transfer_bytes = size + 1; /* address byte */
+	oled_sink(address, data, size);
+}
+
+static void wire_load(void)
+{
+	stc_midi packet;
+	uint8_t type;
+
+	stream_next(&packet);
+	type = packet.running_status & 0xF0;
+	wire[0] = packet.running_status;
+	wire[1] = packet.data[0];
+	wire[2] = packet.data[1];
+	wire_length = (0xC0 == type || 0xD0 == type) ? 2 : 3;
+	wire_index = 0;
+	if(false == is_flood && (uint64_t)packet.time_stamp * 1000u > wire_next_us)
+		wire_next_us = (uint64_t)packet.time_stamp * 1000u;
+}
+
+/* time passes ... bytes arrive, transfer on the bus completes (interrupt) */
+static void advance(uint32_t us)
+{
+	now_us += us;
+	uwTick = (uint32_t)(now_us / 1000u);
+
+	while(wire_next_us <= now_us)
+	{
+		fifo[fifo_head] = wire[wire_index];
+		fifo_arrival[fifo_head] = wire_next_us;
+		fifo_head = (fifo_head + 1) % UART_FIFO_SIZE;
+		fifo_count++;
+		if(fifo_count > max_fifo)
+			max_fifo = fifo_count;
+		wire_next_us += MIDI_US_PER_BYTE;
+		if(++wire_index == wire_length)
+			wire_load();
+	}
+
+	if(transfer_end_us != 0 && now_us >= transfer_end_us)
+	{
+		transfer_done_us = transfer_end_us;
+		bus_busy_until_us = transfer_end_us + BUS_STOP_US;
+		transfer_end_us = 0;
+		sim_i2c_complete();
+	}
+	sim_i2c_bus_busy = (now_us < bus_busy_until_us);
+}
+
+/* transfer started this pass ... goes on the bus now, ends after its bytes */
+static void bus_watch(void)
+{
+	if(sim_i2c_is_dma_busy() && 0 == transfer_end_us)
+	{
+		if(transfer_done_us != 0 && ssd1306_IsBusy() && now_us - transfer_done_us > max_bus_idle_us)
+			max_bus_idle_us = now_us - transfer_done_us;
+		transfer_end_us = now_us + transfer_bytes * BUS_US_PER_BYTE;
+		transfer_done_us = 0;
+		transfers++;
+	}
+	if(!ssd1306_IsBusy())
+		transfer_done_us = 0; /* frame complete, idle until next frame is fine */
+}
+
+/* one pass of main.c's loop */
+static void pass(void)
+{
+	uint32_t cost = PASS_US;
+
+	if(fifo_count != 0)
+	{
+		stc_midi *packet;
+		uint32_t wait = (uint32_t)(now_us - fifo_arrival[fifo_tail]);
+
+		if(wait > max_byte_wait_us)
+			max_byte_wait_us = wait;
+		packet = midi_build_packet(fifo[fifo_tail], (uint32_t)(fifo_arrival[fifo_tail] / 1000u));
+		fifo_tail = (fifo_tail + 1) % UART_FIFO_SIZE;
+		fifo_count--;
+		if(midi_isPacketAvailable())
+		{
+			if(ssd1306_IsBusy())
+				packets_during_frame++;
+			ui_process_midi_packet(packet);
+			packets++;
+			cost += PACKET_US;
+		}
+	}
+	scheduler_dispatch(TASK_PRIORITY_LOW);
+	display_service();
+	display_present();
+	bus_watch();
+	advance(cost);
+}
+
+static int run(StreamStyle style, bool flood, const char *name)
+{
+	uint64_t end_us = now_us + TEST_RUN_US;
+	uint32_t frames = display_get_flush_count();
+	uint8_t x, y;
+
+	max_fifo = max_byte_wait_us = max_bus_idle_us = 0;
+	packets = packets_during_frame = transfers = 0;
+	stream_init(style, uwTick + 1);
+	is_flood = flood;
+	wire_next_us = now_us;
+	wire_load();
+
+	while(now_us < end_us)
+		pass();
+	while(ssd1306_IsBusy() || fifo_count != 0 || ssd1306_IsDirty()) /* stream stopped, let the last frame out */
+	{
+		wire_next_us = UINT64_MAX;
+		pass();
+	}
+	frames = display_get_flush_count() - frames;
+
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "%s: controller differs from framebuffer at %u,%u", name, x, y);
+	CHECK(packets_during_frame > packets / 4, "%s: only %u of %u packets parsed while a frame was on the bus", name,
+			packets_during_frame, packets);
+	CHECK(max_byte_wait_us < MAX_BYTE_WAIT_US, "%s: byte waited %u us in FIFO", name, max_byte_wait_us);
+	CHECK(max_bus_idle_us < MAX_BUS_IDLE_US, "%s: bus idle %u us between transfers of a frame", name, max_bus_idle_us);
+
+	printf("  %-12s %6u packets (%u%% during frames), %5u frames, %6u transfers, FIFO max %u, byte wait max %u us, bus gap max %u us\n",
+			name, packets, 100u * packets_during_frame / packets, frames, transfers, max_fifo, max_byte_wait_us, max_bus_idle_us);
+	return 0;
+}
+
+/* blocking command while a frame is on the bus ... SSD1306_WAIT_TX_IDLE must run the rest of the chain itself */
+static int blocking_command(void)
+{
+	uint8_t x, y;
+
+	ssd1306_FillRectangle(0, 8, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1, White); /* frame of many transfers */
+	display_present_now();
+	display_service();
+	CHECK(ssd1306_IsBusy() && sim_i2c_is_dma_busy(), "blocking command: frame not on the bus");
+	transfer_end_us = 0;
+	sim_i2c_hold_dma = false; /* transfers complete right away from here */
+	sim_i2c_bus_busy = false;
+	sim_i2c_complete();
+	ssd1306_SetContrast(0x7F); /* waits for the frame */
+	CHECK(!ssd1306_IsBusy() && !sim_i2c_is_dma_busy(), "blocking command: frame still on the bus");
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "blocking command: controller differs from framebuffer at %u,%u", x, y);
+	return 0;
+}
+
+int main(void)
+{
+	sim_oled_attach();
+	oled_sink = sim_i2c_sink;
+	sim_i2c_sink = bus_sink;
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	display_start_screen();
+	ui_initialize_ui();
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	while(ssd1306_IsBusy())
+		display_service();
+	display_present_now();
+	while(ssd1306_IsBusy())
+		display_service();
+
+	sim_i2c_hold_dma = true;
+	if(run(STREAM_MIXED, false, "mixed") != 0 || run(STREAM_CONTROLLERS, true, "flood") != 0)
+		return 1;
+	if(blocking_command() != 0)
+		return 1;
+
+	printf("test_display_dma: OK\n");
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * test_display_image.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "ssd1306.h"
+#include "ssd1306_fonts.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Column window flush replayed into the simulated controller ... random drawing (pixels, rectangles, lines, text
+ * in both fonts, inversions, area scrolls and row shifts) between flushes, and after every flush the controller
+ * image must equal the framebuffer. Every window must go out as one command transaction (start line, 0x21, 0x22)
+ * followed by one data transaction, and a narrow change must only send its own columns.
+ */
+
+#define TEST_FRAMES		(20000u)
+
+static uint8_t random_below(uint8_t limit)
+{
+	return test_random() % limit;
+}
+
+static void random_drawing(void)
+{
+	uint8_t x1 = random_below(SSD1306_WIDTH + 4), y1 = random_below(SSD1306_HEIGHT + 4);
+	uint8_t x2 = random_below(SSD1306_WIDTH + 4), y2 = random_below(SSD1306_HEIGHT + 4);
+	SSD1306_COLOR color = random_below(2) ? White : Black;
+	char text[8];
+
+	switch(random_below(10))
+	{
+		case 0:
+		case 1:
+			ssd1306_DrawPixel(x1, y1, color);
+			break;
+		case 2:
+			ssd1306_FillRectangle(x1, y1, x2, y2, color);
+			break;
+		case 3:
+			ssd1306_Line(x1, y1, x2, y2, color);
+			break;
+		case 4:
+			ssd1306_Line(x1, y1, x1, y2, color);
+			break;
+		case 5:
+			for(uint8_t i = 0; i < sizeof(text) - 1; i++)
+				text[i] = ' ' + random_below(95);
+			text[sizeof(text) - 1] = '\0';
+			ssd1306_SetCursor(x1 % SSD1306_WIDTH, y1 % SSD1306_HEIGHT);
+			ssd1306_WriteString(text, random_below(4) ? Font_6x8 : Font_7x10, color);
+			break;
+		case 6:
+			ssd1306_InvertRectangle(x1 % SSD1306_WIDTH, y1 % SSD1306_HEIGHT, x2 % SSD1306_WIDTH, y2 % SSD1306_HEIGHT);
+			break;
+		case 7:
+			ssd1306_ScrollUp(1 + random_below(3), 100 + random_below(29));
+			break;
+		case 8:
+			ssd1306_ShiftRows(8, 63, 125, (int8_t)random_below(17) - 8);
+			break;
+		default:
+			if(0 == random_below(8))
+				ssd1306_ResetScroll();
+			else
+				ssd1306_DrawRectangle(x1, y1, x2, y2, color);
+			break;
+	}
+}
+
+static int flush(uint32_t frame)
+{
+	SimOledStats bus;
+	uint8_t x, y;
+
+	sim_oled_reset_stats();
+	ssd1306_UpdateScreen();
+	while(ssd1306_IsBusy()) /* main loop passes */
+		ssd1306_ServiceTransfer();
+	CHECK(!ssd1306_IsBusy() && !ssd1306_IsDirty(), "frame %u: flush left changes behind", frame);
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "frame %u: controller differs from framebuffer at %u,%u", frame, x, y);
+
+	sim_oled_get_stats(&bus);
+	CHECK(bus.command_transactions == bus.data_transactions || bus.command_transactions == bus.data_transactions + 1,
+			"frame %u: %u command transactions for %u data transactions", frame, bus.command_transactions, bus.data_transactions);
+	CHECK(bus.command_bytes <= 7 * bus.command_transactions, "frame %u: %u command bytes in %u transactions", frame,
+			bus.command_bytes, bus.command_transactions);
+	return 0;
+}
+
+int main(void)
+{
+	SimOledStats bus;
+	uint32_t windows = 0, data_bytes = 0;
+
+	sim_oled_attach();
+	ssd1306_Init();
+	while(ssd1306_IsBusy()) /* frame started by ssd1306_Init() */
+		ssd1306_ServiceTransfer();
+	if(flush(0) != 0)
+		return 1;
+
+	/* 3 pixel wide column over the whole height (scroll bar) ... 3 bytes per page, one window per page */
+	sim_oled_reset_stats();
+	ssd1306_FillRectangle(SSD1306_WIDTH - 3, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1, White);
+	ssd1306_UpdateScreen();
+	while(ssd1306_IsBusy())
+		ssd1306_ServiceTransfer();
+	sim_oled_get_stats(&bus);
+	CHECK(8 == bus.data_transactions && 8 * 3 == bus.data_bytes, "scroll bar column: %u data bytes in %u transactions",
+			bus.data_bytes, bus.data_transactions);
+
+	for(uint32_t frame = 1; frame <= TEST_FRAMES; frame++)
+	{
+		for(uint8_t i = 1 + random_below(4); i != 0; i--)
+			random_drawing();
+		if(flush(frame) != 0)
+			return 1;
+		sim_oled_get_stats(&bus);
+		windows += bus.data_transactions;
+		data_bytes += bus.data_bytes;
+	}
+
+	printf("test_display_image: OK (%u frames, %u windows, %u data bytes per window)\n", TEST_FRAMES, windows, data_bytes / windows);
+	return 0;
+}
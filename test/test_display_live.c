@@ -0,0 +1,114 @@
+/*
+ * test_display_live.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <string.h>
+#include "test.h"
+#include "main.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "app_state_machine.h"
+#include "midi_stream.h"
+#include "ssd1306_sim.h"
+
+/*
+ * LIVE view scrolled with the display start line ... what the glass shows (controller RAM read through the start
+ * line) after every packet: the last 7 messages oldest to newest, one per page, the newest on the bottom page, each
+ * pixel as the font draws it and nothing else in the text area, the FIFO bar on the bottom row at the level of the
+ * last packet, and the status line and scroll bar where the framebuffer has them. Bus data per message: the new
+ * line's page, the status page moved to its new RAM page, and (while the FIFO bar is lit) the page the bar is erased
+ * from, which goes out whole because its scroll bar columns change too (one dirty span per page).
+ */
+
+#define TEST_PACKETS	(20000u)
+#define LIVE_LINES		(7u)
+#define LINE_CHARS		(24u)
+
+static char lines[LIVE_LINES][LINE_CHARS];	/* last messages, lines[n % LIVE_LINES] */
+
+static bool glyph_pixel(const char *str, uint8_t x, uint8_t row)
+{
+	uint8_t index = x / DISPLAY_DEFAULT_FONT.width;
+
+	if(index >= strlen(str))
+		return false;
+	return (DISPLAY_DEFAULT_FONT.data[(str[index] - 32) * DISPLAY_DEFAULT_FONT.height + row] << (x % DISPLAY_DEFAULT_FONT.width)) & 0x8000;
+}
+
+static int check_glass(uint32_t n, uint8_t bar_length)
+{
+	uint8_t x, y;
+
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "packet %u: controller differs from framebuffer at %u,%u", n, x, y);
+	for(uint8_t line = 0; line < LIVE_LINES && line <= n; line++) /* line 0 = bottom = newest */
+	{
+		const char *str = lines[(n - line) % LIVE_LINES];
+		uint8_t top = SSD1306_HEIGHT - 8 * (line + 1);
+
+		for(uint8_t row = 0; row < 8; row++)
+		{
+			for(x = 0; x < DISPLAY_LIVE_SCROLL_WIDTH; x++)
+			{
+				bool expected = glyph_pixel(str, x, row);
+
+				if(0 == line && 7 == row)
+					expected = (x < bar_length); /* fifo bar */
+				CHECK(sim_oled_pixel(x, top + row) == expected, "packet %u: line %u \"%s\" pixel %u,%u is %s", n, line, str,
+						x, top + row, expected ? "off" : "on");
+			}
+		}
+	}
+	return 0;
+}
+
+int main(void)
+{
+	stc_midi packet;
+	SimOledStats bus;
+	uint32_t max_data_bytes = 0, data_bytes = 0;
+
+	sim_oled_attach();
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	display_start_screen();
+	ui_initialize_ui();
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	display_present_now();
+	while(ssd1306_IsBusy())
+		display_service();
+
+	stream_init(STREAM_MIXED, 0);
+	for(uint32_t n = 0; n < TEST_PACKETS; n++)
+	{
+		uint8_t bar_length;
+
+		stream_next(&packet);
+		uwTick = packet.time_stamp;
+		fifo_count = test_random() % UART_FIFO_BACKLOG_THRESHOLD;
+		bar_length = fifo_count / (UART_FIFO_SIZE / SSD1306_WIDTH);
+		strncpy(lines[n % LIVE_LINES], midi_process_message(packet.running_status, packet.data[0], packet.data[1]), LINE_CHARS - 1);
+
+		sim_oled_reset_stats();
+		ui_process_midi_packet(&packet);
+		display_present_now();
+		while(ssd1306_IsBusy())
+			display_service();
+		if(check_glass(n, bar_length) != 0)
+			return 1;
+
+		sim_oled_get_stats(&bus);
+		data_bytes += bus.data_bytes;
+		if(n >= LIVE_LINES && bus.data_bytes > max_data_bytes)
+			max_data_bytes = bus.data_bytes;
+	}
+	CHECK(max_data_bytes <= 3 * SSD1306_WIDTH + 16, "%u data bytes for one message", max_data_bytes);
+
+	printf("test_display_live: OK (%u packets, %u data bytes per message, at most %u)\n", TEST_PACKETS,
+			data_bytes / TEST_PACKETS, max_data_bytes);
+	return 0;
+}
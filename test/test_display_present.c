@@ -0,0 +1,130 @@
+/*
+ * test_display_present.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "app_state_machine.h"
+#include "midi_stream.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Flushes per packet for a chord heavy replay ... packets drawn as they arrive, main loop passes every millisecond
+ * calling display_present() as main.c does. Compared with a flush after every packet (the least the old code did,
+ * it flushed after every drawing call). Coalesced flushes must never come closer than DISPLAY_FRAME_INTERVAL_MS,
+ * must carry fewer bytes per packet, and nothing drawn may be left behind once the stream stops.
+ */
+
+#define TEST_PACKETS	(20000u)
+
+static void drain(void)
+{
+	while(ssd1306_IsBusy())
+		display_service();
+}
+
+typedef struct {
+	uint32_t flushes;
+	uint32_t bytes;
+	uint32_t min_interval_ms;
+} Replay;
+
+static uint32_t seen_flushes, last_flush_ms;
+static bool has_flushed;
+
+/* after a main loop pass ... note the interval if it started a flush, let the frame out (bus takes no time here) */
+static void watch(Replay *result)
+{
+	uint32_t count = display_get_flush_count();
+
+	if(count != seen_flushes)
+	{
+		if(has_flushed && uwTick - last_flush_ms < result->min_interval_ms)
+			result->min_interval_ms = uwTick - last_flush_ms;
+		has_flushed = true;
+		last_flush_ms = uwTick;
+		result->flushes += count - seen_flushes;
+		seen_flushes = count;
+	}
+	drain();
+}
+
+static int replay(bool is_coalesced, Replay *result)
+{
+	stc_midi packet;
+	SimOledStats bus;
+	uint8_t x, y;
+
+	result->flushes = 0;
+	result->min_interval_ms = UINT32_MAX;
+	seen_flushes = display_get_flush_count();
+	has_flushed = false;
+	stream_init(STREAM_CHORDS, uwTick + 1);
+	sim_oled_reset_stats();
+	for(uint32_t n = 0; n < TEST_PACKETS; n++)
+	{
+		stream_next(&packet);
+		while(uwTick < packet.time_stamp) /* idle passes until the packet arrives */
+		{
+			uwTick++;
+			if(is_coalesced)
+				display_present();
+			watch(result);
+		}
+		ui_process_midi_packet(&packet);
+		if(is_coalesced)
+			display_present();
+		else
+			display_present_now();
+		watch(result);
+	}
+	for(uint32_t i = 0; i <= DISPLAY_FRAME_INTERVAL_MS; i++) /* stream stopped ... last changes go out */
+	{
+		uwTick++;
+		display_present();
+		watch(result);
+	}
+	CHECK(!ssd1306_IsDirty(), "%s: changes left behind", is_coalesced ? "coalesced" : "per packet");
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "%s: controller differs from framebuffer at %u,%u",
+			is_coalesced ? "coalesced" : "per packet", x, y);
+
+	sim_oled_get_stats(&bus);
+	result->bytes = bus.bytes;
+	return 0;
+}
+
+int main(void)
+{
+	Replay per_packet, coalesced;
+
+	sim_oled_attach();
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	display_start_screen();
+	ui_initialize_ui();
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	display_present_now();
+	drain();
+
+	if(replay(false, &per_packet) != 0 || replay(true, &coalesced) != 0)
+		return 1;
+
+	CHECK(coalesced.min_interval_ms >= DISPLAY_FRAME_INTERVAL_MS, "flushes %u ms apart, frame interval %u ms",
+			coalesced.min_interval_ms, DISPLAY_FRAME_INTERVAL_MS);
+	CHECK(4 * coalesced.flushes < 3 * per_packet.flushes, "%u coalesced flushes against %u per packet", coalesced.flushes,
+			per_packet.flushes);
+	CHECK(coalesced.bytes < per_packet.bytes, "%u bus bytes coalesced against %u per packet", coalesced.bytes, per_packet.bytes);
+
+	printf("  per packet   %.2f flushes/packet, %4u bus bytes/packet\n", (double)per_packet.flushes / TEST_PACKETS,
+			per_packet.bytes / TEST_PACKETS);
+	printf("  coalesced    %.2f flushes/packet, %4u bus bytes/packet, flushes at least %u ms apart\n",
+			(double)coalesced.flushes / TEST_PACKETS, coalesced.bytes / TEST_PACKETS, coalesced.min_interval_ms);
+	printf("test_display_present: OK (%u chord stream packets)\n", TEST_PACKETS);
+	return 0;
+}
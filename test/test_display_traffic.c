@@ -0,0 +1,113 @@
+/*
+ * test_display_traffic.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "filter_channels.h"
+#include "app_state_machine.h"
+#include "midi_stream.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Bytes on the bus for typical display work ... the real display/ui code draws, the simulated controller counts
+ * what every flush sends. A single pixel must only send its own page, live packets and scroll detents must stay
+ * well under a full frame, the driver's own byte count (console `m`) must agree with the bus, and the controller
+ * image must match the framebuffer after every flush.
+ */
+
+#define TEST_LIVE_PACKETS	(2000u)
+#define TEST_DETENTS		(200u)
+#define FULL_FRAME_BYTES	(8u * (1u + 1u + 6u) + 8u * (1u + 1u + SSD1306_WIDTH))	/* every page, window + data */
+
+static int flush(const char *where)
+{
+	uint8_t x, y;
+
+	display_present_now();
+	while(ssd1306_IsBusy()) /* main loop passes */
+		display_service();
+	CHECK(!ssd1306_IsBusy() && !ssd1306_IsDirty(), "%s: flush left changes behind", where);
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "%s: controller differs from framebuffer at %u,%u", where, x, y);
+	return 0;
+}
+
+/* bus bytes per step, and the driver agreeing with the bus */
+static int report(const char *what, uint32_t steps, uint32_t limit)
+{
+	SimOledStats bus;
+	SSD1306_Stats_t driver;
+
+	sim_oled_get_stats(&bus);
+	ssd1306_GetStats(&driver);
+	CHECK(bus.bytes == driver.Bytes, "%s: driver counted %lu bytes, bus carried %u", what, (unsigned long)driver.Bytes, bus.bytes);
+	CHECK(bus.bytes / steps < limit, "%s: %u bytes per step, limit %u", what, bus.bytes / steps, limit);
+	printf("  %-16s %5u bytes/step (full frame %u), %4.1f transactions/step\n", what, bus.bytes / steps, FULL_FRAME_BYTES,
+			(double)bus.transactions / steps);
+	sim_oled_reset_stats();
+	ssd1306_ResetStats();
+	return 0;
+}
+
+int main(void)
+{
+	SimOledStats bus;
+	stc_midi packet;
+
+	sim_oled_attach();
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	if(flush("init") != 0)
+		return 1;
+	display_start_screen();
+	ui_initialize_ui();
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	if(flush("start screen") != 0)
+		return 1;
+
+	/* one pixel ... only its page goes out */
+	sim_oled_reset_stats();
+	ssd1306_ResetStats();
+	ssd1306_DrawPixel(40, 27, White);
+	if(flush("pixel") != 0)
+		return 1;
+	sim_oled_get_stats(&bus);
+	for(uint8_t page = 0; page < 8; page++)
+		CHECK((3 == page) == (bus.page_data_bytes[page] != 0), "pixel on page 3: %u bytes sent to page %u", bus.page_data_bytes[page], page);
+	if(report("one pixel", 1, SSD1306_WIDTH) != 0)
+		return 1;
+
+	/* LIVE ... every packet flushed on its own (worst case, the main loop coalesces packets within a frame interval) */
+	stream_init(STREAM_MIXED, 0);
+	for(uint32_t n = 0; n < TEST_LIVE_PACKETS; n++)
+	{
+		stream_next(&packet);
+		uwTick = packet.time_stamp;
+		ui_process_midi_packet(&packet);
+		if(flush("live") != 0)
+			return 1;
+	}
+	if(report("live packet", TEST_LIVE_PACKETS, FULL_FRAME_BYTES / 2) != 0)
+		return 1;
+
+	/* scroll detents ... down through history, some back up, with and without channel filter */
+	for(uint32_t n = 0; n < TEST_DETENTS; n++)
+	{
+		if(n == TEST_DETENTS / 2)
+			filter_setChannel(2);
+		ui_scroll_history((n % 5 == 4) ? 1 : -1);
+		if(flush("scroll") != 0)
+			return 1;
+	}
+	if(report("scroll detent", TEST_DETENTS, FULL_FRAME_BYTES * 3 / 4) != 0)
+		return 1;
+
+	printf("test_display_traffic: OK\n");
+	return 0;
+}
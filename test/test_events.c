@@ -0,0 +1,240 @@
+/*
+ * test_events.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "main.h"
+#include "events.h"
+
+/*
+ * Event flags and WFI sleep against a simulated interrupt source ... a 72 MHz cycle clock (the DWT counter events.c
+ * reads) with three interrupt sources: the 1 ms tick, MIDI bytes into fifo_count and button edges. Handlers run as
+ * time passes in the main loop, or once interrupts are unmasked if they came while masked. sim_wfi() sleeps until
+ * the next interrupt is pending (it runs after events_wait() unmasks).
+ *
+ * The main loop polls its sources as main.c does (the event bits only end the sleep) and calls events_wait() after
+ * a pass that found nothing. Sometimes an interrupt is made to land between that pass and events_wait(), the window
+ * the masked check closes. Checks: nothing waits behind a sleep (no byte, tick or button left when WFI starts), the
+ * per source post counts match the interrupts, and every idle window reports the time actually spent asleep. MIDI
+ * load changes every second, the idle figure per load is printed.
+ */
+
+#define CYCLES_PER_MS		(72000u)
+#define BYTE_CYCLES			(15000u)	/* FIFO byte, parsing and drawing share */
+#define TICK_CYCLES			(400u)		/* scheduler and display pacing per tick */
+#define BUTTON_CYCLES		(3000u)
+#define TEST_WINDOWS		(24u)
+#define RACE_PERCENT		(10u)		/* of the sleeps, an interrupt lands just before events_wait() */
+
+static const uint32_t midi_rates[] = {0, 400, 1500, 3125};	/* bytes/second per window, cycling */
+#define RATES				(sizeof(midi_rates) / sizeof(midi_rates[0]))
+
+static uint64_t now;				/* cycles since start */
+static uint64_t next_tick, next_byte, next_button;
+static uint32_t ticks_pending, buttons_pending;
+static uint32_t interrupts[4];		/* per event bit */
+static bool is_in_handler;
+
+static uint64_t slept;				/* cycles in WFI, this window */
+static uint64_t window_start;		/* mirror of events.c window */
+static uint32_t late_sleeps, races;
+static uint32_t max_byte_wait;		/* cycles from arrival to the pass taking it */
+static uint64_t byte_arrivals[UART_FIFO_SIZE];
+static uint32_t byte_head, byte_tail;
+
+static uint32_t midi_rate(void)
+{
+	return midi_rates[(now / (CYCLES_PER_MS * EVENTS_IDLE_WINDOW_MS)) % RATES];
+}
+
+static void schedule_byte(void)
+{
+	uint32_t rate = midi_rate();
+
+	if(0 == rate) /* quiet window ... look again at the next one */
+		next_byte = (now / (CYCLES_PER_MS * EVENTS_IDLE_WINDOW_MS) + 1) * CYCLES_PER_MS * EVENTS_IDLE_WINDOW_MS;
+	else
+		next_byte += (uint64_t)CYCLES_PER_MS * 1000u / rate / 2 + test_random() % ((uint64_t)CYCLES_PER_MS * 1000u / rate);
+}
+
+static uint64_t next_interrupt(void)
+{
+	uint64_t next = next_tick;
+
+	if(next_byte < next)
+		next = next_byte;
+	if(next_button < next)
+		next = next_button;
+	return next;
+}
+
+/* run handlers whose interrupt has come ... interrupts unmasked */
+static void deliver(void)
+{
+	if(is_in_handler)
+		return;
+	is_in_handler = true;
+	while(next_interrupt() <= now)
+	{
+		if(next_tick <= now)
+		{
+			next_tick += CYCLES_PER_MS;
+			uwTick++;
+			ticks_pending++;
+			interrupts[1]++;
+			events_post(EVENT_TICK);
+		}
+		else if(next_byte <= now)
+		{
+			if(0 != midi_rate())
+			{
+				byte_arrivals[byte_head++ % UART_FIFO_SIZE] = next_byte;
+				fifo_count++;
+				interrupts[0]++;
+				events_post(EVENT_MIDI_RX);
+			}
+			schedule_byte();
+		}
+		else
+		{
+			next_button += (uint64_t)CYCLES_PER_MS * (100 + test_random() % 500);
+			buttons_pending++;
+			interrupts[2]++;
+			events_post(EVENT_BUTTON);
+		}
+	}
+	is_in_handler = false;
+}
+
+void sim_irq_unmasked(void)
+{
+	deliver();
+}
+
+/* WFI with interrupts masked ... wakes when the next interrupt is pending, its handler runs after unmasking */
+void sim_wfi(void)
+{
+	uint64_t wake = next_interrupt();
+
+	if(0 != fifo_count || 0 != ticks_pending || 0 != buttons_pending)
+		late_sleeps++;
+	if(wake > now)
+	{
+		slept += wake - now;
+		now = wake;
+	}
+	sim_dwt.CYCCNT = (uint32_t)now;
+}
+
+/* main loop work ... interrupts come in as time passes */
+static void work(uint32_t cycles)
+{
+	uint64_t end = now + cycles;
+
+	while(next_interrupt() <= end)
+	{
+		now = next_interrupt();
+		sim_dwt.CYCCNT = (uint32_t)now;
+		deliver();
+	}
+	now = end;
+	sim_dwt.CYCCNT = (uint32_t)now;
+}
+
+/* same window rule as events.c, from the cycles sim_wfi() slept ... -1 while the window is still open */
+static int32_t expected_idle(void)
+{
+	uint64_t elapsed = (uint32_t)((uint32_t)now - (uint32_t)window_start);
+	int32_t permille;
+
+	if(elapsed < (uint64_t)CYCLES_PER_MS * EVENTS_IDLE_WINDOW_MS)
+		return -1;
+	permille = (int32_t)(slept * 1000u / elapsed);
+	window_start += elapsed;
+	slept = 0;
+	return permille;
+}
+
+int main(void)
+{
+	uint32_t window = 0;
+	uint16_t idle_by_rate[RATES] = {0};
+	EventStats stats;
+
+	SystemCoreClock = CYCLES_PER_MS * 1000u;
+	sim_dwt.CYCCNT = 0;
+	events_init();
+	next_tick = CYCLES_PER_MS;
+	next_byte = 0;
+	schedule_byte();
+	next_button = (uint64_t)CYCLES_PER_MS * 250;
+
+	while(window < TEST_WINDOWS)
+	{
+		bool is_busy = false;
+		int32_t idle;
+
+		events_take();
+		idle = expected_idle();
+		if(idle >= 0)
+		{
+			CHECK(events_get_idle_permille() == idle, "window %u: idle %u permille reported, %d slept", window,
+					events_get_idle_permille(), idle);
+			if(window < RATES)
+				idle_by_rate[window] = (uint16_t)idle;
+			window++;
+		}
+
+		if(0 != fifo_count) /* one byte per pass */
+		{
+			uint64_t wait = now - byte_arrivals[byte_tail++ % UART_FIFO_SIZE];
+
+			if(wait > max_byte_wait)
+				max_byte_wait = (uint32_t)wait;
+			fifo_count--;
+			work(BYTE_CYCLES);
+			is_busy = true;
+		}
+		if(0 != ticks_pending)
+		{
+			ticks_pending--;
+			work(TICK_CYCLES);
+			is_busy = true;
+		}
+		if(0 != buttons_pending)
+		{
+			buttons_pending--;
+			work(BUTTON_CYCLES);
+			is_busy = true;
+		}
+
+		if(false == is_busy)
+		{
+			if(test_random() % 100 < RACE_PERCENT) /* pass is over, next interrupt comes before events_wait() masks */
+			{
+				now = next_interrupt();
+				sim_dwt.CYCCNT = (uint32_t)now;
+				deliver();
+				races++;
+			}
+			events_wait();
+		}
+	}
+
+	events_get_stats(&stats);
+	CHECK(0 == late_sleeps, "%u sleeps with work waiting", late_sleeps);
+	for(uint8_t i = 0; i < 3; i++)
+		CHECK(stats.posted[i] == interrupts[i], "event bit %u posted %u times, %u interrupts", i, stats.posted[i], interrupts[i]);
+	CHECK(max_byte_wait < 2 * (BYTE_CYCLES + TICK_CYCLES + BUTTON_CYCLES), "a byte waited %u cycles", max_byte_wait);
+
+	printf("  %u sleeps (%u with an interrupt just before events_wait()), %u ticks, %u bytes, %u button edges\n",
+			stats.sleeps, races, interrupts[1], interrupts[0], interrupts[2]);
+	printf("  idle at");
+	for(uint8_t i = 0; i < RATES; i++)
+		printf(" %u bytes/s %.1f %%%s", midi_rates[i], idle_by_rate[i] / 10.0, (i + 1 < RATES) ? "," : "\n");
+	printf("test_events: OK (%u windows, idle figure matches time asleep, nothing slept through)\n", TEST_WINDOWS);
+	return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * test_fill.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "test.h"
+#include "ssd1306.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Page-at-a-time ssd1306_FillRectangle(), and the horizontal/vertical ssd1306_Line() and ssd1306_DrawRectangle()
+ * built on it, against the per-pixel routines they replaced (copied below from the original library). Random
+ * corners in any order, out of range coordinates included, over a random background at a random start line
+ * offset, must leave the same framebuffer and send the same bytes to every page (same dirty windows). Host time
+ * per call for the two fills the UI does most, useful for comparing the routines, not as a figure for the target.
+ */
+
+#define TEST_CASES		(50000u)
+#define BENCH_CALLS		(200000u)
+
+/* original routines ... pixel by pixel */
+static void old_fill(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color)
+{
+	uint8_t x_start = ((x1<=x2) ? x1 : x2);
+	uint8_t x_end   = ((x1<=x2) ? x2 : x1);
+	uint8_t y_start = ((y1<=y2) ? y1 : y2);
+	uint8_t y_end   = ((y1<=y2) ? y2 : y1);
+
+	for (uint8_t y= y_start; (y<= y_end)&&(y<SSD1306_HEIGHT); y++) {
+		for (uint8_t x= x_start; (x<= x_end)&&(x<SSD1306_WIDTH); x++) {
+			ssd1306_DrawPixel(x, y, color);
+		}
+	}
+}
+
+static void old_line(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color)
+{
+	int32_t deltaX = abs(x2 - x1);
+	int32_t deltaY = abs(y2 - y1);
+	int32_t signX = ((x1 < x2) ? 1 : -1);
+	int32_t signY = ((y1 < y2) ? 1 : -1);
+	int32_t error = deltaX - deltaY;
+	int32_t error2;
+
+	ssd1306_DrawPixel(x2, y2, color);
+
+	while((x1 != x2) || (y1 != y2)) {
+		ssd1306_DrawPixel(x1, y1, color);
+		error2 = error * 2;
+		if(error2 > -deltaY) {
+			error -= deltaY;
+			x1 += signX;
+		}
+
+		if(error2 < deltaX) {
+			error += deltaX;
+			y1 += signY;
+		}
+	}
+}
+
+static void old_rectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color)
+{
+	old_line(x1,y1,x2,y1,color);
+	old_line(x2,y1,x2,y2,color);
+	old_line(x2,y2,x1,y2,color);
+	old_line(x1,y2,x1,y1,color);
+}
+
+typedef void (*DrawFunction)(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color);
+
+typedef struct {
+	const char *name;
+	DrawFunction old, new;
+	uint32_t cases;
+} Routine;
+
+static Routine routines[] = {
+	{"fill", old_fill, ssd1306_FillRectangle, 0},
+	{"line", old_line, ssd1306_Line, 0},
+	{"rectangle", old_rectangle, ssd1306_DrawRectangle, 0}
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void flush(void)
+{
+	ssd1306_UpdateScreen();
+	while(ssd1306_IsBusy())
+		ssd1306_ServiceTransfer();
+}
+
+/* same background and start line offset for a given seed */
+static void background(uint32_t seed)
+{
+	ssd1306_ResetScroll();
+	ssd1306_Fill((seed & 1) ? White : Black);
+	for(uint8_t i = 0; i < 40; i++)
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		if(i < 8)
+			old_fill(seed % 128, (seed >> 7) % 64, (seed >> 13) % 128, (seed >> 20) % 64, (seed >> 27) & 1 ? White : Black);
+		else
+			ssd1306_DrawPixel(seed % 128, (seed >> 7) % 64, (seed >> 13) & 1 ? White : Black);
+	}
+	for(uint8_t i = seed % 8; i != 0; i--)
+		ssd1306_ScrollUp(seed & 0x100 ? 1 : 0, SSD1306_WIDTH - 3);
+	flush();
+}
+
+static void render(DrawFunction draw, uint32_t seed, const uint8_t *corner, SSD1306_COLOR color,
+		bool image[SSD1306_HEIGHT][SSD1306_WIDTH], SimOledStats *bus)
+{
+	background(seed);
+	sim_oled_reset_stats();
+	draw(corner[0], corner[1], corner[2], corner[3], color);
+	for(uint8_t row = 0; row < SSD1306_HEIGHT; row++)
+	{
+		for(uint8_t col = 0; col < SSD1306_WIDTH; col++)
+			image[row][col] = (White == ssd1306_GetPixel(col, row));
+	}
+	flush();
+	sim_oled_get_stats(bus);
+}
+
+/* random corner ... mostly on screen, some past the edge */
+static uint8_t coordinate(uint8_t size)
+{
+	return test_random() % (size + 8);
+}
+
+/* us per call */
+static double call_us(DrawFunction fill, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+	uint64_t start = now_ns();
+
+	for(uint32_t n = 0; n < BENCH_CALLS; n++)
+		fill(x1, y1, x2, y2, (n & 1) ? White : Black);
+	return (double)(now_ns() - start) / 1e3 / BENCH_CALLS;
+}
+
+int main(void)
+{
+	static bool old_image[SSD1306_HEIGHT][SSD1306_WIDTH], new_image[SSD1306_HEIGHT][SSD1306_WIDTH];
+	SimOledStats old_bus, new_bus;
+	double page_old, page_new, bar_old, bar_new;
+
+	sim_oled_attach();
+	ssd1306_Init();
+	while(ssd1306_IsBusy())
+		ssd1306_ServiceTransfer();
+
+	for(uint32_t n = 0; n < TEST_CASES; n++)
+	{
+		Routine *routine = &routines[test_random() % (sizeof(routines) / sizeof(routines[0]))];
+		uint32_t seed = test_random() | 1u << 31;
+		SSD1306_COLOR color = (test_random() & 1) ? White : Black;
+		uint8_t corner[4] = {coordinate(SSD1306_WIDTH), coordinate(SSD1306_HEIGHT), coordinate(SSD1306_WIDTH), coordinate(SSD1306_HEIGHT)};
+
+		switch(test_random() % 4) /* lines are only span filled when straight */
+		{
+			case 0:
+				corner[2] = corner[0];
+				break;
+			case 1:
+				corner[3] = corner[1];
+				break;
+			default:
+				break;
+		}
+
+		render(routine->old, seed, corner, color, old_image, &old_bus);
+		render(routine->new, seed, corner, color, new_image, &new_bus);
+		for(uint8_t row = 0; row < SSD1306_HEIGHT; row++)
+		{
+			for(uint8_t col = 0; col < SSD1306_WIDTH; col++)
+				CHECK(old_image[row][col] == new_image[row][col], "case %u %s %u,%u %u,%u: pixel %u,%u differs", n, routine->name,
+						corner[0], corner[1], corner[2], corner[3], col, row);
+		}
+		for(uint8_t page = 0; page < 8; page++)
+			CHECK(old_bus.page_data_bytes[page] == new_bus.page_data_bytes[page], "case %u %s %u,%u %u,%u: page %u sent %u bytes, per-pixel %u",
+					n, routine->name, corner[0], corner[1], corner[2], corner[3], page, new_bus.page_data_bytes[page], old_bus.page_data_bytes[page]);
+		routine->cases++;
+	}
+
+	/* display_clear_page() area and a scroll bar column */
+	page_old = call_us(old_fill, 0, 8, SSD1306_WIDTH - 4, SSD1306_HEIGHT - 2);
+	page_new = call_us(ssd1306_FillRectangle, 0, 8, SSD1306_WIDTH - 4, SSD1306_HEIGHT - 2);
+	bar_old = call_us(old_fill, SSD1306_WIDTH - 3, 4, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 5);
+	bar_new = call_us(ssd1306_FillRectangle, SSD1306_WIDTH - 3, 4, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 5);
+	CHECK(page_new < page_old && bar_new < bar_old, "fill slower than per-pixel: page %.2f/%.2f us, bar %.2f/%.2f us",
+			page_new, page_old, bar_new, bar_old);
+
+	printf("  identical: %u fills, %u lines, %u rectangles\n", routines[0].cases, routines[1].cases, routines[2].cases);
+	printf("  clear page 125x55  %6.2f -> %5.2f us/call\n", page_old, page_new);
+	printf("  scroll bar 3x56    %6.2f -> %5.2f us/call\n", bar_old, bar_new);
+	printf("test_fill: OK\n");
+	return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * test_find_time.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <stdlib.h>
+#include "test.h"
+#include "history.h"
+#include "session.h"
+#include "midi_stream.h"
+
+/*
+ * history_find_time() against a nearest-record scan, on both backends ... one stream runs through a series of
+ * sessions, each restarted the way ui_initialize_ui() does it (empty history, session clock started by the first
+ * packet). The stream starts short of 2^32 so early sessions span the HAL tick rollover, later ones start after it.
+ * Targets are random offsets from the session start, including ones before the oldest and after the newest record.
+ */
+
+#define TEST_SESSIONS			(24u)
+#define TEST_SESSION_RECORDS	(5000u)		/* up to, random length per session */
+#define TEST_SEARCHES			(40u)		/* searches after every TEST_SEARCH_INTERVAL appends */
+#define TEST_SEARCH_INTERVAL	(97u)
+
+static int64_t distance(uint32_t sequence, uint32_t base, uint32_t offset_ms)
+{
+	stc_midi_history record;
+
+	history_read(sequence, &record);
+	return llabs((int64_t)(record.time_stamp - base) - offset_ms);
+}
+
+static int check_search(const char *name, uint32_t offset_ms)
+{
+	uint32_t base = session_getStartTimestamp();
+	uint32_t found = history_find_time(base, offset_ms);
+	uint32_t nearest = history_oldest();
+
+	CHECK(found - history_oldest() < history_count(), "%s: record %u for %u ms outside window", name, found, offset_ms);
+	for(uint32_t sequence = history_oldest(); sequence != history_total(); sequence++)
+	{
+		if(distance(sequence, base, offset_ms) < distance(nearest, base, offset_ms))
+			nearest = sequence;
+	}
+	CHECK(distance(found, base, offset_ms) == distance(nearest, base, offset_ms), "%s: %u ms found record %u (%lld ms off), nearest %u (%lld ms off)",
+			name, offset_ms, found, (long long)distance(found, base, offset_ms), nearest, (long long)distance(nearest, base, offset_ms));
+	return 0;
+}
+
+static int run_backend(const HistoryBackend *backend)
+{
+	stc_midi packet;
+	stc_midi_history record;
+	uint32_t rollovers = 0, searches = 0;
+
+	stream_init(STREAM_MIXED, 0xFFFFFFFFu - 1800000u);
+	for(uint32_t session = 0; session < TEST_SESSIONS; session++)
+	{
+		uint32_t records = 1 + test_random() % TEST_SESSION_RECORDS;
+
+		history_init(backend); /* new session */
+		session_stop();
+		CHECK(history_find_time(0, 0) == history_oldest(), "%s: search in empty history", backend->name);
+		for(uint32_t n = 1; n <= records; n++)
+		{
+			stream_next(&packet);
+			if(false == session_isActive())
+				session_start(packet.time_stamp);
+			history_append(&packet);
+			if(0 == test_random() % 3000) /* trigger froze a window */
+				history_evict_before(history_oldest() + test_random() % history_count());
+
+			if(0 == n % TEST_SEARCH_INTERVAL || n == records)
+			{
+				uint32_t length;
+
+				history_read(history_newest(), &record);
+				length = session_getDeltaTime(record.time_stamp);
+				for(uint32_t s = 0; s < TEST_SEARCHES; s++)
+				{
+					if(check_search(backend->name, test_random() % (length + 2000)) != 0)
+						return 1;
+				}
+				if(check_search(backend->name, 0) != 0 || check_search(backend->name, length) != 0)
+					return 1;
+				searches += TEST_SEARCHES + 2;
+			}
+		}
+		if(stream_time() < session_getStartTimestamp())
+			rollovers++;
+	}
+	CHECK(1 == rollovers, "%s: %u sessions spanned the tick rollover", backend->name, rollovers);
+
+	printf("  %-10s %u sessions (one across rollover), %u searches\n", backend->name, TEST_SESSIONS, searches);
+	return 0;
+}
+
+int main(void)
+{
+	if(run_backend(&history_sram_backend) != 0 || run_backend(&history_compressed_backend) != 0)
+		return 1;
+	printf("test_find_time: OK\n");
+	return 0;
+}
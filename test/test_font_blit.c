@@ -0,0 +1,137 @@
+/*
+ * test_font_blit.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <time.h>
+#include "test.h"
+#include "ssd1306.h"
+#include "ssd1306_fonts.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Font_6x8 column blitter against the per-pixel renderer it replaced ... the same font without its columns table
+ * takes the old ssd1306_DrawPixel() path. Random strings at random positions and colours over a random background
+ * must leave the same framebuffer and send the same bytes to every page (same dirty windows). Host chars/second
+ * for both paths, useful for comparing them, not as a figure for the target.
+ */
+
+#define TEST_CASES		(20000u)
+#define BENCH_CHARS		(4000000u)
+#define BENCH_LINE		(21u)		/* characters per display line */
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void flush(void)
+{
+	ssd1306_UpdateScreen();
+	while(ssd1306_IsBusy())
+		ssd1306_ServiceTransfer();
+}
+
+/* same background for a given seed ... rectangles and pixels in both colours */
+static void background(uint32_t seed)
+{
+	ssd1306_Fill((seed & 1) ? White : Black);
+	for(uint8_t i = 0; i < 40; i++)
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		if(i < 8)
+			ssd1306_FillRectangle(seed % 128, (seed >> 7) % 64, (seed >> 13) % 128, (seed >> 20) % 64, (seed >> 27) & 1 ? White : Black);
+		else
+			ssd1306_DrawPixel(seed % 128, (seed >> 7) % 64, (seed >> 13) & 1 ? White : Black);
+	}
+	flush();
+}
+
+/* string drawn over the background, framebuffer and per page bus bytes of the flush that follows */
+static void render(SSD1306_Font_t font, uint32_t seed, uint8_t x, uint8_t y, char *text, SSD1306_COLOR color,
+		bool image[SSD1306_HEIGHT][SSD1306_WIDTH], SimOledStats *bus)
+{
+	background(seed);
+	sim_oled_reset_stats();
+	ssd1306_SetCursor(x, y);
+	ssd1306_WriteString(text, font, color);
+	for(uint8_t row = 0; row < SSD1306_HEIGHT; row++)
+	{
+		for(uint8_t col = 0; col < SSD1306_WIDTH; col++)
+			image[row][col] = (White == ssd1306_GetPixel(col, row));
+	}
+	flush();
+	sim_oled_get_stats(bus);
+}
+
+static double chars_per_second(SSD1306_Font_t font)
+{
+	char line[BENCH_LINE + 1];
+	uint64_t start;
+
+	for(uint8_t i = 0; i < BENCH_LINE; i++)
+		line[i] = ' ' + (i * 7) % 95;
+	line[BENCH_LINE] = '\0';
+
+	start = now_ns();
+	for(uint32_t n = 0; n < BENCH_CHARS / BENCH_LINE; n++)
+	{
+		ssd1306_SetCursor(0, 9 * (n % 7)); /* display line pitch, most lines straddle two pages */
+		ssd1306_WriteString(line, font, (n & 8) ? Black : White);
+	}
+	return (double)BENCH_CHARS * 1e9 / (double)(now_ns() - start);
+}
+
+int main(void)
+{
+	static bool old_image[SSD1306_HEIGHT][SSD1306_WIDTH], new_image[SSD1306_HEIGHT][SSD1306_WIDTH];
+	const SSD1306_Font_t per_pixel = {Font_6x8.width, Font_6x8.height, Font_6x8.data, NULL, NULL}; /* old path */
+	SimOledStats old_bus, new_bus;
+	double old_rate, new_rate;
+
+	sim_oled_attach();
+	ssd1306_Init();
+	while(ssd1306_IsBusy())
+		ssd1306_ServiceTransfer();
+
+	for(uint32_t n = 0; n < TEST_CASES; n++)
+	{
+		uint32_t seed = test_random() | 1u << 31;
+		uint8_t x = test_random() % SSD1306_WIDTH, y = test_random() % (SSD1306_HEIGHT - 7);
+		SSD1306_COLOR color = (test_random() & 1) ? White : Black;
+		char text[1 + BENCH_LINE];
+		uint8_t length = test_random() % (sizeof(text) - 1);
+
+		for(uint8_t i = 0; i < length; i++)
+			text[i] = ' ' + test_random() % 95;
+		text[length] = '\0';
+
+		render(per_pixel, seed, x, y, text, color, old_image, &old_bus);
+		render(Font_6x8, seed, x, y, text, color, new_image, &new_bus);
+		for(uint8_t row = 0; row < SSD1306_HEIGHT; row++)
+		{
+			for(uint8_t col = 0; col < SSD1306_WIDTH; col++)
+				CHECK(old_image[row][col] == new_image[row][col], "case %u \"%s\" at %u,%u: pixel %u,%u differs", n, text, x, y, col, row);
+		}
+		for(uint8_t page = 0; page < 8; page++)
+			CHECK(old_bus.page_data_bytes[page] == new_bus.page_data_bytes[page], "case %u \"%s\" at %u,%u: page %u sent %u bytes, per-pixel %u",
+					n, text, x, y, page, new_bus.page_data_bytes[page], old_bus.page_data_bytes[page]);
+		CHECK(old_bus.data_transactions == new_bus.data_transactions, "case %u: %u windows, per-pixel %u", n,
+				new_bus.data_transactions, old_bus.data_transactions);
+	}
+
+	old_rate = chars_per_second(per_pixel);
+	new_rate = chars_per_second(Font_6x8);
+	CHECK(new_rate > 2.0 * old_rate, "blitter %.1f M chars/s, per-pixel %.1f M chars/s", new_rate / 1e6, old_rate / 1e6);
+
+	printf("test_font_blit: OK (%u cases identical, per-pixel %.1f M chars/s, blitter %.1f M chars/s, %.1fx)\n", TEST_CASES,
+			old_rate / 1e6, new_rate / 1e6, new_rate / old_rate);
+	return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * test_history.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "history.h"
+#include "history_file.h"
+#include "midi_stream.h"
+
+/*
+ * Target backends against the file backend ... the same stream is appended to a target backend (through
+ * history.c, as ui.c uses it) and to the reference, with random evict_before() calls as the trigger makes them.
+ * Every record a target backend still holds must read back as the reference has it, the SRAM ring must hold
+ * exactly the newest NUMBER_PAGES records, nothing outside [oldest, next) may be readable.
+ */
+
+#define TEST_RECORDS		(300000u)
+#define TEST_FULL_SCAN		(997u)		/* appends between full window comparisons */
+
+static const HistoryBackend *reference = &history_file_backend;
+
+static bool same_record(const stc_midi_history *a, const stc_midi_history *b)
+{
+	return a->running_status == b->running_status && a->data[0] == b->data[0] && a->data[1] == b->data[1]
+			&& a->time_stamp == b->time_stamp && a->channel == b->channel;
+}
+
+/* every record of the backend's window against the reference, and the records just outside it */
+static int check_window(const char *name)
+{
+	stc_midi_history record, expected;
+	uint32_t oldest = history_oldest(), next = history_total();
+
+	for(uint32_t sequence = oldest; sequence != next; sequence++)
+	{
+		CHECK(history_read(sequence, &record), "%s: sequence %u in window not readable", name, sequence);
+		CHECK(reference->read(sequence, &expected), "%s: sequence %u evicted from reference", name, sequence);
+		CHECK(same_record(&record, &expected), "%s: sequence %u differs from reference", name, sequence);
+	}
+	for(uint32_t offset = 1; offset <= 3; offset++)
+	{
+		CHECK(!history_read(oldest - offset, &record), "%s: evicted sequence %u readable", name, oldest - offset);
+		CHECK(!history_read(next + offset - 1, &record), "%s: unwritten sequence %u readable", name, next + offset - 1);
+	}
+	return 0;
+}
+
+static int run_backend(const HistoryBackend *backend, StreamStyle style, uint32_t start_ms)
+{
+	stc_midi packet;
+	stc_midi_history record, expected;
+
+	history_init(backend);
+	reference->reset();
+	stream_init(style, start_ms);
+	for(uint32_t n = 1; n <= TEST_RECORDS; n++)
+	{
+		stream_next(&packet);
+		CHECK(history_append(&packet) == n - 1, "%s: sequence number of record %u", backend->name, n);
+		record.running_status = packet.running_status;
+		record.data[0] = packet.data[0];
+		record.data[1] = packet.data[1];
+		record.time_stamp = packet.time_stamp;
+		record.channel = packet.channel;
+		reference->append(&record);
+
+		if(0 == test_random() % 5000) /* freeze window ... drop everything older than a random retained record */
+		{
+			uint32_t sequence = history_oldest() + test_random() % (history_count() + 1);
+
+			history_evict_before(sequence);
+			reference->evict_before(sequence);
+		}
+
+		CHECK(history_total() == reference->next(), "%s: next %u, reference %u", backend->name, history_total(), reference->next());
+		CHECK((int32_t)(history_oldest() - reference->oldest()) >= 0, "%s: holds record %u evicted by request", backend->name, history_oldest());
+		if(&history_sram_backend == backend)
+		{
+			uint32_t ring_oldest = (n > NUMBER_PAGES) ? n - NUMBER_PAGES : 0;
+			uint32_t oldest = ((int32_t)(reference->oldest() - ring_oldest) > 0) ? reference->oldest() : ring_oldest;
+
+			CHECK(history_oldest() == oldest, "%s: oldest %u, expected %u", backend->name, history_oldest(), oldest);
+		}
+		CHECK(0 == history_count() || (history_read(n - 1, &record) && reference->read(n - 1, &expected)
+				&& same_record(&record, &expected)), "%s: newest record %u differs from reference", backend->name, n - 1);
+		if(0 == n % TEST_FULL_SCAN && check_window(backend->name) != 0)
+			return 1;
+	}
+	if(check_window(backend->name) != 0)
+		return 1;
+
+	printf("  %-10s %u records, %u held at end\n", backend->name, TEST_RECORDS, history_count());
+	return 0;
+}
+
+int main(void)
+{
+	static const StreamStyle styles[] = {STREAM_MIXED, STREAM_CHORDS, STREAM_CONTROLLERS};
+	static const HistoryBackend *backends[] = {&history_sram_backend, &history_compressed_backend};
+
+	CHECK(history_file_open("history_file.bin"), "cannot map history_file.bin");
+	for(uint8_t b = 0; b < 2; b++)
+	{
+		for(uint8_t s = 0; s < 3; s++)
+		{
+			if(run_backend(backends[b], styles[s], 0xFFFFFFFFu - 600000u * s) != 0)
+				return 1;
+		}
+	}
+	history_file_close();
+	printf("test_history: OK\n");
+	return 0;
+}
@@ -0,0 +1,312 @@
+/*
+ * test_loop_monitor.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <string.h>
+#include "test.h"
+#include "main.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "profile.h"
+#include "loop_monitor.h"
+#include "app_state_machine.h"
+#include "midi_stream.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Main loop monitor against a slow display backend ... main loop as main.c (packet, one task, display, marks
+ * around each stage) on a simulated 72 MHz cycle clock (profile_host_cycles() wrapped), ms derived from it. I2C
+ * transfers cost CPU time per byte as a blocking bus would, and for stretches the display holds the bus (clock
+ * stretching, BYTE_SLOW_CYCLES a byte) so a page takes longer than LOOP_STALL_THRESHOLD_MS. A 1 ms "meter" task
+ * runs in most passes, a "blocker" timer stalls the task stage, the "encoder" task scrolls back and returns to LIVE.
+ * Splash screen first, MIDI stream after it.
+ *
+ * Every pass is timed here by stage as well. Checks: stall count, pass count and the PROFILE_MAIN_LOOP histogram
+ * as counted here, the longest pass with its stage and the task run in it (also when the display took the time),
+ * the '!' flag in its cell right of the status/channel separator whenever a stall was less than LOOP_STALL_FLAG_MS
+ * ago (blank otherwise), never over the splash screen, drawn with the start screen when the splash ends, nothing
+ * else on the status line changed by it, and the glass matching the framebuffer whenever a frame is complete.
+ */
+
+#define CYCLES_PER_MS		(72000u)
+#define START_MS			(1000u)
+#define TEST_MS				(60000u)
+#define BYTE_CYCLES			(1800u)		/* 25 us ... 400 kHz, blocking */
+#define BYTE_SLOW_CYCLES	(CYCLES_PER_MS)	/* display stretching the clock, 1 ms a byte */
+#define PACKET_CYCLES		(9000u)		/* parse, history, drawing */
+#define METER_CYCLES		(1500u)
+#define BLOCKER_MS			(60u)
+#define BLOCKER_AT_MS		(4500u)		/* during the splash, flag must wait for the start screen */
+#define SLOW_EVERY_MS		(7000u)		/* backend slow for SLOW_FOR_MS out of every SLOW_EVERY_MS */
+#define SLOW_FOR_MS			(400u)
+#define FLAG_X				((STATUS_LINE_STATUS_WIDTH + 1) * DISPLAY_DEFAULT_FONT.width + 3)	/* pixel column of '!' */
+
+static uint64_t cycles;
+static bool is_slow;
+static SimI2cSink oled_sink;
+static const char *ran_task;				/* this pass, as seen here */
+static uint32_t blocker_runs;
+static TaskId blocker;
+
+typedef struct {
+	uint32_t passes;
+	uint32_t stalls;
+	uint32_t flag_toggles;
+	uint32_t flag_checks;					/* passes with the flag cell checked on */
+	uint32_t splash_stalls;
+	uint32_t settled_frames;				/* glass compared with the framebuffer */
+	uint32_t scrolls;
+	uint32_t packets;
+	LoopStall longest;
+} Reference;
+
+static Reference ref;
+
+uint32_t __wrap_profile_host_cycles(void)
+{
+	return (uint32_t)cycles;
+}
+
+static void advance(uint64_t n)
+{
+	cycles += n;
+	uwTick = START_MS + (uint32_t)(cycles / CYCLES_PER_MS);
+}
+
+static uint32_t elapsed_ms(void)
+{
+	return uwTick - START_MS;
+}
+
+/* blocking bus ... CPU waits for every byte */
+static void slow_sink(uint16_t address, const uint8_t *data, uint16_t size)
+{
+	oled_sink(address, data, size);
+	advance((uint64_t)(size + 1) * (is_slow ? BYTE_SLOW_CYCLES : BYTE_CYCLES));
+}
+
+static void meter(void)
+{
+	advance(METER_CYCLES);
+}
+
+static void block(void)
+{
+	blocker_runs++;
+	advance((uint64_t)BLOCKER_MS * CYCLES_PER_MS);
+}
+
+/* a few detents back now and then, back to LIVE after a while ... INDEX on the status line meanwhile */
+static void encoder(void)
+{
+	uint32_t roll = test_random() % 16;
+
+	if(APP_STATE_SPLASH == app_get_state())
+		return;
+	if(APP_STATE_SCROLL_HISTORY == app_get_state() && roll < 4)
+		ui_scroll_history(10000); /* past the newest ... LIVE */
+	else if(roll < 3)
+		ui_scroll_history(-(int16_t)(1 + test_random() % 3));
+	else
+		return;
+	ref.scrolls++;
+}
+
+static bool is_flag_cell_right(bool is_on, uint8_t *x, uint8_t *y)
+{
+	for(*x = FLAG_X - 1; *x <= FLAG_X + 1; (*x)++)
+	{
+		for(*y = 0; *y < DISPLAY_DEFAULT_FONT.height; (*y)++)
+		{
+			bool expected = is_on && FLAG_X == *x && (*y <= DISPLAY_DEFAULT_FONT.height - 4 || DISPLAY_DEFAULT_FONT.height - 2 == *y);
+
+			if((White == ssd1306_GetPixel(*x, *y)) != expected)
+				return false;
+		}
+	}
+	return true;
+}
+
+static void status_line(bool line[][SSD1306_WIDTH])
+{
+	for(uint8_t y = 0; y < DISPLAY_DEFAULT_FONT.height; y++)
+		for(uint8_t x = 0; x < SSD1306_WIDTH; x++)
+			line[y][x] = (White == ssd1306_GetPixel(x, y));
+}
+
+int main(void)
+{
+	bool splash[8][SSD1306_WIDTH], before[8][SSD1306_WIDTH], after[8][SSD1306_WIDTH];
+	bool is_flag_on = false;
+	uint32_t last_stall_ms = 0, wakeup;
+	uint64_t stall_cycles = (uint64_t)LOOP_STALL_THRESHOLD_MS * CYCLES_PER_MS;
+	stc_midi packet;
+	LoopMonitorStats stats;
+	ProfileStats pass_profile;
+	uint32_t histogram = 0;
+	uint8_t x, y;
+
+	SystemCoreClock = CYCLES_PER_MS * 1000u;
+	uwTick = START_MS;
+	sim_oled_attach();
+	oled_sink = sim_i2c_sink;
+	sim_i2c_sink = slow_sink;
+	scheduler_init();
+	ui_init_tasks();
+	scheduler_add_task("meter", meter, 1, TASK_PRIORITY_NORMAL, 0);
+	scheduler_add_task("encoder", encoder, 250, TASK_PRIORITY_LOW, 0);
+	blocker = scheduler_add_timer("blocker", block, TASK_PRIORITY_LOW, 0);
+	scheduler_start_timer(blocker, BLOCKER_AT_MS);
+	display_init();
+	ui_initialize_ui();
+	ui_show_splash();
+	status_line(splash);
+	loop_monitor_init();
+	profile_reset();
+	stream_init(STREAM_MIXED, START_MS + 100);
+	stream_next(&packet);
+
+	while(elapsed_ms() < TEST_MS)
+	{
+		uint64_t pass_start = cycles, stage_start = cycles, stage_cycles[LOOP_STAGE_COUNT] = {0};
+		LoopStage stage = LOOP_STAGE_MIDI_FIFO;
+		bool is_busy = false, was_splash;
+		uint32_t ms;
+
+		is_slow = (elapsed_ms() % SLOW_EVERY_MS < SLOW_FOR_MS) || APP_STATE_SPLASH == app_get_state();
+		scheduler_advance(uwTick); /* tick interrupts while the last pass ran */
+		ran_task = NULL;
+		loop_monitor_begin();
+		loop_monitor_mark(LOOP_STAGE_MIDI_FIFO); /* packets come whole from the stream here */
+		stage_start = cycles;
+
+		if((int32_t)(uwTick - packet.time_stamp) >= 0)
+		{
+			ui_process_midi_packet(&packet);
+			advance(PACKET_CYCLES);
+			stream_next(&packet);
+			ref.packets++;
+			is_busy = true;
+		}
+		loop_monitor_mark(LOOP_STAGE_MIDI_PACKET);
+		stage_cycles[LOOP_STAGE_MIDI_PACKET] = cycles - stage_start;
+		stage_start = cycles;
+
+		if(scheduler_dispatch(TASK_PRIORITY_LOW))
+		{
+			is_busy = true;
+			ran_task = scheduler_get_last_task_name();
+			loop_monitor_task_ran();
+		}
+		loop_monitor_mark(LOOP_STAGE_TASK);
+		stage_cycles[LOOP_STAGE_TASK] = cycles - stage_start;
+		stage_start = cycles;
+
+		if(display_service())
+			is_busy = true;
+		display_present();
+		loop_monitor_mark(LOOP_STAGE_DISPLAY);
+		stage_cycles[LOOP_STAGE_DISPLAY] = cycles - stage_start;
+		loop_monitor_mark(LOOP_STAGE_CONSOLE);
+
+		/* same rules as loop_monitor.c, from the time charged here */
+		for(LoopStage s = 0; s < LOOP_STAGE_COUNT; s++)
+		{
+			if(stage_cycles[s] > stage_cycles[stage])
+				stage = s;
+		}
+		ms = uwTick;
+		if(cycles - pass_start > ref.longest.cycles)
+			ref.longest = (LoopStall){ .cycles = (uint32_t)(cycles - pass_start), .stage_cycles = (uint32_t)stage_cycles[stage],
+					.stage = stage, .task = ran_task, .time_ms = ms };
+		ref.passes++;
+		was_splash = (APP_STATE_SPLASH == app_get_state());
+		status_line(before);
+		if(cycles - pass_start > stall_cycles)
+		{
+			ref.stalls++;
+			ref.flag_toggles += is_flag_on ? 0 : 1;
+			ref.splash_stalls += was_splash ? 1 : 0;
+			is_flag_on = true;
+			last_stall_ms = ms;
+		}
+		else if(is_flag_on && ms - last_stall_ms > LOOP_STALL_FLAG_MS)
+		{
+			is_flag_on = false;
+			ref.flag_toggles++;
+		}
+		loop_monitor_end();
+		status_line(after);
+
+		if(was_splash)
+		{
+			CHECK(0 == memcmp(after, splash, sizeof(splash)), "%u ms: splash status line changed (stall flag %s)", elapsed_ms(),
+					is_flag_on ? "on" : "off");
+		}
+		else
+		{
+			CHECK(is_flag_cell_right(is_flag_on, &x, &y), "%u ms: stall flag cell pixel %u,%u wrong, flag should be %s", elapsed_ms(),
+					x, y, is_flag_on ? "on" : "off");
+			for(y = 0; y < DISPLAY_DEFAULT_FONT.height; y++)
+				for(x = 0; x < SSD1306_WIDTH; x++)
+					CHECK(before[y][x] == after[y][x] || (x >= FLAG_X - 1 && x <= FLAG_X + 1), "%u ms: flag %s changed status line pixel %u,%u",
+							elapsed_ms(), is_flag_on ? "on" : "off", x, y);
+			ref.flag_checks += is_flag_on ? 1 : 0;
+		}
+
+		if(!ssd1306_IsBusy() && !ssd1306_IsDirty())
+		{
+			CHECK(sim_oled_matches_framebuffer(&x, &y), "%u ms: glass differs from framebuffer at %u,%u", elapsed_ms(), x, y);
+			ref.settled_frames++;
+		}
+
+		/* nothing done ... sleep to the next deadline, frame or packet */
+		if(false == is_busy)
+		{
+			uint32_t next = packet.time_stamp;
+
+			if(scheduler_get_next_deadline(&wakeup) && (int32_t)(wakeup - next) < 0)
+				next = wakeup;
+			if(display_get_present_time(&wakeup) && (int32_t)(wakeup - next) < 0)
+				next = wakeup;
+			if((int32_t)(next - uwTick) > 0)
+				advance((uint64_t)(next - uwTick) * CYCLES_PER_MS - cycles % CYCLES_PER_MS);
+			else
+				advance(CYCLES_PER_MS / 100); /* polling overhead */
+		}
+	}
+
+	loop_monitor_get_stats(&stats);
+	profile_get_stats(PROFILE_MAIN_LOOP, &pass_profile);
+	for(uint32_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+		histogram += pass_profile.histogram[bin];
+	CHECK(stats.passes == ref.passes && pass_profile.count == ref.passes && histogram == ref.passes,
+			"%u passes, monitor %u, PROFILE_MAIN_LOOP %u (histogram %u)", ref.passes, stats.passes, pass_profile.count, histogram);
+	CHECK(stats.stalls == ref.stalls, "%u stalls, monitor counted %u", ref.stalls, stats.stalls);
+	CHECK(stats.longest.cycles == ref.longest.cycles && stats.longest.stage_cycles == ref.longest.stage_cycles &&
+			stats.longest.stage == ref.longest.stage && stats.longest.time_ms == ref.longest.time_ms,
+			"longest pass %u cycles (%s %u) at %u ms, monitor has %u cycles (%s %u) at %u ms", ref.longest.cycles,
+			loop_monitor_stage_name(ref.longest.stage), ref.longest.stage_cycles, ref.longest.time_ms, stats.longest.cycles,
+			loop_monitor_stage_name(stats.longest.stage), stats.longest.stage_cycles, stats.longest.time_ms);
+	CHECK(stats.longest.task == ref.longest.task, "longest pass ran task %s, monitor says %s",
+			(NULL != ref.longest.task) ? ref.longest.task : "none", (NULL != stats.longest.task) ? stats.longest.task : "none");
+	/* the case the monitor used to get wrong ... display took the time, a task ran before it */
+	CHECK(LOOP_STAGE_DISPLAY == ref.longest.stage && NULL != ref.longest.task, "longest pass %s with task %s, no display stall after a task",
+			loop_monitor_stage_name(ref.longest.stage), (NULL != ref.longest.task) ? ref.longest.task : "none");
+	CHECK(1 == blocker_runs && ref.splash_stalls > 0 && ref.flag_toggles >= 4 && ref.flag_checks > 0 && ref.scrolls > 0,
+			"blocker ran %u times, %u stalls in the splash, flag toggled %u times, on for %u checked passes, %u scrolls", blocker_runs,
+			ref.splash_stalls, ref.flag_toggles, ref.flag_checks, ref.scrolls);
+
+	printf("  %u passes, %u packets, %u stalls (%u during the splash), flag on/off %u times, checked on in %u passes\n",
+			ref.passes, ref.packets, ref.stalls, ref.splash_stalls, ref.flag_toggles, ref.flag_checks);
+	printf("  longest pass %.1f ms at %u ms: %s %.1f ms, task %s\n", (double)stats.longest.cycles / CYCLES_PER_MS,
+			stats.longest.time_ms - START_MS, loop_monitor_stage_name(stats.longest.stage), (double)stats.longest.stage_cycles / CYCLES_PER_MS,
+			stats.longest.task);
+	printf("  %u scroll steps, glass matched the framebuffer on %u settled passes\n", ref.scrolls, ref.settled_frames);
+	printf("test_loop_monitor: OK (stalls counted, longest pass and task, '!' in its own cell)\n");
+	return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * test_profile.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "test.h"
+#include "main.h"
+#include "profile.h"
+#include "console.h"
+#include "ram_monitor.h"
+
+/*
+ * Profiling on the host stand-in (clock_gettime() scaled to SystemCoreClock) ... histogram bin edges against the
+ * profile.h description, PROFILE_BEGIN()/PROFILE_END() around spins of known length (shortest run within a few us
+ * of the spin, nothing shorter), and the console report (key 'p' through the USART2 stub, output captured): every
+ * row's count and min/avg/max us as profile_get_stats() has them, histogram counts adding up, 'P' empties it.
+ * Built twice: test_profile_off with PROFILE_ENABLE 0, where the same regions must record nothing and not read
+ * the cycle source at all (profile_host_cycles() wrapped and counted), and the report says profiling is off.
+ */
+
+#define SPIN_REPEATS		(50u)
+#define SPIN_SLACK_US		(20u)		/* shortest run over the spin ... clock reads and recording */
+
+typedef struct {
+	ProfileRegion region;
+	uint32_t spin_us;
+} Spin;
+
+static const Spin spins[] = {
+	{PROFILE_HEARTBEAT, 5},
+	{PROFILE_READ_ENCODERS, 50},
+	{PROFILE_POLL_BUTTONS, 500},
+	{PROFILE_DISPLAY_FLUSH, 3000},
+};
+#define SPINS				(sizeof(spins) / sizeof(spins[0]))
+
+static uint32_t cycle_reads;
+static char report[8192];
+
+uint32_t __real_profile_host_cycles(void);
+
+uint32_t __wrap_profile_host_cycles(void)
+{
+	cycle_reads++;
+	return __real_profile_host_cycles();
+}
+
+/* console 'u' is not used here ... linker symbols only exist on the target */
+void ram_monitor_get_stats(RamMonitorStats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void spin(uint32_t us)
+{
+	uint64_t end = now_ns() + (uint64_t)us * 1000u;
+
+	while(now_ns() < end)
+		;
+}
+
+/* console key, its output in report[] */
+static void console_key(char key)
+{
+	FILE *capture = tmpfile();
+	int saved = dup(STDOUT_FILENO);
+	size_t length;
+
+	fflush(stdout);
+	dup2(fileno(capture), STDOUT_FILENO);
+	sim_usart2.DR = (uint8_t)key;
+	sim_usart2.SR |= UART_FLAG_RXNE;
+	console_poll();
+	sim_usart2.SR &= ~UART_FLAG_RXNE;
+	fflush(stdout);
+	dup2(saved, STDOUT_FILENO);
+	close(saved);
+	rewind(capture);
+	length = fread(report, 1, sizeof(report) - 1, capture);
+	report[length] = '\0';
+	fclose(capture);
+}
+
+/* bin n >= 1 holds 2^(n + SHIFT) up to twice that, bin 0 everything shorter, last bin open ended */
+static uint32_t expected_bin(uint32_t cycles)
+{
+	for(uint32_t bin = PROFILE_HISTOGRAM_BINS - 1; bin > 0; bin--)
+	{
+		if((uint64_t)cycles >= (1ull << (bin + PROFILE_HISTOGRAM_SHIFT)))
+			return bin;
+	}
+	return 0;
+}
+
+static int test_bins(void)
+{
+	ProfileStats stats;
+	uint32_t edges = 0;
+
+	profile_reset();
+	for(uint32_t bit = 0; bit < 32; bit++)
+	{
+		uint32_t values[3] = {(1u << bit) - 1u, 1u << bit, (1u << bit) | ((1u << bit) - 1u)};
+
+		for(uint8_t i = 0; i < 3; i++)
+		{
+			profile_record(PROFILE_MAIN_LOOP, values[i]);
+			profile_get_stats(PROFILE_MAIN_LOOP, &stats);
+			for(uint32_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+				CHECK(stats.histogram[bin] == ((bin == expected_bin(values[i])) ? 1u : 0u), "%u cycles: bin %u holds %u, expected bin %u",
+						values[i], bin, stats.histogram[bin], expected_bin(values[i]));
+			CHECK(stats.count == 1 && stats.min_cycles == values[i] && stats.max_cycles == values[i] && stats.total_cycles == values[i],
+					"%u cycles recorded as count %u min %u max %u total %llu", values[i], stats.count, stats.min_cycles, stats.max_cycles,
+					(unsigned long long)stats.total_cycles);
+			profile_reset();
+			edges++;
+		}
+	}
+	printf("  histogram bins right at %u values around every power of 2\n", edges);
+	return 0;
+}
+
+static int test_spins(void)
+{
+	uint32_t reads;
+	ProfileStats stats;
+
+	profile_reset();
+	reads = cycle_reads;
+	for(uint32_t repeat = 0; repeat < SPIN_REPEATS; repeat++)
+	{
+		for(uint8_t i = 0; i < SPINS; i++)
+		{
+			switch(spins[i].region) /* PROFILE_BEGIN() takes the region name, not a variable */
+			{
+				case PROFILE_HEARTBEAT:
+				{
+					PROFILE_BEGIN(PROFILE_HEARTBEAT);
+					spin(spins[i].spin_us);
+					PROFILE_END(PROFILE_HEARTBEAT);
+					break;
+				}
+				case PROFILE_READ_ENCODERS:
+				{
+					PROFILE_BEGIN(PROFILE_READ_ENCODERS);
+					spin(spins[i].spin_us);
+					PROFILE_END(PROFILE_READ_ENCODERS);
+					break;
+				}
+				case PROFILE_POLL_BUTTONS:
+				{
+					PROFILE_BEGIN(PROFILE_POLL_BUTTONS);
+					spin(spins[i].spin_us);
+					PROFILE_END(PROFILE_POLL_BUTTONS);
+					break;
+				}
+				default:
+				{
+					PROFILE_BEGIN(PROFILE_DISPLAY_FLUSH);
+					spin(spins[i].spin_us);
+					PROFILE_END(PROFILE_DISPLAY_FLUSH);
+					break;
+				}
+			}
+		}
+	}
+	reads = cycle_reads - reads;
+
+#if PROFILE_ENABLE
+	const uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+
+	CHECK(2 * SPIN_REPEATS * SPINS == reads, "%u cycle source reads for %u regions", reads, SPIN_REPEATS * SPINS);
+	printf("  region       spin    min us    avg us    max us\n");
+	for(uint8_t i = 0; i < SPINS; i++)
+	{
+		uint32_t histogram = 0;
+
+		profile_get_stats(spins[i].region, &stats);
+		for(uint32_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+			histogram += stats.histogram[bin];
+		CHECK(SPIN_REPEATS == stats.count && SPIN_REPEATS == histogram, "%s: %u runs, %u in the histogram", stats.name, stats.count, histogram);
+		CHECK(stats.min_cycles >= (spins[i].spin_us - 1) * cycles_per_us, "%s: %u cycles for a %u us spin", stats.name, stats.min_cycles,
+				spins[i].spin_us);
+		CHECK(stats.min_cycles <= (spins[i].spin_us + SPIN_SLACK_US) * cycles_per_us, "%s: shortest run %u cycles for a %u us spin",
+				stats.name, stats.min_cycles, spins[i].spin_us);
+		CHECK(stats.min_cycles <= stats.total_cycles / stats.count && stats.total_cycles / stats.count <= stats.max_cycles,
+				"%s: min %u avg %llu max %u", stats.name, stats.min_cycles, (unsigned long long)(stats.total_cycles / stats.count), stats.max_cycles);
+		printf("  %-12s %4u %9.1f %9.1f %9.1f\n", stats.name, spins[i].spin_us, (double)stats.min_cycles / cycles_per_us,
+				(double)stats.total_cycles / stats.count / cycles_per_us, (double)stats.max_cycles / cycles_per_us);
+	}
+#else
+	CHECK(0 == reads, "%u cycle source reads with PROFILE_ENABLE 0", reads);
+	for(uint8_t i = 0; i < SPINS; i++)
+	{
+		profile_get_stats(spins[i].region, &stats);
+		CHECK(0 == stats.count, "%s: %u runs recorded with PROFILE_ENABLE 0", stats.name, stats.count);
+	}
+#endif
+	return 0;
+}
+
+/* 'p' report row by row against profile_get_stats() ... then 'P' */
+static int test_report(void)
+{
+	const uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+	ProfileStats stats;
+	uint32_t rows = 0;
+
+	console_key('p');
+	CHECK(NULL != strstr(report, "Region            count    min us    avg us    max us"), "no table header in:\n%s", report);
+	for(uint8_t region = 0; region < PROFILE_REGION_COUNT; region++)
+	{
+		char *row = report;
+		unsigned long count, min_us, avg_us, max_us;
+
+		profile_get_stats(region, &stats);
+		while(NULL != (row = strstr(row, stats.name)) && (row != report && '\n' != row[-1]))
+			row++;
+		CHECK(NULL != row, "no row for %s in:\n%s", stats.name, report);
+		CHECK(4 == sscanf(row + strlen(stats.name), "%lu %lu %lu %lu", &count, &min_us, &avg_us, &max_us), "%s row unreadable", stats.name);
+		CHECK(count == stats.count && min_us == stats.min_cycles / cycles_per_us && max_us == stats.max_cycles / cycles_per_us &&
+				avg_us == ((0 == stats.count) ? 0 : (uint32_t)(stats.total_cycles / stats.count) / cycles_per_us),
+				"%s row %lu %lu %lu %lu, stats count %u min %u max %u cycles", stats.name, count, min_us, avg_us, max_us, stats.count,
+				stats.min_cycles, stats.max_cycles);
+		if(0 != stats.count)
+		{
+			char *line = strstr(row, "log2 cycles:");
+			unsigned long histogram = 0, bin_count;
+			int used;
+
+			CHECK(NULL != line && line < strchr(strchr(row, '\n') + 1, '\n'), "%s: no histogram line", stats.name);
+			for(line += strlen("log2 cycles:"); '\r' != *line; line += used)
+			{
+				CHECK(1 == sscanf(line, " %*[<0-9]:%lu%n", &bin_count, &used), "%s: histogram line unreadable at '%.10s'", stats.name, line);
+				histogram += bin_count;
+			}
+			CHECK(histogram == stats.count, "%s: histogram line adds up to %lu, %u runs", stats.name, histogram, stats.count);
+		}
+		rows++;
+	}
+#if PROFILE_ENABLE
+	CHECK(NULL == strstr(report, "Profiling disabled"), "report says profiling is off");
+#else
+	CHECK(NULL != strstr(report, "Profiling disabled"), "report doesn't say profiling is off");
+#endif
+
+	console_key('P');
+	CHECK(NULL != strstr(report, "Profiled regions reset"), "no reset reply:\n%s", report);
+	console_key('p');
+	CHECK(NULL == strstr(report, "log2 cycles:"), "histogram left after reset:\n%s", report);
+	for(uint8_t region = 0; region < PROFILE_REGION_COUNT; region++)
+	{
+		profile_get_stats(region, &stats);
+		CHECK(0 == stats.count && 0 == stats.max_cycles && 0 == stats.total_cycles, "%s: count %u after reset", stats.name, stats.count);
+	}
+	printf("  console report: %u rows match profile_get_stats(), empty after 'P'\n", rows);
+	return 0;
+}
+
+int main(void)
+{
+	if(test_bins() != 0 || test_spins() != 0 || test_report() != 0)
+		return 1;
+#if PROFILE_ENABLE
+	printf("test_profile: OK (host cycle source, bins, report)\n");
+#else
+	printf("test_profile_off: OK (PROFILE_ENABLE 0 ... regions record nothing, no cycle reads)\n");
+#endif
+	return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * test_replay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "main.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "filter_channels.h"
+#include "app_state_machine.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Display emulator driven by replay files (replay/<name>.txt) ... MIDI bytes go through midi_build_packet() and
+ * ui_process_midi_packet() as main.c hands them over, a main loop pass every millisecond runs the scheduler and
+ * display_present(), the simulated controller decodes the bus into the glass image. Each `screen` line compares
+ * the glass with replay/<name>_<screen>.pbm (PBM P1, 1 = lit, same as console `d`). Per frame bus bytes and
+ * modelled transfer time at 100/400 kHz (9 bit times per byte) are reported for every replay.
+ *
+ * Replay lines (time in ms since capture start, non-decreasing, # starts a comment):
+ *   <ms> <hex byte> ...    MIDI bytes received at that time
+ *   <ms> scroll <detents>  scroll wheel (negative = back into history)
+ *   <ms> channel <n>       channel filter (0 = all)
+ *   <ms> live              scroll button short press, back to LIVE
+ *   <ms> screen <name>     let pending changes out, compare glass with golden image
+ *
+ * UPDATE_GOLDEN=1 in the environment writes the golden images instead of comparing (check them by eye before
+ * committing). A mismatch leaves the glass image in build/ next to the test.
+ */
+
+#define REPLAY_DIR		"../replay/"		/* tests run from test/build */
+#define SETTLE_MS		(1000u)				/* longest wait for a screen to settle (scroll fill timer included) */
+
+static const char *replays[] = {"live_chords", "scroll_filter"};
+
+typedef struct {
+	uint32_t frames;
+	uint32_t bytes;
+	uint32_t max_bytes;
+	uint32_t packets;
+	uint32_t screens;
+} ReplayStats;
+
+static ReplayStats stats;
+static uint32_t seen_frames;
+
+static void drain(void)
+{
+	while(ssd1306_IsBusy())
+		display_service();
+}
+
+/* one main loop pass ... a started frame goes out at once (bus time is modelled, not simulated) */
+static void pass(void)
+{
+	SimOledStats bus;
+
+	scheduler_dispatch(TASK_PRIORITY_LOW);
+	display_present();
+	drain();
+	if(display_get_flush_count() != seen_frames)
+	{
+		seen_frames = display_get_flush_count();
+		sim_oled_get_stats(&bus);
+		sim_oled_reset_stats();
+		stats.frames++;
+		stats.bytes += bus.bytes;
+		if(bus.bytes > stats.max_bytes)
+			stats.max_bytes = bus.bytes;
+	}
+}
+
+static bool is_fill_pending(void)
+{
+	uint32_t started, completed, cancelled;
+
+	ui_get_fill_stats(&started, &completed, &cancelled);
+	return started != completed + cancelled;
+}
+
+static void run_until(uint32_t ms)
+{
+	while(uwTick < ms)
+	{
+		uwTick++;
+		pass();
+	}
+}
+
+static int screen(const char *replay, const char *name, uint32_t line)
+{
+	char path[128];
+	bool is_update = (getenv("UPDATE_GOLDEN") != NULL);
+	FILE *file;
+	uint8_t x, y;
+
+	for(uint32_t i = 0; i < SETTLE_MS && (ssd1306_IsDirty() || is_fill_pending()); i++)
+	{
+		uwTick++;
+		pass();
+	}
+	CHECK(!ssd1306_IsDirty() && sim_oled_matches_framebuffer(&x, &y), "%s:%u: screen %s did not settle", replay, line, name);
+
+	snprintf(path, sizeof(path), REPLAY_DIR "%s_%s.pbm", replay, name);
+	if(is_update)
+	{
+		file = fopen(path, "w");
+		CHECK(file != NULL, "%s:%u: cannot write %s", replay, line, path);
+		sim_oled_write_pbm(file);
+		fclose(file);
+	}
+	else
+	{
+		bool is_match;
+
+		file = fopen(path, "r");
+		CHECK(file != NULL, "%s:%u: no golden image %s (UPDATE_GOLDEN=1 writes it)", replay, line, path);
+		is_match = sim_oled_matches_pbm(file, &x, &y);
+		fclose(file);
+		if(!is_match)
+		{
+			snprintf(path, sizeof(path), "%s_%s.pbm", replay, name);
+			file = fopen(path, "w");
+			if(file != NULL)
+			{
+				sim_oled_write_pbm(file);
+				fclose(file);
+			}
+		}
+		CHECK(is_match, "%s:%u: screen %s differs from golden image at %u,%u (glass in build/%s)", replay, line, name, x, y, path);
+	}
+	stats.screens++;
+	return 0;
+}
+
+static int replay(const char *name)
+{
+	char path[128], text[256];
+	uint32_t line = 0;
+	FILE *file;
+	SSD1306_Stats_t driver;
+
+	snprintf(path, sizeof(path), REPLAY_DIR "%s.txt", name);
+	file = fopen(path, "r");
+	CHECK(file != NULL, "cannot open %s", path);
+
+	/* power-up as main.c ... capture starts at 0 ms, LIVE */
+	uwTick = 0;
+	memset(&stats, 0, sizeof(stats));
+	filter_setChannel(0);
+	ui_initialize_ui();
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	display_setMode(LIVE);
+	display_start_screen();
+	display_present_now();
+	drain();
+	seen_frames = display_get_flush_count();
+	sim_oled_reset_stats();
+	ssd1306_ResetStats();
+
+	while(fgets(text, sizeof(text), file) != NULL)
+	{
+		char *token, *rest;
+		uint32_t ms;
+
+		line++;
+		if((token = strchr(text, '#')) != NULL)
+			*token = '\0';
+		token = strtok_r(text, " \t\r\n", &rest);
+		if(NULL == token)
+			continue;
+		ms = strtoul(token, NULL, 10);
+		run_until(ms);
+
+		token = strtok_r(NULL, " \t\r\n", &rest);
+		CHECK(token != NULL, "%s:%u: nothing after time", name, line);
+		if(0 == strcmp(token, "scroll"))
+		{
+			token = strtok_r(NULL, " \t\r\n", &rest);
+			ui_scroll_history((int16_t)strtol(token, NULL, 10));
+		}
+		else if(0 == strcmp(token, "channel"))
+		{
+			token = strtok_r(NULL, " \t\r\n", &rest);
+			display_channel(filter_setChannel((uint8_t)strtoul(token, NULL, 10)));
+		}
+		else if(0 == strcmp(token, "live"))
+		{
+			app_set_state(APP_STATE_MIDI_DISPLAY);
+			display_setMode(LIVE);
+			ui_restore_display();
+		}
+		else if(0 == strcmp(token, "screen"))
+		{
+			token = strtok_r(NULL, " \t\r\n", &rest);
+			if(screen(name, token, line) != 0)
+			{
+				fclose(file);
+				return 1;
+			}
+		}
+		else
+		{
+			for(; token != NULL; token = strtok_r(NULL, " \t\r\n", &rest))
+			{
+				stc_midi *packet = midi_build_packet((uint8_t)strtoul(token, NULL, 16), uwTick);
+
+				if(midi_isPacketAvailable())
+				{
+					ui_process_midi_packet(packet);
+					stats.packets++;
+				}
+			}
+			pass();
+		}
+	}
+	fclose(file);
+
+	ssd1306_GetStats(&driver);
+	CHECK(stats.frames > 0 && stats.screens > 0, "%s: no frames or screens", name);
+	CHECK(driver.Frames == stats.frames && driver.Bytes == stats.bytes, "%s: driver counted %lu frames %lu bytes, bus %u frames %u bytes",
+			name, (unsigned long)driver.Frames, (unsigned long)driver.Bytes, stats.frames, stats.bytes);
+
+	/* 9 bit times per byte ... us = bytes * 9 * 1e6 / bus_hz */
+	printf("  %-14s %4u packets, %2u screens, %4u frames, bytes/frame %4u avg %4u max, ms/frame at 100 kHz %5.1f avg %5.1f max, at 400 kHz %4.1f avg %4.1f max\n",
+			name, stats.packets, stats.screens, stats.frames, stats.bytes / stats.frames, stats.max_bytes,
+			stats.bytes * 0.09 / stats.frames, stats.max_bytes * 0.09, stats.bytes * 0.0225 / stats.frames, stats.max_bytes * 0.0225);
+	return 0;
+}
+
+int main(void)
+{
+	sim_oled_attach();
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+
+	for(uint8_t i = 0; i < sizeof(replays) / sizeof(replays[0]); i++)
+	{
+		if(replay(replays[i]) != 0)
+			return 1;
+	}
+	printf("test_replay: OK\n");
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * test_scheduler.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "main.h"
+#include "scheduler.h"
+
+/*
+ * Scheduler on a virtual clock (uwTick, timebase_init() is not called so timebase_get_ms() reads it) ... periodic
+ * tasks of several intervals, time crossing 2^32 ms. Every run checks the schedule has not drifted: the deadlines
+ * released so far (runs before it, this one, and the ones counted missed) must be exactly the interval grid from
+ * the task's start up to now. Three main loops:
+ *   on time   SysTick every ms, main loop dispatches right after ... every run on its deadline, nothing missed
+ *   stalled   main loop held up for random stretches (blocking I2C, printf) while SysTick goes on ... runs are late
+ *             but the grid stays put, no deadline is lost (run or counted missed), none missed by tasks whose
+ *             interval is longer than the longest stall
+ *   tickless  time jumps straight to scheduler_get_next_deadline() and scheduler_advance() catches up in one call
+ *             ... every run on its deadline, nothing missed
+ */
+
+#define TEST_MS			(1000000u)
+#define START_MS		(0xFFFFFFFFu - TEST_MS / 3)	/* crosses 2^32 a third of the way in */
+#define MAX_STALL_MS	(40u)
+#define TASKS			(6u)
+
+static const uint32_t intervals[TASKS] = {1, 7, 33, 100, 1000, 4999};
+
+static TaskId ids[TASKS];
+static uint32_t started_ms;		/* tasks added at this time, first deadline one interval later */
+static uint32_t late_ms[TASKS];	/* latest run after its deadline */
+static bool has_failed;
+
+static void task_run(uint8_t n)
+{
+	TaskStats stats;
+	uint32_t released;
+
+	scheduler_get_task_stats(ids[n], &stats);
+	released = stats.runs + 1 + stats.missed; /* runs is counted after the callback returns */
+	if(released != (uwTick - started_ms) / intervals[n])
+	{
+		if(!has_failed)
+			printf("FAIL %s: task %u (%u ms) at %u ms: %u deadlines released, %u on the grid\n", __FILE__, n, intervals[n],
+					uwTick - started_ms, released, (uwTick - started_ms) / intervals[n]);
+		has_failed = true;
+	}
+	if((uwTick - started_ms) % intervals[n] > late_ms[n])
+		late_ms[n] = (uwTick - started_ms) % intervals[n];
+}
+
+#define TASK_CALLBACK(n) static void task##n(void) { task_run(n); }
+TASK_CALLBACK(0)
+TASK_CALLBACK(1)
+TASK_CALLBACK(2)
+TASK_CALLBACK(3)
+TASK_CALLBACK(4)
+TASK_CALLBACK(5)
+
+static const TaskCallback callbacks[TASKS] = {task0, task1, task2, task3, task4, task5};
+
+static void start(void)
+{
+	uwTick = START_MS;
+	scheduler_init();
+	started_ms = uwTick;
+	has_failed = false;
+	for(uint8_t n = 0; n < TASKS; n++)
+	{
+		ids[n] = scheduler_add_task("test", callbacks[n], intervals[n], TASK_PRIORITY_NORMAL, 0);
+		late_ms[n] = 0;
+	}
+}
+
+static void dispatch_all(void)
+{
+	while(scheduler_dispatch(TASK_PRIORITY_LOW))
+		;
+}
+
+/* every deadline up to now run or counted missed ... total per task */
+static int check_totals(const char *loop, bool may_miss)
+{
+	uint32_t elapsed = uwTick - started_ms;
+
+	CHECK(!has_failed, "%s: schedule drifted", loop);
+	for(uint8_t n = 0; n < TASKS; n++)
+	{
+		TaskStats stats;
+
+		scheduler_get_task_stats(ids[n], &stats);
+		CHECK(stats.runs + stats.missed == elapsed / intervals[n], "%s: task %u (%u ms) %u runs %u missed, %u deadlines",
+				loop, n, intervals[n], stats.runs, stats.missed, elapsed / intervals[n]);
+		CHECK(may_miss ? (intervals[n] > MAX_STALL_MS ? 0 == stats.missed : true) : 0 == stats.missed,
+				"%s: task %u (%u ms) missed %u deadlines", loop, n, intervals[n], stats.missed);
+	}
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t stalls = 0, deadline;
+
+	/* on time ... SysTick, then main loop */
+	start();
+	for(uint32_t ms = 0; ms < TEST_MS; ms++)
+	{
+		uwTick++;
+		scheduler_tick();
+		dispatch_all();
+	}
+	if(check_totals("on time", false) != 0)
+		return 1;
+	for(uint8_t n = 0; n < TASKS; n++)
+		CHECK(0 == late_ms[n], "on time: task %u ran %u ms late", n, late_ms[n]);
+
+	/* stalled main loop ... ticks keep coming, tasks run when the loop gets back */
+	start();
+	for(uint32_t ms = 0; ms < TEST_MS; ms++)
+	{
+		uwTick++;
+		scheduler_tick();
+		if(0 == test_random() % 50)
+		{
+			for(uint32_t stall = test_random() % (MAX_STALL_MS + 1); stall != 0 && ms < TEST_MS; stall--, ms++)
+			{
+				uwTick++;
+				scheduler_tick();
+			}
+			stalls++;
+		}
+		dispatch_all();
+	}
+	if(check_totals("stalled", true) != 0)
+		return 1;
+	printf("  stalled    %u stalls up to %u ms, latest run past its deadline per task:", stalls, MAX_STALL_MS);
+	for(uint8_t n = 0; n < TASKS; n++)
+		printf(" %u ms", late_ms[n]);
+	printf("\n");
+
+	/* tickless ... no tick, time jumps to the next deadline */
+	start();
+	while(scheduler_get_next_deadline(&deadline) && (int32_t)(deadline - (started_ms + TEST_MS)) <= 0)
+	{
+		uwTick = deadline;
+		scheduler_advance(uwTick);
+		dispatch_all();
+	}
+	uwTick = started_ms + TEST_MS;
+	scheduler_advance(uwTick);
+	dispatch_all();
+	if(check_totals("tickless", false) != 0)
+		return 1;
+	for(uint8_t n = 0; n < TASKS; n++)
+		CHECK(0 == late_ms[n], "tickless: task %u ran %u ms late", n, late_ms[n]);
+
+	printf("test_scheduler: OK (%u ms x 3 main loops, %u tasks, 2^32 ms wrap, no drift)\n", TEST_MS, TASKS);
+	return 0;
+}
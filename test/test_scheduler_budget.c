@@ -0,0 +1,340 @@
+/*
+ * test_scheduler_budget.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "main.h"
+#include "scheduler.h"
+
+/*
+ * Priorities, one-shot timers, execution budgets and the MIDI backlog policy with simulated task costs ... a task
+ * "runs" by moving a simulated microsecond clock on, which moves the DWT cycle counter (72 per us), the ms tick
+ * (scheduler_tick() as SysTick would, also while a task runs) and MIDI byte arrivals into fifo_count.
+ *
+ *   order     tasks released together run highest priority first, earliest deadline first within a priority
+ *   one-shot  a timer runs once at its delay, a restart moves it, a stop drops a pending run, 0 = next ms
+ *   budget    a run over budget by 1 us is an overrun, one on budget is not, last and longest time per task
+ *   backlog   main loop as main.c (one FIFO byte, packet parsing, one task per pass, only high priority tasks
+ *             while fifo_count is above UART_FIFO_BACKLOG_THRESHOLD) through MIDI floods with heavy UI tasks,
+ *             against the same loop without the policy ... with it no normal or low priority task starts above
+ *             the threshold, the high priority task misses nothing, the FIFO peak is lower and nothing overflows
+ */
+
+#define CYCLES_PER_US		(72u)
+#define MIDI_BYTE_US		(320u)		/* 31250 baud, back to back */
+#define BYTE_US				(15u)		/* main loop pass taking one byte from the FIFO */
+#define PACKET_US			(700u)		/* parsing and drawing one packet in LIVE */
+#define FLOOD_MS			(2000u)		/* MIDI flood, then as long quiet */
+#define BACKLOG_TEST_MS		(60000u)
+
+static uint64_t now_us;
+static uint64_t next_byte_us;
+static uint32_t fifo_peak, fifo_overflows;
+
+/* simulated time passes ... ticks, cycle counter and MIDI bytes (interrupts) keep going */
+static void advance(uint32_t us)
+{
+	uint64_t end = now_us + us;
+
+	while(next_byte_us <= end)
+	{
+		if((next_byte_us / 1000 / FLOOD_MS) % 2 == 0) /* flood half of the time */
+		{
+			if(fifo_count < UART_FIFO_SIZE)
+				fifo_count++;
+			else
+				fifo_overflows++;
+			if(fifo_count > fifo_peak)
+				fifo_peak = fifo_count;
+		}
+		next_byte_us += MIDI_BYTE_US;
+	}
+	while(uwTick != (uint32_t)(end / 1000))
+	{
+		uwTick++;
+		scheduler_tick();
+	}
+	sim_dwt.CYCCNT += us * CYCLES_PER_US;
+	now_us = end;
+}
+
+/* ---- order ---- */
+
+static char order[8];
+static uint8_t order_length;
+
+#define ORDER_CALLBACK(c) static void order_##c(void) { order[order_length++] = #c[0]; }
+ORDER_CALLBACK(a)
+ORDER_CALLBACK(b)
+ORDER_CALLBACK(c)
+ORDER_CALLBACK(d)
+ORDER_CALLBACK(e)
+
+static int test_order(void)
+{
+	uwTick = 1000;
+	scheduler_init();
+	/* released in the same ms, b's and d's deadlines passed earlier (they waited) */
+	scheduler_add_task("a", order_a, 10, TASK_PRIORITY_LOW, 0);
+	scheduler_add_task("b", order_b, 4, TASK_PRIORITY_NORMAL, 0);
+	scheduler_add_task("c", order_c, 10, TASK_PRIORITY_NORMAL, 0);
+	scheduler_add_task("d", order_d, 8, TASK_PRIORITY_HIGH, 0);
+	scheduler_add_task("e", order_e, 10, TASK_PRIORITY_HIGH, 0);
+	uwTick = 1010;
+	scheduler_advance(uwTick);
+
+	order_length = 0;
+	CHECK(!scheduler_dispatch(TASK_PRIORITY_HIGH) || order_length == 1, "more than one task per dispatch");
+	while(scheduler_dispatch(TASK_PRIORITY_HIGH))
+		;
+	CHECK(order_length == 2 && order[0] == 'd' && order[1] == 'e', "high priority only: ran %.*s", order_length, order);
+	while(scheduler_dispatch(TASK_PRIORITY_LOW))
+		;
+	CHECK(order_length == 5 && order[2] == 'b' && order[3] == 'c' && order[4] == 'a', "ran %.*s, expected debca",
+			order_length, order);
+	return 0;
+}
+
+/* ---- one-shot ---- */
+
+static uint32_t shot_runs, shot_ms;
+
+static void shot(void)
+{
+	shot_runs++;
+	shot_ms = uwTick;
+}
+
+static void run_ms(uint32_t ms)
+{
+	while(ms-- != 0)
+	{
+		uwTick++;
+		scheduler_tick();
+		while(scheduler_dispatch(TASK_PRIORITY_LOW))
+			;
+	}
+}
+
+static int test_one_shot(void)
+{
+	TaskId id;
+
+	uwTick = 5000;
+	scheduler_init();
+	id = scheduler_add_timer("shot", shot, TASK_PRIORITY_LOW, 0);
+	shot_runs = 0;
+	run_ms(100);
+	CHECK(0 == shot_runs, "timer ran before it was started");
+
+	scheduler_start_timer(id, 5);
+	run_ms(20);
+	CHECK(1 == shot_runs && 5105 == shot_ms, "started at 5100 for 5 ms: %u runs, last at %u", shot_runs, shot_ms);
+
+	scheduler_start_timer(id, 10); /* restart before it runs ... moves it */
+	run_ms(4);
+	scheduler_start_timer(id, 10);
+	run_ms(20);
+	CHECK(2 == shot_runs && 5134 == shot_ms, "restarted at 5124: %u runs, last at %u", shot_runs, shot_ms);
+
+	scheduler_start_timer(id, 3); /* released but not dispatched yet, then stopped ... dropped */
+	uwTick += 3;
+	scheduler_tick();
+	scheduler_stop_timer(id);
+	run_ms(20);
+	CHECK(2 == shot_runs, "stopped timer ran");
+
+	scheduler_start_timer(id, 0);
+	run_ms(1);
+	CHECK(3 == shot_runs && shot_ms == uwTick, "0 ms delay: %u runs, last at %u (now %u)", shot_runs, shot_ms, uwTick);
+	CHECK(SCHEDULER_NO_DEADLINE == scheduler_get_time_to_next(), "one-shot still armed after running");
+	return 0;
+}
+
+/* ---- budget ---- */
+
+static const uint32_t budget_costs[] = {100, 101, 99, 250, 0, 100};	/* us, budget 100 */
+static uint8_t budget_run;
+
+static void costly(void)
+{
+	sim_dwt.CYCCNT += budget_costs[budget_run++] * CYCLES_PER_US;
+}
+
+static int test_budget(void)
+{
+	TaskStats stats;
+	TaskId id;
+
+	uwTick = 0;
+	scheduler_init();
+	id = scheduler_add_task("costly", costly, 1, TASK_PRIORITY_NORMAL, 100);
+	budget_run = 0;
+	while(budget_run < sizeof(budget_costs) / sizeof(budget_costs[0]))
+		run_ms(1);
+	scheduler_get_task_stats(id, &stats);
+	CHECK(6 == stats.runs && 2 == stats.overruns && 250 == stats.max_us && 100 == stats.last_us && 100 == stats.budget_us,
+			"%u runs, %u overruns, max %u us, last %u us, budget %u us", stats.runs, stats.overruns, stats.max_us, stats.last_us,
+			stats.budget_us);
+	return 0;
+}
+
+/* ---- backlog ---- */
+
+typedef struct {
+	const char *name;
+	TaskPriority priority;
+	uint32_t interval_ms;		/* 0 = one-shot */
+	uint32_t budget_us;
+	uint32_t min_us, max_us;	/* simulated cost, random in between */
+	TaskId id;
+	uint32_t runs;
+	uint32_t overruns;			/* runs costing more than the budget */
+	uint32_t max_cost_us;
+	uint32_t started_in_backlog;
+} SimTask;
+
+#define FILL_LINES		(5u)
+
+/* about the application's task set, with the costs of blocking drawing */
+static SimTask tasks[] = {
+	{"heartbeat", TASK_PRIORITY_HIGH, 500, 500, 10, 30},
+	{"encoders", TASK_PRIORITY_NORMAL, 21, 5000, 50, 12000},	/* sometimes a whole scroll screen */
+	{"buttons", TASK_PRIORITY_NORMAL, 13, 5000, 20, 80},
+	{"overlay", TASK_PRIORITY_LOW, 250, 5000, 3000, 9000},
+	{"fill", TASK_PRIORITY_LOW, 0, 5000, 2000, 6000},			/* one line per run, re-armed, restarted by encoders */
+};
+
+#define TASK_COUNT		(sizeof(tasks) / sizeof(tasks[0]))
+#define FILL			(4u)
+
+static uint32_t fill_left;
+
+static void sim_run(uint8_t n)
+{
+	SimTask *task = &tasks[n];
+	uint32_t cost = task->min_us + test_random() % (task->max_us - task->min_us + 1);
+
+	if(fifo_count > UART_FIFO_BACKLOG_THRESHOLD && TASK_PRIORITY_HIGH != task->priority)
+		task->started_in_backlog++;
+	task->runs++;
+	if(cost > task->budget_us)
+		task->overruns++;
+	if(cost > task->max_cost_us)
+		task->max_cost_us = cost;
+	advance(cost);
+
+	if(1 == n && 0 == task->runs % 30) /* scroll jump ... fill restarts */
+	{
+		fill_left = FILL_LINES;
+		scheduler_start_timer(tasks[FILL].id, 1);
+	}
+	if(FILL == n && --fill_left != 0)
+		scheduler_start_timer(task->id, 1);
+}
+
+#define SIM_CALLBACK(n) static void sim_##n(void) { sim_run(n); }
+SIM_CALLBACK(0)
+SIM_CALLBACK(1)
+SIM_CALLBACK(2)
+SIM_CALLBACK(3)
+SIM_CALLBACK(4)
+
+static const TaskCallback sim_callbacks[TASK_COUNT] = {sim_0, sim_1, sim_2, sim_3, sim_4};
+
+static int test_backlog(bool with_policy, uint32_t *peak)
+{
+	uint32_t bytes = 0;
+
+	uwTick = 0;
+	now_us = 0;
+	next_byte_us = MIDI_BYTE_US;
+	fifo_count = 0;
+	fifo_peak = fifo_overflows = 0;
+	fill_left = 0;
+	scheduler_init();
+	for(uint8_t n = 0; n < TASK_COUNT; n++)
+	{
+		SimTask *task = &tasks[n];
+
+		task->runs = task->overruns = task->max_cost_us = task->started_in_backlog = 0;
+		if(0 != task->interval_ms)
+			task->id = scheduler_add_task(task->name, sim_callbacks[n], task->interval_ms, task->priority, task->budget_us);
+		else
+			task->id = scheduler_add_timer(task->name, sim_callbacks[n], task->priority, task->budget_us);
+	}
+
+	while(now_us < (uint64_t)BACKLOG_TEST_MS * 1000)
+	{
+		bool is_busy = false;
+		bool is_backlogged;
+
+		if(0 != fifo_count) /* one byte, every third completes a packet */
+		{
+			fifo_count--;
+			advance(BYTE_US);
+			if(0 == ++bytes % 3)
+				advance(PACKET_US);
+			is_busy = true;
+		}
+		is_backlogged = (fifo_count > UART_FIFO_BACKLOG_THRESHOLD);
+		if(scheduler_dispatch((with_policy && is_backlogged) ? TASK_PRIORITY_HIGH : TASK_PRIORITY_LOW))
+			is_busy = true;
+		if(!is_busy)
+			advance(5);
+	}
+
+	for(uint8_t n = 0; n < TASK_COUNT; n++)
+	{
+		SimTask *task = &tasks[n];
+		TaskStats stats;
+
+		scheduler_get_task_stats(task->id, &stats);
+		CHECK(stats.runs == task->runs && stats.overruns == task->overruns && stats.max_us == task->max_cost_us,
+				"%s: scheduler counted %u runs %u overruns max %u us, simulated %u runs %u overruns max %u us", task->name,
+				stats.runs, stats.overruns, stats.max_us, task->runs, task->overruns, task->max_cost_us);
+		CHECK(stats.budget_us == task->budget_us, "%s: budget %u us, set %u us", task->name, stats.budget_us, task->budget_us);
+		CHECK(task->runs > 0, "%s: never ran", task->name);
+		if(with_policy)
+			CHECK(0 == task->started_in_backlog, "%s: started %u times with the FIFO above the threshold", task->name,
+					task->started_in_backlog);
+		if(with_policy && TASK_PRIORITY_HIGH == task->priority)
+			CHECK(0 == stats.missed, "%s: missed %u deadlines", task->name, stats.missed);
+	}
+	if(with_policy)
+		CHECK(0 == fifo_overflows, "%u bytes lost, FIFO peak %u", fifo_overflows, fifo_peak);
+
+	printf("  %-14s FIFO peak %4u of %u (threshold %u), %u lost, missed deadlines", with_policy ? "backlog policy" : "no policy",
+			fifo_peak, UART_FIFO_SIZE, UART_FIFO_BACKLOG_THRESHOLD, fifo_overflows);
+	for(uint8_t n = 0; n < TASK_COUNT; n++)
+	{
+		TaskStats stats;
+
+		scheduler_get_task_stats(tasks[n].id, &stats);
+		printf(" %s %u", tasks[n].name, stats.missed);
+	}
+	printf("\n");
+	*peak = fifo_peak;
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t peak_without, peak_with;
+
+	if(test_order() != 0 || test_one_shot() != 0 || test_budget() != 0)
+		return 1;
+	if(test_backlog(false, &peak_without) != 0 || test_backlog(true, &peak_with) != 0)
+		return 1;
+	CHECK(peak_with < peak_without, "FIFO peak %u with the backlog policy, %u without", peak_with, peak_without);
+
+	printf("  overruns    ");
+	for(uint8_t n = 0; n < TASK_COUNT; n++)
+		printf(" %s %u/%u", tasks[n].name, tasks[n].overruns, tasks[n].runs);
+	printf("\n");
+	printf("test_scheduler_budget: OK\n");
+	return 0;
+}
@@ -0,0 +1,349 @@
+/*
+ * test_scroll_fill.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include "test.h"
+#include "main.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "history.h"
+#include "session.h"
+#include "app_state_machine.h"
+#include "midi_stream.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Incremental scroll screen fill after a jump ... jumps back in time from LIVE or from the scroll screen, then main
+ * loop passes (tick, sometimes a packet, one task, frame) until the fill finishes, or it is cut short after a few
+ * passes by a detent, a return to LIVE or another jump. Framebuffer lines are compared before and after every task
+ * run. Checks: a fill run paints at most one line, lines come top to bottom, each painted line shows its record (or
+ * "End of history"), nothing but the fill task touches the text, a fill completes in the run that leaves the whole
+ * screen right and not before, nothing is painted by a fill after it was cut short, and the started/completed/
+ * cancelled counts match what happened here. The glass must match the framebuffer after every frame.
+ */
+
+#define TEST_ACTIONS		(5000u)
+#define SESSION_PACKETS		(600u)
+#define TEXT_LINES			(6u)		/* scroll screen lines 1..6, line 1 the record-of-interest */
+#define LINE_PIXELS			(120u)		/* 20 character columns, scroll bar right of them */
+#define MAX_FILL_PASSES		(40u)
+#define EVICT_MARGIN		(16u)		/* records between the screen and the oldest one */
+
+typedef struct {
+	uint32_t jumps;
+	uint32_t completed;
+	uint32_t cancelled;
+	uint32_t detent_cuts;
+	uint32_t live_cuts;
+	uint32_t jump_cuts;
+	uint32_t fill_lines;			/* painted by fill runs */
+	uint32_t fill_runs;
+	uint32_t packets_between;		/* packets handled in passes between two lines of one fill */
+	uint32_t max_passes;			/* jump to completed fill */
+} Stats;
+
+static Stats stats;
+static bool is_fill_pending;		/* as seen here ... started, not yet completed or cut short */
+static bool is_screen_done;			/* whole screen right ... the next fill run must complete */
+static uint8_t last_fill_line;		/* lowest line a fill may paint next, top to bottom */
+static stc_midi packet;
+
+/* ui_time_jump_step() reports every jump on the console ... kept out of the test output */
+int __wrap_printf(const char *format, ...)
+{
+	va_list args;
+	int length;
+
+	if(0 == strncmp(format, "Jump to ", 8))
+		return 0;
+	va_start(args, format);
+	length = vprintf(format, args);
+	va_end(args);
+	return length;
+}
+
+static void drain(void)
+{
+	while(ssd1306_IsBusy())
+		display_service();
+}
+
+static bool glyph_pixel(const char *str, uint8_t x, uint8_t row)
+{
+	uint8_t index = x / DISPLAY_DEFAULT_FONT.width;
+
+	if(index >= strlen(str))
+		return false;
+	return (DISPLAY_DEFAULT_FONT.data[(str[index] - 32) * DISPLAY_DEFAULT_FONT.height + row] << (x % DISPLAY_DEFAULT_FONT.width)) & 0x8000;
+}
+
+/* scroll screen line (1 = record-of-interest) as a full repaint has it ... record, "End of history" or blank */
+static const char* expected_line(uint8_t line)
+{
+	stc_midi_history record;
+	uint32_t sequence = ui_get_scroll_sequence();
+
+	for(uint8_t i = 1; i < line; i++)
+	{
+		if(sequence == history_oldest())
+			return (i + 1 == line) ? "End of history" : "";
+		sequence--;
+	}
+	if(!history_read(sequence, &record))
+		return "";
+	return midi_process_message(record.running_status, record.data[0], record.data[1]);
+}
+
+static void snapshot(bool lines[][8][LINE_PIXELS])
+{
+	for(uint8_t line = 1; line <= TEXT_LINES; line++)
+		for(uint8_t row = 0; row < 8; row++)
+			for(uint8_t x = 0; x < LINE_PIXELS; x++)
+				lines[line - 1][row][x] = (White == ssd1306_GetPixel(x, line * (DISPLAY_DEFAULT_FONT.height + 1) + row));
+}
+
+static bool is_line_right(bool lines[][8][LINE_PIXELS], uint8_t line)
+{
+	const char *str = expected_line(line);
+
+	for(uint8_t row = 0; row < 8; row++)
+		for(uint8_t x = 0; x < LINE_PIXELS; x++)
+			if(lines[line - 1][row][x] != glyph_pixel(str, x, row))
+				return false;
+	return true;
+}
+
+static bool is_line_blank(bool lines[][8][LINE_PIXELS], uint8_t line)
+{
+	for(uint8_t row = 0; row < 8; row++)
+		for(uint8_t x = 0; x < LINE_PIXELS; x++)
+			if(lines[line - 1][row][x])
+				return false;
+	return true;
+}
+
+static void fill_counts(uint32_t *started, uint32_t *completed, uint32_t *cancelled)
+{
+	ui_get_fill_stats(started, completed, cancelled);
+}
+
+static int check_counts(const char *when)
+{
+	uint32_t started, completed, cancelled;
+
+	fill_counts(&started, &completed, &cancelled);
+	CHECK(started == stats.jumps && completed == stats.completed && cancelled == stats.cancelled,
+			"%s: fills started/completed/cancelled %u/%u/%u, expected %u/%u/%u", when, started, completed, cancelled, stats.jumps,
+			stats.completed, stats.cancelled);
+	return 0;
+}
+
+/* main loop pass ... tick, maybe a packet, one task (text compared around it), frame */
+static int pass(bool *has_packet)
+{
+	static bool before[TEXT_LINES][8][LINE_PIXELS], after[TEXT_LINES][8][LINE_PIXELS];
+	uint32_t started, completed, cancelled, completed_before;
+	uint8_t changed = 0, line = 0, x, y;
+	bool is_fill;
+
+	uwTick++;
+	scheduler_tick();
+	/* no packets while the screen is near the oldest record ... they would push its records out of history */
+	*has_packet = (0 == test_random() % 2) && ui_get_scroll_sequence() - history_oldest() >= EVICT_MARGIN;
+	if(*has_packet)
+	{
+		if(packet.time_stamp > uwTick)
+			uwTick = packet.time_stamp;
+		ui_process_midi_packet(&packet);
+		stream_next(&packet);
+	}
+
+	snapshot(before);
+	fill_counts(&started, &completed_before, &cancelled);
+	is_fill = scheduler_dispatch(TASK_PRIORITY_LOW) && 0 == strcmp(scheduler_get_last_task_name(), "scroll fill");
+	fill_counts(&started, &completed, &cancelled);
+	snapshot(after);
+	for(uint8_t n = 1; n <= TEXT_LINES; n++)
+	{
+		if(0 != memcmp(before[n - 1], after[n - 1], sizeof(before[0])))
+		{
+			changed++;
+			line = n;
+		}
+	}
+
+	if(is_fill)
+	{
+		bool is_screen_right = true;
+
+		stats.fill_runs++;
+		CHECK(is_fill_pending || 0 == changed, "fill painted line %u after it was cut short", line);
+		CHECK(changed <= 1, "one fill run painted %u lines", changed);
+		if(0 != changed)
+		{
+			CHECK(line >= last_fill_line, "fill painted line %u after line %u", line, last_fill_line - 1);
+			CHECK(is_line_right(after, line), "fill painted line %u, it doesn't show \"%s\"", line, expected_line(line));
+			last_fill_line = line + 1;
+			stats.fill_lines++;
+		}
+		for(uint8_t n = 1; n <= TEXT_LINES; n++)
+			is_screen_right = is_screen_right && is_line_right(after, n);
+		if(is_fill_pending)
+		{
+			bool is_completed = (completed != completed_before);
+
+			CHECK(!is_completed || is_screen_right, "fill completed with the screen incomplete (record %u, history %u..%u)",
+					ui_get_scroll_sequence(), history_oldest(), history_newest());
+			CHECK(is_completed || !is_screen_done, "fill still running a run after the screen was complete");
+			is_screen_done = is_screen_right;
+			if(is_completed)
+			{
+				is_fill_pending = false;
+				stats.completed++;
+			}
+		}
+	}
+	else
+	{
+		CHECK(0 == changed, "line %u changed by task %s", line, scheduler_get_last_task_name());
+	}
+
+	display_present();
+	drain();
+	if(!ssd1306_IsDirty()) /* frame interval may hold the changes back */
+		CHECK(sim_oled_matches_framebuffer(&x, &y), "glass differs from framebuffer at %u,%u", x, y);
+	return check_counts("after a pass");
+}
+
+/* one to three seconds back from the record on screen ... fill starts, lines right of the record-of-interest blank */
+static int jump(void)
+{
+	static bool lines[TEXT_LINES][8][LINE_PIXELS];
+	uint32_t started, completed, cancelled;
+
+	ui_time_jump_begin();
+	ui_time_jump_step(-(int16_t)(1 + test_random() % 3));
+	fill_counts(&started, &completed, &cancelled);
+	if(started == stats.jumps) /* nothing to jump to */
+		return 0;
+	if(is_fill_pending)
+	{
+		stats.cancelled++;
+		stats.jump_cuts++;
+	}
+	stats.jumps++;
+	is_fill_pending = true;
+	last_fill_line = 2;
+
+	snapshot(lines);
+	CHECK(is_line_right(lines, 1), "after a jump line 1 doesn't show \"%s\"", expected_line(1));
+	is_screen_done = true;
+	for(uint8_t line = 2; line <= TEXT_LINES; line++)
+	{
+		CHECK(is_line_blank(lines, line) || (is_line_right(lines, line) && 0 == strcmp("End of history", expected_line(line))),
+				"after a jump line %u is neither blank nor \"End of history\"", line);
+		is_screen_done = is_screen_done && is_line_right(lines, line);
+	}
+	return check_counts("after a jump");
+}
+
+static void burst(uint32_t packets)
+{
+	for(; packets != 0; packets--)
+	{
+		if(packet.time_stamp > uwTick)
+			uwTick = packet.time_stamp;
+		ui_process_midi_packet(&packet);
+		stream_next(&packet);
+	}
+}
+
+int main(void)
+{
+	bool has_packet;
+
+	sim_oled_attach();
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	display_start_screen();
+	ui_initialize_ui();
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	display_setMode(LIVE);
+	stream_init(STREAM_MIXED, 1);
+	stream_next(&packet);
+	session_start(packet.time_stamp); /* midi.c does on the first status byte ... packets here skip the parser */
+	burst(SESSION_PACKETS);
+	display_present_now();
+	drain();
+
+	for(uint32_t action = 0; action < TEST_ACTIONS; action++)
+	{
+		uint32_t op = test_random() % 8;
+		uint32_t passes = 0, packets = 0, cut_after = test_random() % 4;
+
+		if(jump() != 0)
+			return 1;
+		if(!is_fill_pending)
+			continue;
+
+		/* op 0..3 ... run to completion, else cut short after cut_after passes */
+		while(passes < ((op < 4) ? MAX_FILL_PASSES : cut_after) && is_fill_pending)
+		{
+			if(pass(&has_packet) != 0)
+				return 1;
+			passes++;
+			packets += (has_packet && is_fill_pending) ? 1 : 0;
+		}
+		if(op < 4)
+		{
+			CHECK(!is_fill_pending, "fill not complete %u passes after the jump", passes);
+			stats.packets_between += packets;
+			if(passes > stats.max_passes)
+				stats.max_passes = passes;
+		}
+		else if(op < 6)
+		{
+			ui_scroll_history((0 == test_random() % 2) ? -1 : 1);
+			stats.cancelled += is_fill_pending ? 1 : 0;
+			stats.detent_cuts += is_fill_pending ? 1 : 0;
+		}
+		else if(op < 7)
+		{
+			ui_scroll_history(10000); /* past the newest ... LIVE */
+			stats.cancelled += is_fill_pending ? 1 : 0;
+			stats.live_cuts += is_fill_pending ? 1 : 0;
+		}
+		/* op 7 ... cut short by the next jump */
+		if(op >= 4 && op < 7)
+		{
+			is_fill_pending = false;
+			if(check_counts("after a cut") != 0)
+				return 1;
+			for(uint8_t n = 0; n < 8; n++) /* a cut fill must stay quiet */
+			{
+				if(pass(&has_packet) != 0)
+					return 1;
+			}
+		}
+		if(0 == test_random() % 8 && APP_STATE_SCROLL_HISTORY == app_get_state())
+			ui_scroll_history(10000);
+	}
+	CHECK(stats.completed > 0 && stats.detent_cuts > 0 && stats.live_cuts > 0 && stats.jump_cuts > 0,
+			"%u fills completed, cut short by %u detents, %u returns to LIVE, %u jumps", stats.completed, stats.detent_cuts,
+			stats.live_cuts, stats.jump_cuts);
+	CHECK(stats.packets_between > 0, "no packet handled between fill lines");
+
+	printf("  %u jumps: %u fills completed (at most %u passes), cut short by %u detents, %u returns to LIVE, %u jumps\n", stats.jumps,
+			stats.completed, stats.max_passes, stats.detent_cuts, stats.live_cuts, stats.jump_cuts);
+	printf("  %u lines painted in %u fill runs, %u packets handled between lines of completed fills\n", stats.fill_lines,
+			stats.fill_runs, stats.packets_between);
+	printf("test_scroll_fill: OK (one line per run, top to bottom, cut fills stay quiet)\n");
+	return 0;
+}
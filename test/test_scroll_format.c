@@ -0,0 +1,236 @@
+/*
+ * test_scroll_format.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <string.h>
+#include "test.h"
+#include "main.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "filter_channels.h"
+#include "app_state_machine.h"
+#include "midi_stream.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Formatter calls per scroll detent with the rendered-line cache ... midi_process_message() is wrapped at link time
+ * (-Wl,--wrap, calls from ui.c only) and counted. Sweeps from the newest record to the oldest and back, with and
+ * without a channel filter, must format at most one record per detent that moves the screen (the line moved in) and
+ * none at the end of history. Every few detents on the way down the wheel is turned back and forth once: both lines
+ * moved in were on screen a moment ago and must come from the cache (unfiltered). A repaint without the cache formats every line
+ * on screen. After every detent the text area must show the right records (formatted here without the cache), which
+ * also covers a short session followed by another that reuses its sequence numbers.
+ */
+
+#define SESSION_PACKETS		(1500u)
+#define SHORT_SESSION		(40u)		/* fewer records than a LIVE screen ... scroll must not serve the last session's text */
+#define TURN_DETENTS		(16u)		/* turn the wheel back and forth every so many detents */
+#define TEXT_LINES			(6u)		/* scroll screen lines 1..6 */
+#define LINE_CHARS			(24u)
+#define LINE_HEIGHT			(DISPLAY_DEFAULT_FONT.height + 1)
+#define TEXT_WIDTH			(SSD1306_WIDTH - 4)	/* display_clear_line() area, scroll bar right of it */
+
+char *__real_midi_process_message(uint8_t status, uint8_t data1, uint8_t data2);
+
+static uint32_t format_calls;
+
+char *__wrap_midi_process_message(uint8_t status, uint8_t data1, uint8_t data2)
+{
+	format_calls++;
+	return __real_midi_process_message(status, data1, data2);
+}
+
+typedef struct {
+	const char *name;
+	uint32_t detents;		/* detents that moved the screen */
+	uint32_t calls;			/* formatter calls for them */
+	uint32_t end_detents;	/* detents against the end of history */
+	uint32_t turns;			/* back and forth turns, two detents each */
+	uint32_t turn_calls;	/* formatter calls for them */
+	uint32_t lines_on_screen;	/* what repaints without the cache would have formatted */
+} Sweep;
+
+static bool glyph_pixel(const char *str, uint8_t x, uint8_t row)
+{
+	uint8_t index = x / DISPLAY_DEFAULT_FONT.width;
+
+	if(index >= strlen(str))
+		return false;
+	return (DISPLAY_DEFAULT_FONT.data[(str[index] - 32) * DISPLAY_DEFAULT_FONT.height + row] << (x % DISPLAY_DEFAULT_FONT.width)) & 0x8000;
+}
+
+static bool is_filtered_in(uint32_t sequence, stc_midi_history *record)
+{
+	return history_read(sequence, record) && (0 == filter_getChannel() || filter_getChannel() == record->channel);
+}
+
+/* text the scroll screen should show for the record-of-interest, formatted without the cache ... records shown */
+static uint8_t expected_lines(char text[TEXT_LINES][LINE_CHARS])
+{
+	stc_midi_history record;
+	uint32_t sequence = ui_get_scroll_sequence();
+	uint8_t count = 0;
+
+	memset(text, 0, TEXT_LINES * LINE_CHARS);
+	history_read(sequence, &record);
+	strncpy(text[count++], __real_midi_process_message(record.running_status, record.data[0], record.data[1]), LINE_CHARS - 1);
+	while(count < TEXT_LINES && sequence != history_oldest())
+	{
+		sequence--;
+		if(!is_filtered_in(sequence, &record))
+			continue;
+		strncpy(text[count++], __real_midi_process_message(record.running_status, record.data[0], record.data[1]), LINE_CHARS - 1);
+	}
+	if(count < TEXT_LINES)
+		strcpy(text[count], "End of history");
+	return count;
+}
+
+static int check_text(const char *name, uint32_t detent)
+{
+	char text[TEXT_LINES][LINE_CHARS];
+
+	expected_lines(text);
+	for(uint8_t line = 0; line < TEXT_LINES; line++)
+	{
+		uint8_t top = (line + 1) * LINE_HEIGHT;
+
+		for(uint8_t row = 0; row < DISPLAY_DEFAULT_FONT.height; row++)
+		{
+			for(uint8_t x = 0; x < TEXT_WIDTH; x++)
+				CHECK((White == ssd1306_GetPixel(x, top + row)) == glyph_pixel(text[line], x, row),
+						"%s detent %u: line %u should read \"%s\", pixel %u,%u differs", name, detent, line + 1, text[line], x, top + row);
+		}
+	}
+	return 0;
+}
+
+/* new capture session in LIVE with packets from a stream */
+static void session(StreamStyle style, uint32_t packets)
+{
+	stc_midi packet;
+
+	ui_initialize_ui();
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	display_setMode(LIVE);
+
+	stream_init(style, uwTick + 1);
+	for(uint32_t n = 0; n < packets; n++)
+	{
+		stream_next(&packet);
+		uwTick = packet.time_stamp;
+		ui_process_midi_packet(&packet);
+	}
+}
+
+/*
+ * one detent back toward the newest record and one forward again ... both lines moved in were just on screen, so
+ * without a filter they are cached. Filtered records are not consecutive and can share a cache entry (direct mapped)
+ */
+static int turn(Sweep *result, uint32_t detent)
+{
+	uint32_t limit = (0 == filter_getChannel()) ? 0 : 1;
+
+	for(int16_t delta = 1; delta >= -1; delta -= 2)
+	{
+		format_calls = 0;
+		ui_scroll_history(delta);
+		CHECK(APP_STATE_SCROLL_HISTORY == app_get_state() && format_calls <= limit, "%s detent %u: turn %+d left scroll or formatted %u lines",
+				result->name, detent, delta, format_calls);
+		result->turn_calls += format_calls;
+		if(check_text(result->name, detent) != 0)
+			return 1;
+	}
+	result->turns++;
+	return 0;
+}
+
+/* scroll from newest to oldest and back to LIVE, one detent at a time */
+static int sweep(Sweep *result)
+{
+	uint32_t sequence;
+	uint32_t detent = 0;
+
+	result->detents = result->calls = result->end_detents = result->turns = result->turn_calls = result->lines_on_screen = 0;
+
+	format_calls = 0;
+	ui_scroll_history(-1); /* entry ... newest matching record on top */
+	CHECK(APP_STATE_SCROLL_HISTORY == app_get_state(), "%s: no scroll session", result->name);
+	CHECK(format_calls <= TEXT_LINES, "%s: entry formatted %u lines", result->name, format_calls);
+	if(check_text(result->name, detent) != 0)
+		return 1;
+
+	for(int16_t delta = -1; APP_STATE_SCROLL_HISTORY == app_get_state(); detent++)
+	{
+		char text[TEXT_LINES][LINE_CHARS];
+
+		sequence = ui_get_scroll_sequence();
+		format_calls = 0;
+		ui_scroll_history(delta);
+		if(APP_STATE_SCROLL_HISTORY != app_get_state())
+			break; /* past the newest record, back in LIVE */
+		if(sequence == ui_get_scroll_sequence())
+		{
+			CHECK(delta < 0 && 0 == format_calls, "%s detent %u: %u formatter calls without moving", result->name, detent, format_calls);
+			result->end_detents++;
+			if(result->end_detents == 3)
+				delta = 1; /* turn around at the end of history */
+		}
+		else
+		{
+			CHECK(format_calls <= 1, "%s detent %u: %u formatter calls for one line moved", result->name, detent, format_calls);
+			result->detents++;
+			result->calls += format_calls;
+			result->lines_on_screen += expected_lines(text);
+			if(delta < 0 && TURN_DETENTS / 2 == result->detents % TURN_DETENTS && turn(result, detent) != 0)
+				return 1;
+		}
+		if(check_text(result->name, detent) != 0)
+			return 1;
+	}
+	CHECK(result->end_detents == 3 && result->detents > 0, "%s: %u detents, %u at the end of history", result->name,
+			result->detents, result->end_detents);
+
+	printf("  %-8s %5u detents, %.2f formatter calls/detent (repaint %.2f), %3u turns %.2f calls/turn\n", result->name,
+			result->detents, (double)result->calls / result->detents, (double)result->lines_on_screen / result->detents, result->turns,
+			(double)result->turn_calls / result->turns);
+	return 0;
+}
+
+int main(void)
+{
+	Sweep first = {"short"}, restarted = {"restart"}, all = {"all"}, filtered = {"channel"};
+	stc_midi_history record;
+
+	sim_oled_attach();
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	display_start_screen();
+
+	/* two short sessions, the second reuses the sequence numbers the first left in the cache */
+	session(STREAM_MIXED, SHORT_SESSION);
+	if(sweep(&first) != 0)
+		return 1;
+	session(STREAM_CONTROLLERS, SHORT_SESSION);
+	if(sweep(&restarted) != 0)
+		return 1;
+
+	/* long session, history rolled over */
+	session(STREAM_MIXED, SESSION_PACKETS);
+	if(sweep(&all) != 0)
+		return 1;
+	history_read(history_newest(), &record); /* filter on a channel the stream uses */
+	display_channel(filter_setChannel(record.channel));
+	if(sweep(&filtered) != 0)
+		return 1;
+	display_channel(filter_setChannel(0));
+
+	printf("test_scroll_format: OK (%u detents, at most one formatter call each)\n",
+			first.detents + restarted.detents + all.detents + filtered.detents);
+	return 0;
+}
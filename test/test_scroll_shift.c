@@ -0,0 +1,255 @@
+/*
+ * test_scroll_shift.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <string.h>
+#include "test.h"
+#include "main.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "filter_channels.h"
+#include "app_state_machine.h"
+#include "midi_stream.h"
+#include "ssd1306_sim.h"
+
+/*
+ * Scroll screen built by framebuffer shifts against a full repaint ... random single and multi detent scrolls,
+ * jumps to the oldest record (line by line fill, sometimes cut short by a detent), channel filter changes, packet
+ * bursts that roll the history over, and returns to LIVE. Whenever the scroll screen has settled after a detent or
+ * jump, the glass (simulated controller) text area is kept, the text area is cleared and every line is drawn again
+ * from the history (formatted here, no cache), and the glass must not change. The controller must match the
+ * framebuffer throughout. Bus data for single detent frames is compared with the full repaints.
+ */
+
+#define TEST_STEPS			(20000u)
+#define SESSION_PACKETS		(1500u)
+#define BURST_PACKETS		(40u)		/* most packets one step adds */
+#define TEXT_LINES			(6u)		/* scroll screen lines 1..6 */
+#define LINE_CHARS			(24u)
+#define TEXT_TOP			(DISPLAY_DEFAULT_FONT.height)	/* display_clear_page() area */
+#define TEXT_BOTTOM			(SSD1306_HEIGHT - 2)
+#define TEXT_WIDTH			(SSD1306_WIDTH - 4)
+
+typedef struct {
+	uint32_t compared;			/* settled screens compared with a repaint */
+	uint32_t detents;			/* scroll steps, single and multi detent */
+	uint32_t jumps;
+	uint32_t cut_fills;			/* jumps whose fill a detent cut short */
+	uint32_t bursts;
+	uint32_t filters;
+	uint32_t lives;				/* returns to LIVE */
+	uint32_t single_frames;		/* flushes after a single detent */
+	uint32_t single_bytes;
+	uint32_t repaint_frames;
+	uint32_t repaint_bytes;
+} Stats;
+
+static Stats stats;
+static bool glass[TEXT_BOTTOM + 1][TEXT_WIDTH];
+
+static void drain(void)
+{
+	while(ssd1306_IsBusy())
+		display_service();
+}
+
+/* frame with whatever is drawn ... bus data bytes it took */
+static uint32_t flush(void)
+{
+	SimOledStats bus;
+
+	sim_oled_reset_stats();
+	display_present_now();
+	drain();
+	sim_oled_get_stats(&bus);
+	return bus.data_bytes;
+}
+
+static uint32_t fills_started(void)
+{
+	uint32_t started, completed, cancelled;
+
+	ui_get_fill_stats(&started, &completed, &cancelled);
+	return started;
+}
+
+static bool is_fill_pending(void)
+{
+	uint32_t started, completed, cancelled;
+
+	ui_get_fill_stats(&started, &completed, &cancelled);
+	return started != completed + cancelled;
+}
+
+/* main loop passes ... fill timer runs, frames go out */
+static void run(uint32_t ms)
+{
+	for(; ms != 0; ms--)
+	{
+		uwTick++;
+		scheduler_dispatch(TASK_PRIORITY_LOW);
+		display_present();
+		drain();
+	}
+}
+
+static bool is_scrolling(void)
+{
+	return APP_STATE_SCROLL_HISTORY == app_get_state();
+}
+
+/* full repaint of the scroll screen text from the history ... record-of-interest first, older matching records below */
+static void repaint(void)
+{
+	stc_midi_history record;
+	uint32_t sequence = ui_get_scroll_sequence();
+	uint8_t line = 1;
+
+	display_clear_page(Black);
+	history_read(sequence, &record);
+	display_string(midi_process_message(record.running_status, record.data[0], record.data[1]), line++, 0, White, true);
+	while(line <= TEXT_LINES && sequence != history_oldest())
+	{
+		sequence--;
+		if(!history_read(sequence, &record) || (0 != filter_getChannel() && filter_getChannel() != record.channel))
+			continue;
+		display_string(midi_process_message(record.running_status, record.data[0], record.data[1]), line++, 0, White, true);
+	}
+	if(line <= TEXT_LINES)
+		display_string("End of history", line, 0, White, true);
+}
+
+static int compare(uint32_t step)
+{
+	uint8_t x, y;
+
+	flush(); /* frame interval may still be holding back the last changes */
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "step %u: controller differs from framebuffer at %u,%u", step, x, y);
+	for(y = TEXT_TOP; y <= TEXT_BOTTOM; y++)
+	{
+		for(x = 0; x < TEXT_WIDTH; x++)
+			glass[y][x] = sim_oled_pixel(x, y);
+	}
+
+	repaint();
+	stats.repaint_bytes += flush();
+	stats.repaint_frames++;
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "step %u: controller differs from framebuffer at %u,%u after repaint", step, x, y);
+	for(y = TEXT_TOP; y <= TEXT_BOTTOM; y++)
+	{
+		for(x = 0; x < TEXT_WIDTH; x++)
+			CHECK(sim_oled_pixel(x, y) == glass[y][x], "step %u (record %lu, channel %u): pixel %u,%u is %s, full repaint has it %s", step,
+					(unsigned long)ui_get_scroll_sequence(), filter_getChannel(), x, y, glass[y][x] ? "on" : "off", glass[y][x] ? "off" : "on");
+	}
+	stats.compared++;
+	return 0;
+}
+
+static void burst(void)
+{
+	stc_midi packet;
+
+	for(uint32_t n = 1 + test_random() % BURST_PACKETS; n != 0; n--)
+	{
+		stream_next(&packet);
+		if(packet.time_stamp > uwTick)
+			uwTick = packet.time_stamp;
+		ui_process_midi_packet(&packet);
+	}
+}
+
+int main(void)
+{
+	bool is_comparable = false;	/* screen was painted by a detent or jump, nothing changed the history or filter since */
+
+	sim_oled_attach();
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	display_start_screen();
+	ui_initialize_ui();
+	app_set_state(APP_STATE_MIDI_DISPLAY);
+	display_setMode(LIVE);
+
+	stream_init(STREAM_MIXED, 1);
+	for(uint32_t n = 0; n < SESSION_PACKETS; n += BURST_PACKETS)
+		burst();
+	flush();
+
+	for(uint32_t step = 0; step < TEST_STEPS; step++)
+	{
+		uint32_t op = test_random() % 100;
+		bool was_scrolling = is_scrolling();
+
+		if(op < 55) /* single detent, mostly back into history */
+		{
+			int16_t delta = (test_random() % 3) ? -1 : 1;
+
+			if(is_fill_pending())
+				stats.cut_fills++;
+			ui_scroll_history(delta);
+			stats.detents++;
+			is_comparable = true;
+			if(was_scrolling && is_scrolling() && !is_fill_pending())
+			{
+				stats.single_bytes += flush();
+				stats.single_frames++;
+			}
+		}
+		else if(op < 75) /* fast turn, several detents in one pass */
+		{
+			int16_t delta = (int16_t)(test_random() % 17) - 8;
+
+			if(is_fill_pending())
+				stats.cut_fills++;
+			ui_scroll_history(delta ? delta : -TEXT_LINES);
+			stats.detents++;
+			is_comparable = true;
+		}
+		else if(op < 80)
+		{
+			uint32_t started = fills_started();
+
+			ui_jump_to_oldest();
+			if(fills_started() != started) /* no fill ... no record matches the filter, jump ignored */
+			{
+				stats.jumps++;
+				is_comparable = true;
+			}
+		}
+		else if(op < 85)
+		{
+			display_channel(filter_setChannel((test_random() % 3) ? 0 : 1 + test_random() % 16));
+			stats.filters++;
+			is_comparable = false; /* scroll screen is repainted on the next detent */
+		}
+		else
+		{
+			burst();
+			stats.bursts++;
+			is_comparable = false;
+		}
+		if(was_scrolling && !is_scrolling())
+			stats.lives++;
+
+		run(test_random() % 4); /* a fill may still be running */
+		if(!is_fill_pending() && is_scrolling() && is_comparable && compare(step) != 0)
+			return 1;
+	}
+	CHECK(stats.compared > TEST_STEPS / 4 && stats.jumps > 0 && stats.cut_fills > 0 && stats.lives > 0,
+			"%u compared, %u jumps, %u fills cut short, %u returns to LIVE", stats.compared, stats.jumps, stats.cut_fills, stats.lives);
+	CHECK(stats.single_bytes / stats.single_frames < stats.repaint_bytes / stats.repaint_frames,
+			"single detent %u data bytes per frame, full repaint %u", stats.single_bytes / stats.single_frames,
+			stats.repaint_bytes / stats.repaint_frames);
+
+	printf("  %u detent steps, %u jumps (%u fills cut short), %u filter changes, %u bursts, %u returns to LIVE\n",
+			stats.detents, stats.jumps, stats.cut_fills, stats.filters, stats.bursts, stats.lives);
+	printf("  data bytes per frame: single detent %u, full repaint %u\n", stats.single_bytes / stats.single_frames,
+			stats.repaint_bytes / stats.repaint_frames);
+	printf("test_scroll_shift: OK (%u settled screens identical to a full repaint)\n", stats.compared);
+	return 0;
+}
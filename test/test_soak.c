@@ -0,0 +1,142 @@
+/*
+ * test_soak.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "ui.h"
+#include "display.h"
+#include "history.h"
+#include "scheduler.h"
+#include "filter_channels.h"
+#include "midi_stream.h"
+
+/*
+ * 10 million packets through ui_post_packet_to_history() ... the SRAM backend is wrapped so sequence numbers start
+ * SOAK_BASE short of 2^32 and cross the wrap early in the run (timestamps start short of 2^32 as well). After every
+ * packet the capture index must be consistent: count, newest/oldest, newest readable, just-evicted not readable.
+ * Every SOAK_SCROLL_INTERVAL packets (every SOAK_WRAP_INTERVAL while the retained window straddles the wrap) the
+ * scroll session is walked to newest, two back, oldest and back to LIVE, with and without a channel filter.
+ */
+
+#define SOAK_PACKETS			(10000000u)
+#define SOAK_BASE				(0xFFFFFFFFu - 4000000u + 1u)	/* sequence number of first record */
+#define SOAK_SCROLL_INTERVAL	(9973u)
+#define SOAK_WRAP_INTERVAL		(37u)		/* scroll check interval while the retained window straddles the wrap */
+
+static const HistoryBackend *sram = &history_sram_backend;
+
+static uint32_t offset_reset(void)
+{
+	return sram->reset();
+}
+
+static void offset_append(const stc_midi_history *record)
+{
+	sram->append(record);
+}
+
+static bool offset_read(uint32_t sequence, stc_midi_history *record)
+{
+	return sram->read(sequence - SOAK_BASE, record);
+}
+
+static uint32_t offset_oldest(void)
+{
+	return sram->oldest() + SOAK_BASE;
+}
+
+static uint32_t offset_next(void)
+{
+	return sram->next() + SOAK_BASE;
+}
+
+static void offset_evict_before(uint32_t sequence)
+{
+	sram->evict_before(sequence - SOAK_BASE);
+}
+
+static const HistoryBackend offset_backend = {
+	"SRAM+offset", offset_reset, offset_append, offset_read, offset_oldest, offset_next, offset_evict_before
+};
+
+/* second newest record on channel (0 = any) ... what two ccw detents from LIVE land on */
+static uint32_t second_newest_on_channel(uint8_t channel)
+{
+	stc_midi_history record;
+	uint8_t found = 0;
+
+	for(uint32_t sequence = history_newest(); ; sequence--)
+	{
+		if(history_read(sequence, &record) && (0 == channel || record.channel == channel) && 2 == ++found)
+			return sequence;
+		if(sequence == history_oldest())
+			return sequence;
+	}
+}
+
+static int check_scroll(uint32_t n)
+{
+	uint8_t channel = 1 + n % 4;
+	stc_midi_history record;
+
+	filter_setChannel(0);
+	ui_scroll_history(-1);
+	CHECK(ui_get_scroll_sequence() == history_newest(), "packet %u: first detent at %u, newest %u", n, ui_get_scroll_sequence(), history_newest());
+	ui_scroll_history(-2);
+	CHECK(ui_get_scroll_sequence() == history_newest() - 2, "packet %u: two detents back at %u, newest %u", n, ui_get_scroll_sequence(), history_newest());
+	ui_scroll_history(-30000);
+	CHECK(ui_get_scroll_sequence() == history_oldest(), "packet %u: end of history at %u, oldest %u", n, ui_get_scroll_sequence(), history_oldest());
+	ui_jump_to_oldest();
+	for(uint8_t i = 0; i < 6; i++)
+		ui_fill_display(); /* one line per call, at most 5 */
+	CHECK(ui_get_scroll_sequence() == history_oldest(), "packet %u: jump to oldest at %u, oldest %u", n, ui_get_scroll_sequence(), history_oldest());
+	ui_scroll_history(30000);
+	CHECK(LIVE == display_getMode(), "packet %u: not back in LIVE", n);
+
+	filter_setChannel(channel);
+	ui_scroll_history(-2);
+	CHECK(history_read(ui_get_scroll_sequence(), &record) && record.channel == channel, "packet %u: filtered scroll off channel %u", n, channel);
+	CHECK(ui_get_scroll_sequence() == second_newest_on_channel(channel), "packet %u: filtered scroll at %u, expected %u", n, ui_get_scroll_sequence(), second_newest_on_channel(channel));
+	ui_scroll_history(30000);
+	filter_setChannel(0);
+	return 0;
+}
+
+int main(void)
+{
+	stc_midi packet;
+	stc_midi_history record;
+	uint32_t capacity;
+
+	history_init(&offset_backend);
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	ui_initialize_ui(); /* keeps the backend selected above */
+	capacity = history_capacity();
+	stream_init(STREAM_MIXED, 0xFFFFFFFFu - 3600000u);
+
+	for(uint32_t n = 1; n <= SOAK_PACKETS; n++)
+	{
+		uint32_t newest = SOAK_BASE + n - 1;
+		uint32_t count = (n < capacity) ? n : capacity;
+
+		stream_next(&packet);
+		ui_post_packet_to_history(&packet);
+
+		CHECK(history_count() == count, "packet %u: count %u, expected %u", n, history_count(), count);
+		CHECK(history_newest() == newest, "packet %u: newest %u, expected %u", n, history_newest(), newest);
+		CHECK(history_oldest() == newest - count + 1, "packet %u: oldest %u, expected %u", n, history_oldest(), newest - count + 1);
+		CHECK(history_read(newest, &record) && record.time_stamp == packet.time_stamp, "packet %u: newest record not readable", n);
+		CHECK(n <= capacity || !history_read(newest - capacity, &record), "packet %u: evicted record %u readable", n, newest - capacity);
+
+		if((0 == n % SOAK_SCROLL_INTERVAL || (history_oldest() > newest && 0 == n % SOAK_WRAP_INTERVAL)) && check_scroll(n) != 0)
+			return 1;
+	}
+
+	printf("test_soak: OK (%u packets, sequence %u..%u, %u held)\n", SOAK_PACKETS, SOAK_BASE, history_newest(), history_count());
+	return 0;
+}
@@ -0,0 +1,281 @@
+/*
+ * test_startup.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <string.h>
+#include "test.h"
+#include "main.h"
+#include "ui.h"
+#include "display.h"
+#include "scheduler.h"
+#include "history.h"
+#include "trigger.h"
+#include "midi.h"
+#include "app_state_machine.h"
+#include "ssd1306_sim.h"
+
+/*
+ * MIDI capture from power-on ... the startup in main.c (USER CODE 2) in the same order on a simulated us clock,
+ * with MIDI at full rate (3 byte note on messages back to back, 320 us a byte) from power-on. Time passes in the
+ * blocking parts of startup (HAL_Delay() in ssd1306_Init(), blocking I2C commands at 400 kHz) and in main loop
+ * passes. Bytes that arrive before HAL_UART_Receive_IT() are lost, after it the USART1 receive interrupt puts them
+ * in rxFIFO as HAL_UART_RxCpltCallback() does (timestamp, count clamped at UART_FIFO_SIZE + 1 on overflow). The
+ * main loop drains the FIFO into midi_build_packet() and ui_process_midi_packet() through the splash screen and
+ * after it (timebase_init(), tasks, console left out ... no bearing on capture).
+ * Checks: no FIFO overflow and no receive overrun, every message whose status byte came after arming is in history
+ * in order with its bytes, the splash ends on time and LIVE shows the newest message. Then the old order (splash,
+ * HAL_Delay(5000), then arming) to show how much of the start it lost.
+ */
+
+#define ARM_AT_US			(2000u)		/* HAL_Init(), clocks and peripheral init before USER CODE 2 */
+#define BYTE_US				(320u)		/* 31250 baud, 10 bits */
+#define I2C_BYTE_US			(25u)		/* 400 kHz, blocking transfers */
+#define PASS_US				(20u)		/* main loop pass without a byte */
+#define BYTE_WORK_US		(60u)		/* FIFO byte, parsing, history, drawing */
+#define RUN_MS				(8000u)
+#define SPLASH_MS			(5000u)
+#define FIFO_TIMESTAMP_MASK	(0x00FFFFFFu)	/* 24-bit byte timestamps, as main.c */
+
+static uint64_t now_us;
+static uint64_t next_byte_us;
+static uint32_t bytes_sent;				/* byte n is byte n % 3 of message n / 3 */
+static bool is_armed;					/* receive interrupt armed */
+static SimI2cSink oled_sink;
+
+static struct {
+	uint8_t rx_byte;
+	uint32_t byte_timestamp;
+} rx_fifo[UART_FIFO_SIZE];
+static uint16_t head, tail;
+
+typedef struct {
+	uint32_t lost_unarmed;		/* before HAL_UART_Receive_IT() */
+	uint32_t lost_overrun;
+	uint32_t lost_overflow;
+	uint32_t first_message;		/* first message whose status byte was captured */
+	uint32_t armed_ms;
+	uint32_t first_byte_ms;
+	uint32_t loop_start_ms;
+	uint16_t loop_start_fill;	/* FIFO fill when the main loop starts */
+	uint16_t max_fill;
+	uint32_t splash_end_ms;
+} Stats;
+
+static Stats stats;
+
+static uint8_t message_byte(uint32_t n)
+{
+	uint32_t message = n / 3;
+
+	switch(n % 3)
+	{
+		case 0:
+			return 0x90 | (message % 16);
+		case 1:
+			return message & 0x7F;
+		default:
+			return 1 + (message >> 7) % 127;
+	}
+}
+
+static bool glyph_pixel(const char *str, uint8_t x, uint8_t row)
+{
+	uint8_t index = x / DISPLAY_DEFAULT_FONT.width;
+
+	if(index >= strlen(str))
+		return false;
+	return (DISPLAY_DEFAULT_FONT.data[(str[index] - 32) * DISPLAY_DEFAULT_FONT.height + row] << (x % DISPLAY_DEFAULT_FONT.width)) & 0x8000;
+}
+
+/* USART1 receive interrupt ... HAL_UART_RxCpltCallback() */
+static void uart_rx_isr(uint8_t byte)
+{
+	if(false == is_midi_first_byte)
+	{
+		midi_first_byte_ms = HAL_GetTick();
+		is_midi_first_byte = true;
+		stats.first_byte_ms = midi_first_byte_ms;
+		stats.first_message = (bytes_sent + 2) / 3; /* partial message ... no status byte, parser drops it */
+	}
+	fifo_count++;
+	if(fifo_count > UART_FIFO_SIZE)
+	{
+		stats.lost_overflow++;
+		tail = head;
+		fifo_count = UART_FIFO_SIZE + 1;
+	}
+	rx_fifo[head].byte_timestamp = HAL_GetTick();
+	rx_fifo[head++].rx_byte = byte;
+	if(head >= UART_FIFO_SIZE)
+		head = 0;
+	if(fifo_count > stats.max_fill)
+		stats.max_fill = fifo_count;
+}
+
+/* bytes up to now ... HAL_Delay() moves uwTick on its own, the us clock follows it */
+static void catch_up(void)
+{
+	if((uint64_t)uwTick * 1000u > now_us)
+		now_us = (uint64_t)uwTick * 1000u;
+	while(next_byte_us <= now_us)
+	{
+		uwTick = (uint32_t)(next_byte_us / 1000u);
+		if(!is_armed)
+			stats.lost_unarmed++;
+		else if(0 != sim_primask) /* masked past the next byte ... overrun (startup never masks that long) */
+			stats.lost_overrun++;
+		else
+			uart_rx_isr(message_byte(bytes_sent));
+		bytes_sent++;
+		next_byte_us += BYTE_US;
+	}
+	uwTick = (uint32_t)(now_us / 1000u);
+}
+
+static void spend(uint32_t us)
+{
+	now_us += us;
+	catch_up();
+}
+
+/* blocking I2C ... CPU waits, interrupts still taken */
+static void i2c_sink(uint16_t address, const uint8_t *data, uint16_t size)
+{
+	oled_sink(address, data, size);
+	spend((size + 1) * I2C_BYTE_US);
+}
+
+static void arm(void)
+{
+	catch_up();
+	midi_armed_ms = HAL_GetTick();
+	stats.armed_ms = midi_armed_ms;
+	is_armed = true;
+}
+
+static void run(bool is_old_order)
+{
+	stc_midi *packet = NULL;
+
+	memset(&stats, 0, sizeof(stats));
+	now_us = next_byte_us = 0;
+	bytes_sent = 0;
+	is_armed = false;
+	head = tail = 0;
+	fifo_count = 0;
+	is_midi_first_byte = false;
+	uwTick = 0;
+
+	spend(ARM_AT_US);
+	if(!is_old_order)
+		arm();
+	display_init();
+	scheduler_init();
+	ui_init_tasks();
+	trigger_init();
+	ui_initialize_ui();
+	if(is_old_order) /* splash, then HAL_Delay(5000), then capture */
+	{
+		display_splash_screen();
+		display_present_now();
+		HAL_Delay(SPLASH_MS);
+		arm();
+		display_start_screen();
+		app_set_state(APP_STATE_MIDI_DISPLAY);
+	}
+	else
+	{
+		ui_show_splash();
+	}
+	stats.loop_start_ms = HAL_GetTick();
+	stats.loop_start_fill = fifo_count;
+
+	while(HAL_GetTick() < RUN_MS || 0 != fifo_count) /* MIDI stops at RUN_MS, FIFO drained after */
+	{
+		if(HAL_GetTick() >= RUN_MS)
+			next_byte_us = UINT64_MAX;
+		scheduler_advance(HAL_GetTick());
+		if(0 != fifo_count)
+		{
+			uint32_t now = HAL_GetTick();
+			uint32_t timestamp = now - ((now - rx_fifo[tail].byte_timestamp) & FIFO_TIMESTAMP_MASK);
+			uint8_t byte = rx_fifo[tail++].rx_byte;
+
+			fifo_count--;
+			if(tail >= UART_FIFO_SIZE)
+				tail = 0;
+			packet = midi_build_packet(byte, timestamp);
+			spend(BYTE_WORK_US);
+		}
+		if(midi_isPacketAvailable())
+			ui_process_midi_packet(packet);
+		if(scheduler_dispatch(TASK_PRIORITY_LOW) && 0 == stats.splash_end_ms && APP_STATE_SPLASH != app_get_state())
+			stats.splash_end_ms = HAL_GetTick();
+		display_service();
+		display_present();
+		spend(PASS_US);
+	}
+}
+
+int main(void)
+{
+	Stats fixed;
+	stc_midi_history record;
+	uint32_t messages, sequence, held;
+	const char *newest;
+	uint8_t x, y;
+
+	sim_oled_attach();
+	oled_sink = sim_i2c_sink;
+	sim_i2c_sink = i2c_sink;
+
+	run(false);
+	fixed = stats;
+	messages = bytes_sent / 3;
+	CHECK(0 == fixed.lost_overflow && 0 == fixed.lost_overrun, "%u bytes lost to FIFO overflow, %u to overrun", fixed.lost_overflow,
+			fixed.lost_overrun);
+	CHECK(fixed.lost_unarmed <= ARM_AT_US / BYTE_US + 1, "%u bytes before arming, capture armed at %u ms", fixed.lost_unarmed,
+			fixed.armed_ms);
+	CHECK(history_newest() + 1 == messages - fixed.first_message, "%u messages in history, %u sent after arming", history_newest() + 1,
+			messages - fixed.first_message);
+	for(sequence = history_oldest(); sequence != history_newest() + 1; sequence++)
+	{
+		uint32_t n = (fixed.first_message + sequence) * 3;
+
+		CHECK(history_read(sequence, &record), "record %u unreadable", sequence);
+		CHECK(record.running_status == message_byte(n) && record.data[0] == message_byte(n + 1) && record.data[1] == message_byte(n + 2),
+				"record %u holds %02X %02X %02X, message %u was %02X %02X %02X", sequence, record.running_status, record.data[0],
+				record.data[1], fixed.first_message + sequence, message_byte(n), message_byte(n + 1), message_byte(n + 2));
+	}
+	CHECK(fixed.splash_end_ms >= SPLASH_MS && fixed.splash_end_ms < SPLASH_MS + fixed.loop_start_ms + 10,
+			"splash ended at %u ms", fixed.splash_end_ms);
+	CHECK(APP_STATE_MIDI_DISPLAY == app_get_state(), "state %u after the splash", app_get_state());
+	display_present_now();
+	while(ssd1306_IsBusy())
+		display_service();
+	CHECK(sim_oled_matches_framebuffer(&x, &y), "glass differs from framebuffer at %u,%u", x, y);
+	history_read(history_newest(), &record);
+	newest = midi_process_message(record.running_status, record.data[0], record.data[1]);
+	for(y = 0; y < DISPLAY_DEFAULT_FONT.height - 1; y++) /* bottom row is the FIFO bar */
+		for(x = 0; x < DISPLAY_LIVE_SCROLL_WIDTH; x++)
+			CHECK(sim_oled_pixel(x, SSD1306_HEIGHT - 8 + y) == glyph_pixel(newest, x, y), "LIVE bottom line is not \"%s\" at %u,%u", newest,
+					x, SSD1306_HEIGHT - 8 + y);
+	held = history_newest() - history_oldest() + 1;
+
+	run(true);
+	CHECK(stats.lost_unarmed > SPLASH_MS * 1000u / BYTE_US, "old order lost only %u bytes", stats.lost_unarmed);
+
+	printf("  capture armed at %u ms, first byte at %u ms, %u bytes before (power-on to arming)\n", fixed.armed_ms, fixed.first_byte_ms,
+			fixed.lost_unarmed);
+	printf("  main loop from %u ms with %u bytes waiting, FIFO at most %u of %u, splash ended at %u ms\n", fixed.loop_start_ms,
+			fixed.loop_start_fill, fixed.max_fill, UART_FIFO_SIZE, fixed.splash_end_ms);
+	printf("  %u messages from power-on in %u ms, all %u after arming in history (%u held)\n", messages, RUN_MS,
+			messages - fixed.first_message, held);
+	printf("  old order (splash, HAL_Delay(%u), then arming): %u bytes lost, capture armed at %u ms\n", SPLASH_MS, stats.lost_unarmed,
+			stats.armed_ms);
+	printf("test_startup: OK (no byte lost after arming)\n");
+	return 0;
+}
@@ -0,0 +1,295 @@
+/*
+ * test_timebase.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "main.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "events.h"
+
+/*
+ * Tickless time base against a simulated TIM4 ... counter, update flag on wrap, CC1 flag on compare match or
+ * CC1G, flags rc_w0 (sim_tim_clear_flag()), interrupt whenever an enabled flag is set and interrupts are unmasked,
+ * taken again if a flag was raised while the handler ran. The counter may also step on at any unmask or flag clear,
+ * so flags come up in the middle of the handler as they do on the target.
+ * Main loop as main.c: dispatch, request the next deadline, events_wait() (WFI runs the counter to the next flag).
+ * Periodic tasks and one-shot timers restarted at random (0 .. 70 s, past the 16-bit compare range), ms crossing
+ * 2^32. Checks: every run within MAX_LATE_MS of its deadline (a lost compare flag waits for the compare to come
+ * round again, 32.768 s), no deadline passes without its run, timebase_get_ms() equals the count at every read ...
+ * main loop, any unmask in the handler, and after WFI with the update interrupt not serviced yet.
+ * Then a main loop that is never idle (sustained MIDI ... no sleep, so no wake-up requests before events_wait())
+ * with one-shots of 0 .. BUSY_MAX_DELAY_MS started on the way, as the scroll fill step and splash timer are: only
+ * the compare interrupt releases deadlines, so every timer must still run within MAX_LATE_MS.
+ * Then the same with HAL_TIM_IRQHandler()'s second pass over the flags after timebase_irq_handler() (what
+ * TIM4_IRQHandler() used to do) ... it must lose wake-ups, to show the run above would see it.
+ */
+
+#define TICKS_PER_MS		(TIMEBASE_TICKS_PER_MS)
+#define START_MS			(0xFFFFFFFFu - 100000u)	/* ms crosses 2^32 100 s in */
+#define TEST_MS				(400000u)
+#define TASKS				(3u)
+#define TIMERS				(8u)
+#define MAX_DELAY_MS		(70000u)
+#define BUSY_MAX_DELAY_MS	(3u)		/* one-shots in the busy loop ... scroll fill steps are 1 ms */
+#define MAX_LATE_MS			(5u)
+#define RACE_ONE_IN			(16u)		/* unmasks and flag clears with a counter step */
+
+static const uint32_t intervals[TASKS] = {7, 100, 1000};
+
+static uint64_t ticks;					/* counts since timebase_init() */
+static uint32_t start_ms;
+static bool is_in_handler, has_hal_pass;
+static bool is_counter_held;			/* no counter steps at unmasks ... test's own reads, timer starts */
+static char names[TASKS + TIMERS];		/* task name = &names[n], tells the shared callback which ran */
+static TaskId ids[TASKS + TIMERS];
+static bool is_armed[TASKS + TIMERS];
+static uint32_t deadlines[TASKS + TIMERS];
+
+typedef struct {
+	uint32_t runs;
+	uint32_t late_runs;			/* more than MAX_LATE_MS after the deadline */
+	uint32_t max_late_ms;
+	uint32_t bad_reads;			/* timebase_get_ms() off the count */
+	uint32_t reads;
+	uint32_t pending_reads;		/* with the update interrupt not serviced yet */
+	uint32_t interrupts;
+	uint32_t mid_handler_steps;	/* counter steps while the handler ran */
+} Stats;
+
+static Stats stats;
+
+static void counter_step(void)
+{
+	TIM_TypeDef *tim = TIM4;
+
+	if(0 == (tim->CR1 & TIM_CR1_CEN))
+		return;
+	ticks++;
+	tim->CNT = (uint16_t)ticks;
+	if(0 == tim->CNT)
+		tim->SR |= TIM_SR_UIF;
+	if(tim->CNT == tim->CCR1)
+		tim->SR |= TIM_SR_CC1IF;
+	if(is_in_handler)
+		stats.mid_handler_steps++;
+}
+
+/* software events take effect at once on the target ... picked up here before the next look at the flags */
+static void counter_sync(void)
+{
+	TIM_TypeDef *tim = TIM4;
+
+	if(tim->EGR & TIM_EGR_CC1G)
+		tim->SR |= TIM_SR_CC1IF;
+	tim->EGR = 0;
+	if(!is_counter_held && 0 == test_random() % RACE_ONE_IN)
+		counter_step();
+}
+
+static bool is_irq_pending(void)
+{
+	return 0 != (TIM4->SR & TIM4->DIER & (TIM_SR_UIF | TIM_SR_CC1IF));
+}
+
+static void read_check(void)
+{
+	uint32_t expected = start_ms + (uint32_t)(ticks / TICKS_PER_MS);
+	uint32_t ms;
+
+	if(is_counter_held) /* the read unmasks too */
+		return;
+	is_counter_held = true;
+	ms = timebase_get_ms();
+	is_counter_held = false;
+	stats.reads++;
+	if(ms != expected)
+	{
+		if(0 == stats.bad_reads)
+			printf("  timebase_get_ms() %u, count says %u\n", ms, expected);
+		stats.bad_reads++;
+	}
+}
+
+/* TIM4_IRQHandler() ... and the HAL handler's pass over the same flags, as it was */
+static void tim4_irq(void)
+{
+	TIM_TypeDef *tim = TIM4;
+
+	stats.interrupts++;
+	timebase_irq_handler();
+	if(has_hal_pass)
+	{
+		if((tim->SR & TIM_SR_CC1IF) && (tim->DIER & TIM_DIER_CC1IE))
+			tim->SR &= ~TIM_SR_CC1IF;
+		if((tim->SR & TIM_SR_UIF) && (tim->DIER & TIM_DIER_UIE))
+			tim->SR &= ~TIM_SR_UIF;
+	}
+}
+
+static void deliver(void)
+{
+	if(is_in_handler || 0 != sim_primask)
+		return;
+	while(is_irq_pending())
+	{
+		is_in_handler = true;
+		tim4_irq();
+		is_in_handler = false;
+	}
+}
+
+void sim_irq_unmasked(void)
+{
+	counter_sync();
+	if(is_in_handler)
+		read_check(); /* handler between its masked steps ... a higher priority reader may run here */
+	deliver();
+}
+
+void sim_tim_clear_flag(TIM_TypeDef *tim, uint32_t flag)
+{
+	counter_sync();
+	tim->SR &= ~flag;
+}
+
+/* WFI, interrupts masked ... counter runs to the next enabled flag, handler runs after unmasking */
+void sim_wfi(void)
+{
+	counter_sync();
+	for(uint32_t n = 0; !is_irq_pending(); n++)
+	{
+		if(n > 0x20000u) /* nothing can wake the core */
+		{
+			printf("FAIL %s: WFI at %u ms with no wake-up\n", __FILE__, start_ms + (uint32_t)(ticks / TICKS_PER_MS));
+			exit(1);
+		}
+		counter_step();
+	}
+	if(TIM4->SR & TIM_SR_UIF)
+		stats.pending_reads++;
+	read_check(); /* a higher priority reader (USART1 timestamp) before the TIM4 handler */
+}
+
+static void timer_run(void)
+{
+	uint32_t n = scheduler_get_last_task_name() - names;
+	uint32_t late = timebase_get_ms() - deadlines[n];
+
+	stats.runs++;
+	if(!is_armed[n] || late > MAX_LATE_MS)
+	{
+		if(0 == stats.late_runs && !has_hal_pass)
+			printf("  %s %u ran %u ms after its deadline\n", (n < TASKS) ? "task" : "timer", n, late);
+		stats.late_runs++;
+	}
+	else if(late > stats.max_late_ms)
+	{
+		stats.max_late_ms = late;
+	}
+	if(n < TASKS)
+		deadlines[n] += intervals[n];
+	else
+		is_armed[n] = false;
+}
+
+static void dispatch_all(void)
+{
+	while(scheduler_dispatch(TASK_PRIORITY_LOW))
+		;
+}
+
+/* main loop for TEST_MS ... dispatch, timer churn, a little work sometimes, sleep (never when busy) */
+static void run(bool hal_pass, bool is_busy)
+{
+	uint32_t end, wakeup;
+
+	memset(&stats, 0, sizeof(stats));
+	memset(&sim_tim4, 0, sizeof(sim_tim4));
+	has_hal_pass = hal_pass;
+	ticks = 0;
+	uwTick = START_MS;
+	events_init();
+	timebase_init(); /* before scheduler_init() as in main.c ... wheel_time is read from it */
+	scheduler_init();
+	start_ms = timebase_get_ms();
+	for(uint32_t n = 0; n < TASKS + TIMERS; n++)
+	{
+		if(n < TASKS)
+			ids[n] = scheduler_add_task(&names[n], timer_run, intervals[n], TASK_PRIORITY_NORMAL, 0);
+		else
+			ids[n] = scheduler_add_timer(&names[n], timer_run, TASK_PRIORITY_NORMAL, 0);
+		is_armed[n] = (n < TASKS);
+		deadlines[n] = start_ms + intervals[n % TASKS];
+	}
+
+	end = start_ms + TEST_MS;
+	while((int32_t)(timebase_get_ms() - end) < 0)
+	{
+		dispatch_all();
+		read_check();
+		if(0 == test_random() % 16)
+		{
+			uint32_t n = TASKS + test_random() % TIMERS;
+			uint32_t delay = test_random() % ((is_busy ? BUSY_MAX_DELAY_MS : MAX_DELAY_MS) + 1);
+
+			is_counter_held = true;
+			scheduler_start_timer(ids[n], delay);
+			is_armed[n] = true;
+			deadlines[n] = timebase_get_ms() + (0 != delay ? delay : 1);
+			is_counter_held = false;
+		}
+		if(is_busy || 0 == test_random() % 4) /* work ... counter runs, interrupts come as they are raised */
+		{
+			for(uint32_t n = test_random() % (2 * TICKS_PER_MS); n != 0; n--)
+			{
+				counter_step();
+				deliver();
+			}
+			continue;
+		}
+		if(scheduler_get_next_deadline(&wakeup))
+			timebase_request_wakeup(wakeup);
+		events_wait();
+	}
+	dispatch_all();
+	for(uint32_t n = 0; n < TASKS + TIMERS; n++)
+	{
+		if(is_armed[n] && (int32_t)(timebase_get_ms() - deadlines[n]) > (int32_t)MAX_LATE_MS)
+			stats.late_runs++; /* deadline passed, never ran */
+	}
+}
+
+int main(void)
+{
+	Stats fixed, busy;
+
+	run(false, true);
+	busy = stats;
+	CHECK(0 == busy.late_runs, "busy loop: %u runs late or lost", busy.late_runs);
+	CHECK(0 == busy.bad_reads, "busy loop: %u of %u reads off the count", busy.bad_reads, busy.reads);
+
+	run(false, false);
+	fixed = stats;
+	CHECK(0 == fixed.late_runs, "%u runs late or lost", fixed.late_runs);
+	CHECK(0 == fixed.bad_reads, "%u of %u reads off the count", fixed.bad_reads, fixed.reads);
+	CHECK(fixed.pending_reads > 0 && fixed.mid_handler_steps > 0, "%u reads with the update pending, %u counter steps in the handler",
+			fixed.pending_reads, fixed.mid_handler_steps);
+
+	run(true, false);
+	CHECK(stats.late_runs > 0 || stats.bad_reads > 0, "HAL handler pass lost nothing, the test doesn't see lost flags");
+
+	printf("  %u ms from 2^32 - 100 s: %u runs, latest %u ms after its deadline, %u interrupts, %u counter steps in the handler\n",
+			TEST_MS, fixed.runs, fixed.max_late_ms, fixed.interrupts, fixed.mid_handler_steps);
+	printf("  %u time reads all on the count (%u with the overflow not serviced yet)\n", fixed.reads, fixed.pending_reads);
+	printf("  busy loop, never asleep: %u runs with one-shots of 0 .. %u ms, latest %u ms after its deadline\n", busy.runs,
+			BUSY_MAX_DELAY_MS, busy.max_late_ms);
+	printf("  with HAL_TIM_IRQHandler() after it: %u runs late or lost, %u reads off the count\n", stats.late_runs, stats.bad_reads);
+	printf("test_timebase: OK (no wake-up or overflow lost)\n");
+	return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * test_trigger.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: dwask
+ */
+
+#include "test.h"
+#include "ui.h"
+#include "display.h"
+#include "history.h"
+#include "scheduler.h"
+#include "trigger.h"
+#include "midi_stream.h"
+
+/*
+ * Trigger capture through ui_post_packet_to_history() ... long synthetic streams (which never contain the trigger
+ * messages) with rare injected trigger messages or sequences, and partial sequences that must not fire. Every
+ * freeze must hold exactly pre_count records before the match and post_count after it (fewer before when the
+ * match comes early in the session), hold still while frozen, and a new session must start armed again. Both
+ * backends.
+ * Before that, sequences whose partial matches overlap themselves (A,A,B on A,A,A,B) straight through
+ * trigger_process(): random sequences of 1..TRIGGER_MAX_STEPS over three messages against random streams of them,
+ * firing exactly where the last messages since arming spell the sequence.
+ */
+
+#define TEST_PACKETS		(2000000u)	/* per scenario */
+#define TEST_INJECT_ODDS	(50000u)	/* one injection in TEST_INJECT_ODDS packets */
+#define TEST_FROZEN_PACKETS	(3000u)		/* packets posted while frozen before the session is restarted */
+#define OVERLAP_SEQUENCES	(20000u)
+#define OVERLAP_MESSAGES	(200u)		/* stream per sequence */
+#define OVERLAP_KEYS		(3u)		/* note on, channel 1, keys 60.. */
+
+typedef struct {
+	const char *name;
+	TriggerCondition steps[2];
+	uint8_t number_steps;
+	uint32_t pre_count, post_count;
+	stc_midi match[2];				/* messages injected to fire the trigger */
+	uint32_t first_injection;		/* packets into the session of the first injection (0 = random) */
+} Scenario;
+
+static const Scenario scenarios[] = {
+	{"all notes off", {{0xF0, 0xB0, 0, 123, 123, 0, 127}}, 1, TRIGGER_DEFAULT_PRE_COUNT, TRIGGER_DEFAULT_POST_COUNT,
+			{{0xB5, {123, 0}, 0, 6}}, 0},
+	{"sequence", {{0xF0, 0x90, 3, 60, 60, 1, 127}, {0xF0, 0xB0, 3, 64, 64, 0, 63}}, 2, 200, 100,
+			{{0x92, {60, 100}, 0, 3}, {0xB2, {64, 0}, 0, 3}}, 0},
+	{"early match", {{0xF0, 0xB0, 0, 123, 123, 0, 127}}, 1, TRIGGER_DEFAULT_PRE_COUNT, TRIGGER_DEFAULT_POST_COUNT,
+			{{0xB0, {123, 0}, 0, 1}}, 10},
+	{"no post window", {{0xF0, 0xB0, 0, 120, 120, 0, 127}}, 1, 300, 0,
+			{{0xB9, {120, 0}, 0, 10}}, 0}
+};
+
+/* sequence keys[] (note numbers 60..) against stream keys ... fires exactly where a brute-force suffix compare says */
+static int overlap_run(const uint8_t *keys, uint8_t number_steps, const uint8_t *stream, uint32_t length, uint32_t *fires)
+{
+	TriggerCondition steps[TRIGGER_MAX_STEPS];
+	uint32_t since_arm = 0;
+
+	for(uint8_t i = 0; i < number_steps; i++)
+		steps[i] = (TriggerCondition){0xF0, 0x90, 1, 60 + keys[i], 60 + keys[i], 0, 127};
+	trigger_configure(steps, number_steps, 0, 0);
+	trigger_arm();
+	for(uint32_t n = 0; n < length; n++)
+	{
+		stc_midi packet = {0x90, {60 + stream[n], 100}, 0, 1};
+		bool is_expected = ++since_arm >= number_steps;
+
+		for(uint8_t i = 0; i < number_steps && is_expected; i++)
+			is_expected = (stream[n + 1 - number_steps + i] == keys[i]);
+		CHECK((TRIGGER_EVENT_FROZEN == trigger_process(&packet, n)) == is_expected, "sequence of %u steps %s at message %u",
+				number_steps, is_expected ? "missed" : "fired", n);
+		if(is_expected)
+		{
+			(*fires)++;
+			trigger_arm();
+			since_arm = 0;
+		}
+	}
+	return 0;
+}
+
+static int test_overlap(void)
+{
+	static const uint8_t aab[] = {0, 0, 1}, aaab[] = {0, 0, 0, 1};
+	uint8_t keys[TRIGGER_MAX_STEPS], stream[OVERLAP_MESSAGES];
+	uint32_t fires = 0;
+
+	if(overlap_run(aab, sizeof(aab), aaab, sizeof(aaab), &fires) != 0)
+		return 1;
+	CHECK(1 == fires, "A,A,B fired %u times on A,A,A,B", fires);
+	for(uint32_t n = 0; n < OVERLAP_SEQUENCES; n++)
+	{
+		uint8_t number_steps = 1 + test_random() % TRIGGER_MAX_STEPS;
+		uint8_t symbols = 2 + test_random() % (OVERLAP_KEYS - 1);	/* two keys make the most self-overlap */
+
+		for(uint8_t i = 0; i < number_steps; i++)
+			keys[i] = test_random() % symbols;
+		for(uint32_t i = 0; i < OVERLAP_MESSAGES; i++)
+			stream[i] = test_random() % symbols;
+		if(overlap_run(keys, number_steps, stream, OVERLAP_MESSAGES, &fires) != 0)
+			return 1;
+	}
+	printf("  %u sequences of 1..%u steps over %u messages: %u matches, none missed, none extra\n", OVERLAP_SEQUENCES,
+			TRIGGER_MAX_STEPS, OVERLAP_KEYS, fires);
+	return 0;
+}
+
+static void post(stc_midi *packet, uint32_t time_stamp)
+{
+	packet->time_stamp = time_stamp;
+	ui_post_packet_to_history(packet);
+}
+
+static int run(const HistoryBackend *backend, const Scenario *scenario)
+{
+	stc_midi packet, match;
+	stc_midi_history record;
+	uint32_t session_packets = 0, freezes = 0, partials = 0;
+
+	ui_initialize_ui();
+	trigger_configure(scenario->steps, scenario->number_steps, scenario->pre_count, scenario->post_count);
+	trigger_arm();
+	stream_init(STREAM_MIXED, 0);
+
+	for(uint32_t n = 0; n < TEST_PACKETS; n++)
+	{
+		bool is_due = (0 == scenario->first_injection) ? (0 == test_random() % TEST_INJECT_ODDS) : (session_packets == scenario->first_injection);
+
+		stream_next(&packet);
+		if(TRIGGER_ARMED == trigger_get_state() && 2 == scenario->number_steps && 0 == test_random() % TEST_INJECT_ODDS)
+		{
+			match = scenario->match[0]; /* first step only, broken by the next stream message */
+			post(&match, packet.time_stamp);
+			session_packets++;
+			partials++;
+		}
+		if(TRIGGER_ARMED == trigger_get_state() && is_due)
+		{
+			uint32_t oldest_before = history_oldest();
+			uint32_t matched, first;
+
+			for(uint8_t i = 0; i < scenario->number_steps; i++)
+			{
+				match = scenario->match[i];
+				post(&match, packet.time_stamp);
+				session_packets++;
+			}
+			matched = history_newest();
+			CHECK(trigger_get_state() == (0 == scenario->post_count ? TRIGGER_FROZEN : TRIGGER_POST), "%s: trigger did not fire", scenario->name);
+			CHECK(trigger_get_sequence() == matched, "%s: match at %u, expected %u", scenario->name, trigger_get_sequence(), matched);
+
+			for(uint32_t i = 0; i < scenario->post_count; i++)
+			{
+				stream_next(&packet);
+				post(&packet, packet.time_stamp);
+				session_packets++;
+			}
+			CHECK(trigger_is_frozen(), "%s: not frozen after %u post-trigger records", scenario->name, scenario->post_count);
+
+			first = (matched - oldest_before >= scenario->pre_count) ? matched - scenario->pre_count : oldest_before;
+			CHECK(history_oldest() == first, "%s: window starts at %u, expected %u (match %u)", scenario->name, history_oldest(), first, matched);
+			CHECK(history_newest() == matched + scenario->post_count, "%s: window ends at %u, expected %u", scenario->name, history_newest(), matched + scenario->post_count);
+			CHECK(history_read(matched, &record) && record.running_status == match.running_status && record.data[0] == match.data[0],
+					"%s: record %u is not the matching message", scenario->name, matched);
+
+			for(uint32_t i = 0; i < TEST_FROZEN_PACKETS; i++) /* frozen ... LIVE still shows packets, history holds still */
+			{
+				stream_next(&packet);
+				post(&packet, packet.time_stamp);
+			}
+			CHECK(history_oldest() == first && history_newest() == matched + scenario->post_count, "%s: frozen window moved", scenario->name);
+			n += TEST_FROZEN_PACKETS;
+			freezes++;
+
+			ui_initialize_ui(); /* new session */
+			CHECK(TRIGGER_ARMED == trigger_get_state() && 0 == history_count(), "%s: new session not armed and empty", scenario->name);
+			session_packets = 0;
+			continue;
+		}
+		post(&packet, packet.time_stamp);
+		session_packets++;
+		CHECK(TRIGGER_ARMED == trigger_get_state(), "%s: fired on stream message %02X %u %u at record %u", scenario->name,
+				packet.running_status, packet.data[0], packet.data[1], history_newest());
+	}
+	CHECK(freezes > 0, "%s: no trigger injected", scenario->name);
+
+	printf("  %-10s %-16s %u packets, %u freezes, %u partial sequences ignored\n", backend->name, scenario->name,
+			TEST_PACKETS, freezes, partials);
+	return 0;
+}
+
+int main(void)
+{
+	scheduler_init();
+	ui_init_tasks();
+	display_init();
+	trigger_init();
+	if(test_overlap() != 0)
+		return 1;
+	for(uint8_t b = 0; b < 2; b++)
+	{
+		const HistoryBackend *backend = (0 == b) ? &history_sram_backend : &history_compressed_backend;
+
+		history_init(backend); /* kept by ui_initialize_ui() */
+		for(uint8_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++)
+		{
+			if(run(backend, &scenarios[s]) != 0)
+				return 1;
+		}
+	}
+	printf("test_trigger: OK\n");
+	return 0;
+}
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""
+ram_report.py
+
+ Created on: Oct 19, 2026
+     Author: dwask
+
+Static RAM per module from the GNU ld map file, checked against the SRAM budget in Core/Inc/ram_budget.h.
+Runs on the host, as post-build step of every configuration (from the Debug/ or Release/ folder):
+
+    if command -v python3 >/dev/null; then python3 ../tools/ram_report.py ${ProjName}.map; else python ../tools/ram_report.py ${ProjName}.map; fi
+
+(python only where there is no python3 ... a --strict failure is not run a second time)
+
+    --check         compile ram_budget.h on its own first (its _Static_asserts), e.g. after changing
+                    UART_FIFO_SIZE or NUMBER_PAGES, without a full build. Map file is optional with --check
+    --cc CC         compiler for --check (default arm-none-eabi-gcc, host gcc works too)
+    --strict        exit code 1 when the map shows RAM over the budget (or the budget header fails to compile)
+
+Without --strict a budget miss is a warning (exit code 0) ... the linker still fails a build that overflows RAM.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+BUDGET_HEADER = os.path.join(ROOT, "Core", "Inc", "ram_budget.h")
+INCLUDES = ["Core/Inc", "Drivers/STM32F1xx_HAL_Driver/Inc", "Drivers/STM32F1xx_HAL_Driver/Inc/Legacy",
+            "Drivers/CMSIS/Device/ST/STM32F1xx/Include", "Drivers/CMSIS/Include"]
+DEFINES = ["USE_HAL_DRIVER", "STM32F103xB"]
+
+# input sections of the buffers sized in ram_budget.h (needs -fdata-sections, CubeIDE default)
+BUDGET_BUFFERS = {"rxFIFO": "rxFIFO", "midi_history": "history", "history_bytes": "history"}
+
+RAM_SECTIONS = (".data", ".bss")
+
+
+def budget_defines():
+    """RAM_BUDGET_* values from ram_budget.h (simple (a), (a * b) and hex forms)"""
+    values = {}
+    with open(BUDGET_HEADER) as header:
+        for line in header:
+            match = re.match(r"#define\s+(RAM_BUDGET_(?:TOTAL|STACK|HEAP|OTHER))\s+\((.*?)\)", line)
+            if match:
+                expression = re.sub(r"(0x[0-9a-fA-F]+|\d+)u", r"\1", match.group(2))
+                values[match.group(1)] = int(eval(expression, {"__builtins__": {}}))
+    return values
+
+
+def check_header(cc):
+    """compile the budget header alone ... its _Static_asserts are the budget check"""
+    command = [cc, "-std=gnu11", "-fsyntax-only", "-w", "-x", "c", BUDGET_HEADER]
+    command += ["-I" + os.path.join(ROOT, path) for path in INCLUDES] + ["-D" + define for define in DEFINES]
+    try:
+        result = subprocess.run(command, capture_output=True, text=True)
+    except OSError as error:
+        print("ram_report: cannot run %s (%s), use --cc" % (cc, error))
+        return False
+    sys.stdout.write(result.stdout + result.stderr)
+    print("ram_budget.h: %s" % ("OK" if 0 == result.returncode else "FAILED"))
+    return 0 == result.returncode
+
+
+def module_name(path):
+    """./Core/Src/main.o -> main.o, .../libc_nano.a(lib_a-impure.o) -> libc_nano.a"""
+    path = path.strip()
+    if "(" in path:
+        path = path[:path.index("(")]
+    return os.path.basename(path)
+
+
+def parse_map(map_path):
+    """per-module .data/.bss bytes, budget buffer bytes, RAM length and heap/stack reserves"""
+    modules = {}
+    buffers = {}
+    info = {"ram": None, "heap": None, "stack": None}
+    output_section = None
+    pending = None      # input section name on a line of its own, address/size/object on the next
+
+    with open(map_path) as map_file:
+        in_map = False
+        for line in map_file:
+            line = line.rstrip("\n")
+            match = re.match(r"RAM\s+0x[0-9a-fA-F]+\s+(0x[0-9a-fA-F]+)", line)
+            if match and info["ram"] is None:
+                info["ram"] = int(match.group(1), 16)
+            match = re.match(r"\s+0x[0-9a-fA-F]+\s+_Min_(Heap|Stack)_Size = (0x[0-9a-fA-F]+)", line)
+            if match:
+                info[match.group(1).lower()] = int(match.group(2), 16)
+            if line.startswith("Linker script and memory map"):
+                in_map = True
+                continue
+            if not in_map:
+                continue
+
+            if re.match(r"^\S", line):      # output section (column 0)
+                output_section = line.split()[0]
+                pending = None
+                continue
+            if output_section not in RAM_SECTIONS:
+                continue
+
+            match = re.match(r"^ (\.\S+|COMMON)\s*$", line)
+            if match:
+                pending = match.group(1)
+                continue
+            match = re.match(r"^ (\.\S+|COMMON)?\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S.*)$", line)
+            if match is None:
+                continue
+            section = match.group(1) or pending
+            pending = None
+            if section is None:
+                continue
+            size = int(match.group(3), 16)
+            if 0 == size:
+                continue
+            module = modules.setdefault(module_name(match.group(4)), {".data": 0, ".bss": 0})
+            module[output_section] += size
+            symbol = section.split(".")[-1]
+            if symbol in BUDGET_BUFFERS:
+                buffers[BUDGET_BUFFERS[symbol]] = buffers.get(BUDGET_BUFFERS[symbol], 0) + size
+    return modules, buffers, info
+
+
+def report(map_path):
+    modules, buffers, info = parse_map(map_path)
+    budget = budget_defines()
+    ok = True
+
+    print("Static RAM by module (%s)" % os.path.basename(map_path))
+    print("  bytes   .data    .bss  module")
+    total = 0
+    for name, sizes in sorted(modules.items(), key=lambda item: -(item[1][".data"] + item[1][".bss"])):
+        size = sizes[".data"] + sizes[".bss"]
+        total += size
+        print("%7d %7d %7d  %s" % (size, sizes[".data"], sizes[".bss"], name))
+
+    ram = info["ram"] or budget["RAM_BUDGET_TOTAL"]
+    heap = info["heap"] or 0
+    stack = info["stack"] or 0
+    other = total - sum(buffers.values())
+    free = ram - total - heap - stack
+    print("  -----")
+    print("%7d static (rxFIFO %d, history %d, other %d)" % (total, buffers.get("rxFIFO", 0), buffers.get("history", 0), other))
+    print("%7d heap reserve, %d stack reserve, %d free of %d" % (heap, stack, free, ram))
+
+    # map against ram_budget.h ... the _Static_asserts only see what the header assumes
+    checks = [
+        ("other static RAM", other, budget["RAM_BUDGET_OTHER"]),
+        ("RAM length", ram, budget["RAM_BUDGET_TOTAL"]),
+        ("_Min_Heap_Size", heap, budget["RAM_BUDGET_HEAP"]),
+        ("_Min_Stack_Size", stack, budget["RAM_BUDGET_STACK"]),
+    ]
+    for name, actual, expected in checks:
+        if "other static RAM" == name:
+            good = actual <= expected
+            print("Budget %-17s %6d of %6d %s" % (name, actual, expected, "OK" if good else "OVER ... raise RAM_BUDGET_OTHER or shrink buffers"))
+        else:
+            good = actual == expected
+            if not good:
+                print("Budget %-17s %6d, ram_budget.h says %d ... keep them in step" % (name, actual, expected))
+        ok = ok and good
+    if free < 0:
+        print("RAM overflow by %d bytes" % -free)
+        ok = False
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Static RAM per module from the map file, against ram_budget.h")
+    parser.add_argument("map", nargs="?", help="GNU ld map file (${ProjName}.map in the build folder)")
+    parser.add_argument("--check", action="store_true", help="compile ram_budget.h on its own first")
+    parser.add_argument("--cc", default="arm-none-eabi-gcc", help="compiler for --check")
+    parser.add_argument("--strict", action="store_true", help="exit code 1 on a budget miss instead of a warning")
+    args = parser.parse_args()
+
+    ok = True
+    if args.check:
+        ok = check_header(args.cc)
+    if args.map:
+        ok = report(args.map) and ok
+    elif not args.check:
+        parser.error("map file or --check needed")
+    if not ok and not args.strict:
+        print("ram_report: WARNING ... SRAM budget missed (ram_budget.h), --strict fails the build")
+    return 0 if ok or not args.strict else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())